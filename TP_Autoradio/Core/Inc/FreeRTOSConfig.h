@@ -59,13 +59,15 @@
 #define configSUPPORT_STATIC_ALLOCATION          1
 #define configSUPPORT_DYNAMIC_ALLOCATION         1
 #define configUSE_IDLE_HOOK                      0
-#define configUSE_TICK_HOOK                      0
+#define configUSE_TICK_HOOK                      1
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 7 )
 #define configMINIMAL_STACK_SIZE                 ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE                    ((size_t)20000)
+#define configTOTAL_HEAP_SIZE                    ((size_t)2048)
 #define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configGENERATE_RUN_TIME_STATS            1
+#define configUSE_TRACE_FACILITY                 1
 #define configUSE_16_BIT_TICKS                   0
 #define configUSE_MUTEXES                        1
 #define configQUEUE_REGISTRY_SIZE                8
@@ -80,6 +82,12 @@
 #define configUSE_CO_ROUTINES                    0
 #define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
 
+/* Software timer definitions. */
+#define configUSE_TIMERS                         1
+#define configTIMER_TASK_PRIORITY                ( 2 )
+#define configTIMER_QUEUE_LENGTH                 10
+#define configTIMER_TASK_STACK_DEPTH             256
+
 /* The following flag must be enabled only when using newlib */
 #define configUSE_NEWLIB_REENTRANT          1
 
@@ -90,7 +98,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelete                  1
 #define INCLUDE_vTaskCleanUpResources        0
 #define INCLUDE_vTaskSuspend                 1
-#define INCLUDE_vTaskDelayUntil              0
+#define INCLUDE_vTaskDelayUntil              1
 #define INCLUDE_vTaskDelay                   1
 #define INCLUDE_xTaskGetSchedulerState       1
 
@@ -137,6 +145,28 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+
+/* Tickless idle: the idle task sleeps until the next task wake up, the HAL
+ * tick (TIM6) is suspended meanwhile, see power.c */
+#define configUSE_TICKLESS_IDLE 1
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+void power_pre_sleep(uint32_t * ticks);
+void power_post_sleep(uint32_t * ticks);
+#endif
+#define configPRE_SLEEP_PROCESSING(x) power_pre_sleep(&(x))
+#define configPOST_SLEEP_PROCESSING(x) power_post_sleep(&(x))
+
+/* Context switches counted per task and run time stats on the DWT cycle
+ * counter, see sched.c */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+void sched_switched_in(uint32_t number);
+void sched_runtime_init(void);
+uint32_t sched_runtime_counter(void);
+#endif
+#define traceTASK_SWITCHED_IN() sched_switched_in(pxCurrentTCB->uxTCBNumber)
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() sched_runtime_init()
+#define portGET_RUN_TIME_COUNTER_VALUE() sched_runtime_counter()
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
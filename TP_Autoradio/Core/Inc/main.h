@@ -53,6 +53,8 @@ extern "C" {
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+void app_tasks_create(void);
+void app_tasks_report(void);
 
 /* USER CODE END EFP */
 
@@ -38,10 +38,30 @@
 #include "../shell/shell.h"
 #include "../shell/functions.h"
 
+#include "../audio/audio.h"
+
+#include "../utils/log.h"
+#include "../utils/power.h"
+#include "../utils/sched.h"
+#include "../utils/profiling.h"
+#include "../utils/sections.h"
+#include "../utils/watchdog.h"
+
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
+typedef struct {
+	const char * name;
+	TaskFunction_t entry;
+	void * param;
+	uint32_t stack_depth;	// In words
+	UBaseType_t priority;
+	StackType_t * stack;
+	StaticTask_t * tcb;
+	TaskHandle_t * handle;
+	const char * mem;
+} app_task_t;
 
 /* USER CODE END PTD */
 
@@ -50,11 +70,28 @@
 #define LOGS 0
 
 #define STACK_DEPTH 256
+#define TASK_AUDIO_PRIORITY 5
+#define TASK_POWER_PRIORITY 4
 #define TASK_SHELL_PRIORITY 3
 #define TASK_MCP23S17_PRIORITY 2
-#define DELAY_LED_TOGGLE 200
+#define TASK_LOG_PRIORITY 1
+#define TASK_LOUDNESS_PRIORITY 1
+#define VU_RANGE_DB 48		// Span of the 8 LEDs, 6 dB each
+#define VU_STEP_MS 4		// The bars move by 1% per step
+#define VU_BARS(level) (8 * (level) / 100)	// LEDs lit, as MCP23S17_level_L()
 
-#define SAI_BUFFER_LENGTH (512)
+/**
+ * Declarative task table, every task is statically allocated.
+ * X(id, name, entry, parameter, stack depth in words, priority, RAM | RAM2)
+ * The handle of each task is h_task_<id>.
+ */
+#define APP_TASKS(X) \
+	X(audio,		"Audio",			task_audio,			NULL,						2*STACK_DEPTH,	TASK_AUDIO_PRIORITY,	RAM2) \
+	X(GPIOExpander,	"GPIO_expander",	task_GPIO_expander,	NULL,						STACK_DEPTH,	TASK_MCP23S17_PRIORITY,	RAM2) \
+	X(power,		"Power",			task_power,			NULL,						STACK_DEPTH,	TASK_POWER_PRIORITY,	RAM2) \
+	X(shell,		"Shell",			task_shell,			NULL,						STACK_DEPTH,	TASK_SHELL_PRIORITY,	RAM2) \
+	X(log,			"Log",				task_log,			NULL,						STACK_DEPTH,	TASK_LOG_PRIORITY,		RAM2) \
+	X(loudness,		"Loudness",			task_loudness,		NULL,						STACK_DEPTH,	TASK_LOUDNESS_PRIORITY,	RAM2)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -65,14 +102,13 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-TaskHandle_t h_task_LED = NULL;
-TaskHandle_t h_task_shell = NULL;
-TaskHandle_t h_task_GPIOExpander = NULL;
-
-uint8_t rxSAI[SAI_BUFFER_LENGTH];
-uint8_t txSAI[SAI_BUFFER_LENGTH];
-float txSAI_volume;
-int VU_level;
+#define APP_TASK_BUFFERS(id, name, entry, param, depth, prio, mem) \
+	TaskHandle_t h_task_##id = NULL; \
+	static StackType_t stack_##id[depth] MEM_PLACE(mem); \
+	static StaticTask_t tcb_##id;
+APP_TASKS(APP_TASK_BUFFERS)
+
+int VU_level[2];
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -80,11 +116,20 @@ void SystemClock_Config(void);
 void PeriphCommonClock_Config(void);
 void MX_FREERTOS_Init(void);
 /* USER CODE BEGIN PFP */
+void task_shell(void * unused);
+void task_GPIO_expander(void * unused);
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+#define APP_TASK_ENTRY(id, name, entry, param, depth, prio, mem) \
+	{ name, entry, param, depth, prio, stack_##id, &tcb_##id, &h_task_##id, #mem },
+static const app_task_t app_tasks[] = {
+		APP_TASKS(APP_TASK_ENTRY)
+};
+#define APP_TASK_COUNT (sizeof(app_tasks) / sizeof(app_tasks[0]))
+
 /**
  * @brief Transmit a character over UART.
  * @param ch: Character to transmit.
@@ -98,32 +143,52 @@ int __io_putchar(int ch)
 }
 
 /**
- * @brief  Gestion d'erreurs de création de tâche.
- * @param	BaseType_t	Retour de xTaskCreate.
+ * @brief  Création statique de toutes les tâches de APP_TASKS.
  */
-void Error_Handler_xTaskCreate(BaseType_t r)
+void app_tasks_create(void)
 {
-	/* Vérification si la tâche a été créée avec succès */
-	if (pdPASS == r) {
-		/* Si la tâche est créée avec succès, démarrer le scheduler */
+	for (int i = 0; i < APP_TASK_COUNT; i++)
+	{
+		const app_task_t * t = &app_tasks[i];
+
+		*t->handle = xTaskCreateStatic(t->entry, t->name, t->stack_depth,
+				t->param, t->priority, t->stack, t->tcb);
+
+		if (*t->handle == NULL) {
+			printf("Erreur: création de la tâche %s\r\n", t->name);
+			Error_Handler();
+		}
 #if (LOGS)
-		printf("Tâche crée avec succès\r\n");
+		printf("Tâche %s crée avec succès\r\n", t->name);
 #endif
-	} else if (errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY == r) {
-		printf("Erreur: Mémoire insuffisante\r\n");
-		Error_Handler();
-	} else {
-		/* Cas improbable : code d'erreur non prévu pour xTaskCreate */
-		printf("Erreur inconnue lors de la création de la tâche\r\n");
-		Error_Handler();  	// Gestion d'erreur générique
-		NVIC_SystemReset(); // Réinitialiser le microcontrôleur
 	}
 }
 
+/**
+ * @brief  Rapport d'utilisation mémoire des tâches et du tas FreeRTOS.
+ */
+void app_tasks_report(void)
+{
+	printf("%-16s %6s %6s %5s %s\r\n", "Tache", "Pile", "Libre", "Prio", "Mem");
+	for (int i = 0; i < APP_TASK_COUNT; i++)
+	{
+		const app_task_t * t = &app_tasks[i];
+
+		printf("%-16s %6lu %6lu %5lu %s\r\n", t->name,
+				t->stack_depth * sizeof(StackType_t),
+				uxTaskGetStackHighWaterMark(*t->handle) * sizeof(StackType_t),
+				t->priority, t->mem);
+	}
+
+	printf("Tas FreeRTOS: %u / %u octets libres (minimum %u)\r\n",
+			xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE, xPortGetMinimumEverFreeHeapSize());
+}
+
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
 	if (huart->Instance == USART2)
 	{
+		power_activity_from_isr();		// Clocks back before the shell runs
 		shell_uart_receive_irq_cb();	// Function giving the semaphore!
 	}
 }
@@ -132,19 +197,6 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 // TASKS
 ////////////////////////////////////////////////////////////////////
 
-void task_LED (void * pvParameters) {
-	int duree = (int) pvParameters;
-
-#if (LOGS)
-	printf("Task %s created\r\n", pcTaskGetName(xTaskGetCurrentTaskHandle()));
-#endif
-	for (;;)
-	{
-		HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
-		vTaskDelay( duree / portTICK_PERIOD_MS );  // Délai de duree en ms
-	}
-}
-
 void task_shell(void * unused)
 {
 #if (LOGS)
@@ -159,6 +211,29 @@ void task_shell(void * unused)
 	shell_add('c', calcul, "Opération entre 2 nombres");
 	shell_add('t', GPIOExpander_toggle_LED, "Change l'état des LED avec les id");
 	shell_add('s', GPIOExpander_set_LED, "Allume une LED avec son id");
+	shell_add('l', Logger_set_level, "Log: l [module|all] [0-4]");
+	shell_add('m', RTOS_memory_report, "Memoire des taches");
+	shell_add('b', Bench_placement, "Bench placement RAM2: b [n]");
+	shell_add('g', Generator_set, "Gene: g [onde|off] [Hz] [%] [bl]");
+	shell_add('q', Equalizer_set, "EQ: q [forme f0 Q dB n|form|bench]");
+	shell_add('F', RC_filter_set, "Filtre RC: F [lp|hp|off] [Hz]");
+	shell_add('e', Echo_set, "Echo: e [ms fb% wet%|off|bench]");
+	shell_add('R', Reverb_set, "Reverb: R [room dmp wet|off|bench]");
+	shell_add('C', Compressor_set, "Comp: C [dB ratio...|limit|off]");
+	shell_add('n', Loudness_set, "Loudness: n [on|off|mic|line|ref]");
+	shell_add('v', Display_set, "Affichage: v [vu|spectre|bench]");
+	shell_add('S', Resampler_set, "SRC: S [on|off|fast..best|drift]");
+	shell_add('x', Mixer_set, "Mixeur: x [src on|off|%|chime]");
+	shell_add('G', Graph_set, "Graph: G [bypass|on|add|del|reset]");
+	shell_add('u', Underrun_set, "Deadlines: u [silence|repeat|...]");
+	shell_add('L', Latency_measure, "Latence: L [impulse|mls] [codec|.]");
+	shell_add('k', Block_set, "Bloc: k [<trames>|sweep]");
+	shell_add('o', Routing_set, "Routage: o [profil|auto]");
+	shell_add('W', Power_set, "Veille: W [mute|on|auto on|off]");
+	shell_add('T', Task_stats, "Taches: T [reset] commutations");
+	shell_add('E', Errors, "Erreurs: E [reset|inject p n]");
+	shell_add('d', Watchdog_report, "Watchdog: d [hang] dernier reset");
+	shell_add('M', Expanders, "Expandeurs SPI: M [scan]");
 
 	shell_run();	// boucle infinie
 }
@@ -169,7 +244,7 @@ void test_chenillard(int delay)
 
 	for (;;)
 	{
-		MCP23S17_Set_LEDs(~(1 << i%8 | ((1 << i%8) << 8)));
+		MCP23S17_Set_LEDs(MCP23S17_VU, ~(1 << i%8 | ((1 << i%8) << 8)));
 		i++;
 		vTaskDelay( delay / portTICK_PERIOD_MS );  // Délai de duree en Dms
 	}
@@ -182,31 +257,108 @@ void task_GPIO_expander (void * unused) {
 #endif
 
 	/* VU-Metre test *
-	MCP23S17_level_L(70);
-	MCP23S17_level_R(50);
+	MCP23S17_level_L(MCP23S17_VU, 70);
+	MCP23S17_level_R(MCP23S17_VU, 50);
 	*/
 
 	// Simple test of the array of leds with an animation
 	//test_chenillard(100);
 
+	const TickType_t step = VU_STEP_MS / portTICK_PERIOD_MS;
+	const TickType_t idle = WATCHDOG_IDLE_MS / portTICK_PERIOD_MS;	// Still checks in with nothing to show
+	int spi_on = 1;
+	int spectrum = 0;
+	int shown[2] = { -1, -1 };		// LEDs lit on each bar, -1 to write them
+	TickType_t frame = 0;			// Spectrum frames
+	TickType_t slew = xTaskGetTickCount() - step;	// Last VU step
+
 	for (;;)
 	{
-		// VU-Metre
-		txSAI_volume = 0;
-		for (int i=0; i<SAI_BUFFER_LENGTH; i++)
+		watchdog_checkin(WATCHDOG_METER);
+
+		// Display blanked and SPI3 gated while the power manager is not ACTIVE
+		if (power_get_state() != POWER_ACTIVE)
+		{
+			if (spi_on)
+			{
+				MCP23S17_Set_LEDs(MCP23S17_VU, 0xFFFF);	// LEDs are active low
+				__HAL_RCC_SPI3_CLK_DISABLE();
+				spi_on = 0;
+			}
+			sched_wait(SCHED_EVT_DISPLAY, idle);
+			spectrum = 0;
+			shown[0] = shown[1] = -1;
+			continue;
+		}
+		if (!spi_on)
+		{
+			__HAL_RCC_SPI3_CLK_ENABLE();
+			spi_on = 1;
+		}
+
+		if (audio_spectrum.enabled)
 		{
-			txSAI_volume += txSAI[i];
+			if (!spectrum)
+			{
+				frame = xTaskGetTickCount();
+				spectrum = 1;
+			}
+
+			// Spectrum: the FFT runs at the display rate, the audio task only fills the ring
+			taskENTER_CRITICAL();
+			spectrum_snapshot(&audio_spectrum);
+			taskEXIT_CRITICAL();
+			spectrum_update(&audio_spectrum);
+			MCP23S17_Set_LEDs(MCP23S17_VU, ~spectrum_leds(&audio_spectrum));	// LEDs are active low
+
+			vTaskDelayUntil(&frame, SPECTRUM_PERIOD_MS / portTICK_PERIOD_MS);
+			continue;
 		}
-		txSAI_volume = log10f((float)(txSAI_volume)/(SAI_BUFFER_LENGTH*0x7FFF));
+		if (spectrum)
+		{
+			spectrum = 0;
+			shown[0] = shown[1] = -1;
+		}
+
+		// VU-Metre: envelope computed by the audio task for the compressor, 0 dBFS at 100%.
+		// The bars move by 1% per VU_STEP_MS, so the steps due since the last one are applied
+		const int steps = (int)((xTaskGetTickCount() - slew) / step);
+		int moving = 0;
+
+		slew += steps * step;
+		for (int ch = 0; ch < 2; ch++)
+		{
+			int target = 100 + (int)(audio_dynamics.detector.db[ch] * 100 / LEVEL_DB(VU_RANGE_DB));
 
-		// 0 dB at 70%
-		if (VU_level < txSAI_volume+70) VU_level += 1;
-		if (VU_level > txSAI_volume+70) VU_level -= 1;
+			if (target < 0) target = 0;
+			if (VU_level[ch] < target) VU_level[ch] = (VU_level[ch] + steps < target) ? VU_level[ch] + steps : target;
+			if (VU_level[ch] > target) VU_level[ch] = (VU_level[ch] - steps > target) ? VU_level[ch] - steps : target;
+			if (VU_level[ch] != target) moving = 1;
+		}
 
-		MCP23S17_level_L(VU_level);
-		MCP23S17_level_R(VU_level);
+		// SPI only when a LED changes, both bars in one frame
+		if (VU_BARS(VU_level[0]) != shown[0])
+		{
+			MCP23S17_Stage_level_L(MCP23S17_VU, VU_level[0]);
+			shown[0] = VU_BARS(VU_level[0]);
+		}
+		if (VU_BARS(VU_level[1]) != shown[1])
+		{
+			MCP23S17_Stage_level_R(MCP23S17_VU, VU_level[1]);
+			shown[1] = VU_BARS(VU_level[1]);
+		}
+		MCP23S17_Flush();
 
-		vTaskDelay( 4/portTICK_PERIOD_MS );  // 1 ms delay
+		// Next step while the bars move, otherwise until the meter moves
+		if (moving)
+		{
+			sched_wait(SCHED_EVT_DISPLAY, step);
+		}
+		else
+		{
+			sched_wait(SCHED_EVT_DISPLAY, idle);
+			slew = xTaskGetTickCount() - step;
+		}
 	}
 }
 
@@ -214,50 +366,16 @@ void task_GPIO_expander (void * unused) {
 // SAI
 /////////////////////////////////////////////////////////////////////
 
-/**
- * @brief Generates a triangular waveform.
- * @param buffer: Pointer to the buffer to hold the waveform.
- * @param length: Number of samples in the waveform.
- * @param amplitude: Peak amplitude of the waveform.
- */
-void GenerateTriangleWave(uint8_t* buffer, uint16_t length, uint16_t amplitude)
-{
-	uint16_t step = (2 * amplitude) / length;
-	uint16_t value = 0;
-	int8_t direction = 1;
-
-	for (uint16_t i = 0; i < length; i++) {
-		buffer[i] = value;
-		value += step * direction;
-
-		if (value >= amplitude) {
-			value = amplitude;
-			direction = -1; // Start decreasing
-		} else if (value <= 0) {
-			value = 0;
-			direction = 1; // Start increasing
-		}
-	}
-}
-
 /**
  * @brief SAI error callback.
  * @param hsai: Pointer to the SAI handle.
  */
 void HAL_SAI_ErrorCallback(SAI_HandleTypeDef *hsai)
 {
-    printf("Error: SAI encountered an error\r\n");
-
-    // Attempt to restart DMA transmission and reception
-    if (HAL_SAI_Transmit_DMA(&hsai_BlockA2, (uint8_t*)txSAI, SAI_BUFFER_LENGTH) != HAL_OK) {
-        printf("Error: Failed to restart SAI DMA transmission\r\n");
-        Error_Handler();
-    }
-
-    if (HAL_SAI_Receive_DMA(&hsai_BlockA2, rxSAI, SAI_BUFFER_LENGTH) != HAL_OK) {
-        printf("Error: Failed to restart SAI DMA reception\r\n");
-        Error_Handler();
-    }
+    LOG_ERR(LOG_MOD_SAI, "SAI encountered an error (code 0x%lX)", hsai->ErrorCode);
+
+    // The audio task restarts the block concerned if its DMA has stopped
+    audio_sai_error(hsai);
 }
 
 /* USER CODE END 0 */
@@ -279,6 +397,8 @@ int main(void)
 	HAL_Init();
 
 	/* USER CODE BEGIN Init */
+	// Reset cause, before anything clears the RCC flags
+	watchdog_init();
 
 	/* USER CODE END Init */
 
@@ -300,61 +420,43 @@ int main(void)
 	MX_SPI3_Init();
 	MX_SAI2_Init();
 	/* USER CODE BEGIN 2 */
-	// Initialize GPIO expander
-	MCP23S17_Init();
+	// Deferred logger, timestamped by the DWT cycle counter
+	profiling_init();
+	log_init();
+	sched_init();
+	power_init();
+
+	// Initialize GPIO expander, the audio does not depend on it
+	if (MCP23S17_Init() != DRV_OK) {
+		LOG_ERR(LOG_MOD_MAIN, "GPIO expander unavailable, VU meter disabled");
+	}
 	__HAL_RCC_SAI2_CLK_ENABLE();
 	__HAL_RCC_DMA2_CLK_ENABLE();
 	__HAL_SAI_ENABLE(&hsai_BlockA2);
 	__HAL_SAI_ENABLE(&hsai_BlockB2);
-	SGTL5000_Init();
-
-	// Generate the triangular waveform
-	GenerateTriangleWave(txSAI, SAI_BUFFER_LENGTH, 0x7FFF); // 16-bit amplitude (0x7FFF)
-	printf("Triangle Wave generation\r\n");
-
-	// Start SAI DMA transmission
-	if (HAL_SAI_Transmit_DMA(&hsai_BlockA2, (uint8_t*)txSAI, SAI_BUFFER_LENGTH) != HAL_OK) {
-		printf("Error: Failed to start SAI DMA transmission\r\n");
-		Error_Handler();
+	if (SGTL5000_Init() != DRV_OK) {
+		LOG_ERR(LOG_MOD_MAIN, "Codec not configured, no sound (see E)");
 	}
 
-	// Start SAI DMA reception
-	if (HAL_SAI_Receive_DMA(&hsai_BlockA2, rxSAI, SAI_BUFFER_LENGTH) != HAL_OK) {
-		printf("Error: Failed to start SAI DMA reception\r\n");
+	// Prefill the output with the signal generator, then start SAI DMA (RX and TX)
+	audio_init();
+	if (audio_start() != HAL_OK) {
+		printf("Error: Failed to start SAI DMA\r\n");
+		log_flush();
 		Error_Handler();
 	}
 
 	// Test printf
 	printf("******* TP Autoradio *******\r\n");
 
-	// Create the task, storing the handle.
-	Error_Handler_xTaskCreate(
-			xTaskCreate(task_GPIO_expander, // Function that implements the task.
-					"GPIO_expander", // Text name for the task.
-					STACK_DEPTH, // Stack size in words, not bytes.
-					(void *) 500, // 500 ms
-					TASK_MCP23S17_PRIORITY, // Priority at which the task is created.
-					&h_task_GPIOExpander)); // Used to pass out the created task's handle.
-
 	// Turn on LED2 (Green)
 	HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
 
-	// Create the task, storing the handle.
-	Error_Handler_xTaskCreate(
-			xTaskCreate(task_LED, // Function that implements the task.
-					"LED LD2", // Text name for the task.
-					STACK_DEPTH, // Stack size in words, not bytes.
-					(void *) DELAY_LED_TOGGLE, // Parameter passed into the task.
-					1,// Priority at which the task is created.
-					&h_task_LED)); // Used to pass out the created task's handle.
-	// Shell task
-	Error_Handler_xTaskCreate(
-			xTaskCreate(task_shell,
-					"Shell",
-					STACK_DEPTH,
-					NULL,
-					TASK_SHELL_PRIORITY,
-					&h_task_shell));
+	// Create every task of APP_TASKS, without using the FreeRTOS heap
+	app_tasks_create();
+
+	// From now on every supervised task must check in, see watchdog.h
+	watchdog_start();
 
 	// OS Start
 	vTaskStartScheduler();
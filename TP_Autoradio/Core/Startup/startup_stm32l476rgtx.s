@@ -44,6 +44,16 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start/end addresses and initialization values of the RAM2 sections.
+defined in linker script */
+.word	_sifast_code
+.word	_sfast_code
+.word	_efast_code
+.word	_siram2_data
+.word	_sram2_data
+.word	_eram2_data
+.word	_sram2_bss
+.word	_eram2_bss
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -95,6 +105,30 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the RAM2 code and data initializers from flash to SRAM2 */
+  ldr r0, =_sfast_code
+  ldr r1, =_efast_code
+  ldr r2, =_sifast_code
+  bl CopyInit
+  ldr r0, =_sram2_data
+  ldr r1, =_eram2_data
+  ldr r2, =_siram2_data
+  bl CopyInit
+
+/* Zero fill the RAM2 bss segment. */
+  ldr r2, =_sram2_bss
+  ldr r4, =_eram2_bss
+  movs r3, #0
+  b LoopFillZeroRam2bss
+
+FillZeroRam2bss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroRam2bss:
+  cmp r2, r4
+  bcc FillZeroRam2bss
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -102,6 +136,22 @@ LoopFillZerobss:
 
 LoopForever:
     b LoopForever
+
+/* Copies [r0, r1) from r2, word by word. Clobbers r3, r4. */
+CopyInit:
+  movs r3, #0
+  b LoopCopyInit
+
+CopyInitWord:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyInitWord
+  bx lr
     
 .size	Reset_Handler, .-Reset_Handler
 
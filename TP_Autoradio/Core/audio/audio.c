@@ -0,0 +1,1032 @@
+/*
+ * audio.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "audio.h"
+
+#include <string.h>
+#include "cmsis_os.h"
+#include "sai.h"
+
+#include "../utils/log.h"
+#include "../utils/profiling.h"
+#include "../utils/sched.h"
+#include "../utils/scratch.h"
+#include "../utils/sections.h"
+#include "../utils/watchdog.h"
+
+// Task notification bits
+#define AUDIO_EVT_HALF (1U << 0)	// First half played, to be refilled
+#define AUDIO_EVT_FULL (1U << 1)	// Second half played, to be refilled
+#define AUDIO_EVT_ERROR (1U << 2)	// SAI error, see audio_sai_error()
+#define AUDIO_EVT_ALL (AUDIO_EVT_HALF | AUDIO_EVT_FULL | AUDIO_EVT_ERROR)
+
+#define AUDIO_ERR_TX (1U << 0)
+#define AUDIO_ERR_RX (1U << 1)
+#define AUDIO_RESYNC_BLOCKS 4		// Blocks with RX and TX in different halves before a resync
+#define AUDIO_METER_PERIOD_MS 4		// Meter events at most this often
+#define AUDIO_METER_FLOOR_DB (-60)	// Below, a single level: the noise floor wakes nobody
+
+// DMA buffers and graph blocks, carved for the block size: must stay in SRAM1 (see sections.h)
+static int16_t audio_pool[AUDIO_CHANNELS * AUDIO_MAX_BLOCK_FRAMES * (2 + 2 + GRAPH_MAX_BUFFERS)];
+uint32_t audio_block_frames = AUDIO_DEFAULT_BLOCK_FRAMES;
+int16_t * rxSAI;
+int16_t * txSAI;
+
+mailbox_t audio_mailbox DSP_STATE;
+graph_t audio_graph DSP_STATE;
+mixer_t audio_mixer DSP_STATE;
+chime_t audio_chime DSP_STATE;
+siggen_t audio_generator DSP_STATE;
+biquad_t audio_eq DSP_STATE;
+rc_filter_t audio_rc DSP_STATE;
+delay_t audio_delay DSP_STATE;
+reverb_t audio_reverb DSP_STATE;
+dynamics_t audio_dynamics DSP_STATE;
+loudness_t audio_loudness DSP_STATE;
+spectrum_t audio_spectrum DSP_STATE;
+src_t audio_src DSP_STATE;
+latency_t audio_latency;					// Recording in the shell scratch, during the measurement only
+
+#if (LATENCY_CAPTURE_FRAMES * 2 > SCRATCH_SIZE)
+#error "Latency recording larger than the scratch"
+#endif
+
+static int16_t audio_delay_line[DELAY_CHANNELS * DELAY_LENGTH] MEM_PLACE(DELAY_MEM);
+static int16_t audio_reverb_pool[REVERB_POOL_SAMPLES];
+
+// Resampled source, see AUDIO_SOURCE_RESAMPLED
+static siggen_t audio_src_generator DSP_STATE;
+static int16_t audio_src_fifo[AUDIO_CHANNELS * AUDIO_SRC_FIFO_FRAMES];
+static uint32_t audio_src_fill;
+static uint64_t audio_src_clock;		// Frames due to the FIFO, Q32
+static int32_t audio_src_drift;			// ppm
+static volatile src_quality_t audio_src_quality = SRC_MEDIUM;
+static volatile uint8_t audio_src_restart;
+
+static volatile audio_source_t audio_source = AUDIO_SOURCE_GENERATOR;
+static const int16_t * audio_in;		// Captured block being processed
+static const int16_t * audio_line_read;	// Next frames of audio_in for the mixer
+static int audio_mix_line, audio_mix_gen, audio_mix_chime;
+static volatile uint8_t audio_bypassed;	// Codec routed without the MCU, see audio_set_bypass()
+static TaskHandle_t audio_task = NULL;
+
+// Deadlines: halves played (DMA interrupt) against halves refilled (task)
+static volatile uint32_t audio_tx_seq;
+static uint32_t audio_done_seq;
+static volatile uint32_t audio_errors;		// AUDIO_ERR_x to recover
+static uint32_t audio_misaligned;			// Consecutive blocks with RX and TX apart
+static volatile audio_fill_t audio_fill = AUDIO_FILL_REPEAT;
+static volatile uint32_t audio_stress_cycles;
+audio_stats_t audio_stats;
+
+// Meter: last envelope signalled to the display, in dB
+static int32_t audio_meter_db[2];
+static TickType_t audio_meter_tick;
+
+
+/**
+ * @brief Resampled source: the 44.1 kHz generator produces what its clock
+ * gives for one block into the FIFO, the converter takes what it needs for
+ * one block at 48 kHz, and the ratio follows the FIFO level.
+ * The generator settings are copied from audio_generator.
+ */
+static ISR_CODE void audio_resampled_fill(int16_t * out, uint32_t frames)
+{
+	const uint64_t rate = ((uint64_t)AUDIO_SRC_RATE * frames << 32) / AUDIO_SAMPLE_RATE;
+	siggen_t * gen = &audio_src_generator;
+
+	if (audio_src_restart)
+	{
+		// Half full, for the same margin on both sides
+		src_set_quality(&audio_src, audio_src_quality);
+		memset(audio_src_fifo, 0, sizeof(audio_src_fifo));
+		audio_src_fill = AUDIO_SRC_FIFO_FRAMES / 2;
+		audio_src_clock = 0;
+		gen->phase = 0;
+		audio_src_restart = 0;
+	}
+
+	gen->wave = audio_generator.wave;
+	gen->band_limited = audio_generator.band_limited;
+	gen->amplitude = audio_generator.amplitude;
+	gen->phase_inc = (uint32_t)(((uint64_t)audio_generator.phase_inc * AUDIO_SAMPLE_RATE) / AUDIO_SRC_RATE);
+
+	audio_src_clock += rate + (int64_t)rate * audio_src_drift / 1000000;
+
+	uint32_t due = (uint32_t)(audio_src_clock >> 32);
+	uint32_t room = AUDIO_SRC_FIFO_FRAMES - audio_src_fill;
+
+	audio_src_clock &= 0xFFFFFFFFU;
+	siggen_fill(gen, &audio_src_fifo[AUDIO_CHANNELS * audio_src_fill], (due < room) ? due : room);
+	audio_src_fill += (due < room) ? due : room;
+
+	uint32_t consumed;
+	uint32_t produced = src_process(&audio_src, audio_src_fifo, audio_src_fill, &consumed, out, frames);
+
+	if (produced < frames)
+	{
+		memset(&out[AUDIO_CHANNELS * produced], 0, (frames - produced) * AUDIO_CHANNELS * sizeof(int16_t));
+	}
+
+	audio_src_fill -= consumed;
+	memmove(audio_src_fifo, &audio_src_fifo[AUDIO_CHANNELS * consumed], audio_src_fill * AUDIO_CHANNELS * sizeof(int16_t));
+	src_track(&audio_src, audio_src_fill, AUDIO_SRC_FIFO_FRAMES / 2);
+}
+
+/**
+ * @brief Mixer source: captured line-in block.
+ */
+static ISR_CODE int audio_line_fill(void * ctx, int16_t * block, uint32_t frames)
+{
+	memcpy(block, audio_line_read, frames * AUDIO_CHANNELS * sizeof(int16_t));
+	audio_line_read += frames * AUDIO_CHANNELS;		// Long blocks are mixed in several chunks
+	return 1;
+}
+
+/**
+ * @brief Mixer source: generator, directly at 48 kHz or through the converter.
+ */
+static ISR_CODE int audio_generator_fill(void * ctx, int16_t * block, uint32_t frames)
+{
+	if (audio_source == AUDIO_SOURCE_RESAMPLED)
+	{
+		// By chunks, so that the FIFO covers any block size
+		for (uint32_t done = 0; done < frames; done += AUDIO_SRC_FIFO_FRAMES / 4)
+		{
+			uint32_t chunk = frames - done;
+
+			audio_resampled_fill(&block[AUDIO_CHANNELS * done], (chunk < AUDIO_SRC_FIFO_FRAMES / 4) ? chunk : AUDIO_SRC_FIFO_FRAMES / 4);
+		}
+	}
+	else
+	{
+		siggen_fill(&audio_generator, block, frames);
+	}
+	return 1;
+}
+
+/**
+ * Graph stages around the processing functions, in their default order.
+ */
+#define AUDIO_STAGE(name, process, type) \
+	static ISR_CODE void audio_stage_##name(void * ctx, int16_t * block, uint32_t frames) \
+	{ \
+		process((type *)ctx, block, frames); \
+	}
+
+AUDIO_STAGE(mixer, mixer_process, mixer_t)
+AUDIO_STAGE(rc, rc_filter_process, rc_filter_t)
+AUDIO_STAGE(eq, biquad_process, biquad_t)
+AUDIO_STAGE(echo, delay_process, delay_t)
+AUDIO_STAGE(reverb, reverb_process, reverb_t)
+AUDIO_STAGE(comp, dynamics_process, dynamics_t)
+AUDIO_STAGE(spectrum, spectrum_capture, spectrum_t)
+
+static ISR_CODE void audio_stage_loudness(void * ctx, int16_t * block, uint32_t frames)
+{
+	loudness_process(ctx, audio_in, block, frames, level_follower_linked(&audio_dynamics.detector));
+}
+
+static void audio_reset_eq(void * ctx)
+{
+	biquad_reset(ctx);
+}
+
+static void audio_reset_echo(void * ctx)
+{
+	delay_clear(ctx);
+}
+
+static void audio_reset_reverb(void * ctx)
+{
+	reverb_clear(ctx);
+}
+
+static const graph_stage_t audio_stages[] = {
+		{ "mixer", audio_stage_mixer, NULL, GRAPH_SOURCE },
+		{ "rc", audio_stage_rc, NULL, 0 },
+		{ "eq", audio_stage_eq, audio_reset_eq, 0 },
+		{ "echo", audio_stage_echo, audio_reset_echo, 0 },
+		{ "reverb", audio_stage_reverb, audio_reset_reverb, 0 },
+		{ "loudness", audio_stage_loudness, NULL, 0 },
+		{ "comp", audio_stage_comp, NULL, 0 },
+		{ "spectrum", audio_stage_spectrum, NULL, GRAPH_SINK },
+};
+
+static void * const audio_stage_ctx[] = {
+		&audio_mixer, &audio_rc, &audio_eq, &audio_delay,
+		&audio_reverb, &audio_loudness, &audio_dynamics, &audio_spectrum
+};
+
+/**
+ * @brief Computes one half of the output buffer.
+ * @param half: 0 for the first half, 1 for the second one.
+ */
+static ISR_CODE void audio_process(uint32_t half)
+{
+	const int16_t * in = &rxSAI[half * (SAI_BUFFER_LENGTH / 2)];
+	int16_t * out = &txSAI[half * (SAI_BUFFER_LENGTH / 2)];
+
+	mailbox_drain(&audio_mailbox);
+	audio_in = in;
+	audio_line_read = in;
+	graph_process(&audio_graph, out, audio_block_frames);
+	latency_process(&audio_latency, in, out, audio_block_frames);
+}
+
+/**
+ * @brief DMA buffers then graph blocks, for the current block size.
+ */
+static void audio_carve(void)
+{
+	rxSAI = audio_pool;
+	txSAI = &audio_pool[SAI_BUFFER_LENGTH];
+}
+
+static inline int16_t * audio_graph_pool(void)
+{
+	return &audio_pool[2 * SAI_BUFFER_LENGTH];
+}
+
+/**
+ * @brief Initializes the generator and fills both halves before the DMA starts.
+ */
+void audio_init(void)
+{
+	audio_carve();
+	mailbox_init(&audio_mailbox);
+	siggen_init(&audio_generator, AUDIO_SAMPLE_RATE);
+	siggen_set_wave(&audio_generator, SIGGEN_TRIANGLE);
+	siggen_init(&audio_src_generator, AUDIO_SRC_RATE);
+	chime_init(&audio_chime, AUDIO_SAMPLE_RATE);
+	mixer_init(&audio_mixer);
+	audio_mix_line = mixer_add(&audio_mixer, "line", audio_line_fill, NULL, 0);
+	audio_mix_gen = mixer_add(&audio_mixer, "gen", audio_generator_fill, NULL, 0);
+	audio_mix_chime = mixer_add(&audio_mixer, "chime", chime_fill, &audio_chime, 1);
+	audio_set_source(audio_source);
+	src_init(&audio_src, AUDIO_SRC_RATE, AUDIO_SAMPLE_RATE, audio_src_quality);
+	biquad_init(&audio_eq, BIQUAD_DF1_Q31);
+	rc_filter_init(&audio_rc, AUDIO_SAMPLE_RATE);
+	delay_init(&audio_delay, audio_delay_line, DELAY_LENGTH, AUDIO_SAMPLE_RATE);
+	reverb_init(&audio_reverb, audio_reverb_pool);
+	dynamics_init(&audio_dynamics, AUDIO_SAMPLE_RATE, audio_block_frames);
+	loudness_init(&audio_loudness, AUDIO_SAMPLE_RATE);
+	spectrum_init(&audio_spectrum, AUDIO_SAMPLE_RATE);
+	latency_init(&audio_latency);
+
+	// Chain in the order of audio_stages
+	graph_init(&audio_graph, audio_graph_pool(), audio_block_frames);
+	for (uint32_t i = 0; i < sizeof(audio_stages) / sizeof(audio_stages[0]); i++)
+	{
+		int node = graph_add(&audio_graph, &audio_stages[i], audio_stage_ctx[i]);
+
+		graph_link(&audio_graph, node, (i == 0) ? GRAPH_NONE : node - 1);
+		graph_set_output(&audio_graph, node);
+	}
+	if (graph_build(&audio_graph) != 0)
+	{
+		LOG_ERR(LOG_MOD_AUDIO, "Invalid audio graph");
+	}
+
+	memset(rxSAI, 0, SAI_BUFFER_LENGTH * sizeof(int16_t));
+	audio_process(0);
+	audio_process(1);
+}
+
+/**
+ * @brief Half and full transfer interrupts of both DMA, the transfers go on either way.
+ */
+static void audio_dma_irq(int enable)
+{
+	DMA_HandleTypeDef * const dma[] = { hsai_BlockA2.hdmatx, hsai_BlockB2.hdmarx };
+
+	for (uint32_t i = 0; i < sizeof(dma) / sizeof(dma[0]); i++)
+	{
+		if (enable)
+		{
+			__HAL_DMA_ENABLE_IT(dma[i], DMA_IT_HT | DMA_IT_TC);
+		}
+		else
+		{
+			__HAL_DMA_DISABLE_IT(dma[i], DMA_IT_HT | DMA_IT_TC);
+		}
+	}
+}
+
+/**
+ * @brief Starts the circular DMA transfers, reception (slave) first.
+ * @retval HAL_StatusTypeDef: HAL_OK, or the status of the failing call.
+ */
+HAL_StatusTypeDef audio_start(void)
+{
+	HAL_StatusTypeDef status;
+
+	status = HAL_SAI_Receive_DMA(&hsai_BlockB2, (uint8_t *)rxSAI, SAI_BUFFER_LENGTH);
+	if (status != HAL_OK)
+	{
+		LOG_ERR(LOG_MOD_SAI, "Failed to start SAI DMA reception (%d)", status);
+		return status;
+	}
+
+	status = HAL_SAI_Transmit_DMA(&hsai_BlockA2, (uint8_t *)txSAI, SAI_BUFFER_LENGTH);
+	if (status != HAL_OK)
+	{
+		LOG_ERR(LOG_MOD_SAI, "Failed to start SAI DMA transmission (%d)", status);
+	}
+	if (audio_bypassed)
+	{
+		audio_dma_irq(0);
+	}
+
+	return status;
+}
+
+/**
+ * @brief Changes the block size: both DMA are stopped, the buffers carved
+ * again, the stages whose state depends on the block reset, then both
+ * halves are computed and the DMA restarted. Called from a task, about two
+ * blocks of silence.
+ * @param frames: Power of two, AUDIO_MIN_BLOCK_FRAMES to AUDIO_MAX_BLOCK_FRAMES.
+ * @retval int: 0 on success, -1 if the size is not supported, -2 if the DMA failed to restart.
+ */
+int audio_set_block_frames(uint32_t frames)
+{
+	if (frames < AUDIO_MIN_BLOCK_FRAMES || frames > AUDIO_MAX_BLOCK_FRAMES || (frames & (frames - 1)) != 0)
+	{
+		return -1;
+	}
+
+	audio_stop();
+
+	audio_block_frames = frames;
+	audio_carve();
+	graph_set_pool(&audio_graph, audio_graph_pool(), frames);
+	graph_reset(&audio_graph);
+	dynamics_set_block(&audio_dynamics, frames);
+	audio_src_restart = 1;
+	audio_reset_stats();
+
+	if (audio_resume() != HAL_OK)
+	{
+		return -2;
+	}
+	LOG_INFO(LOG_MOD_AUDIO, "Block size: %lu frames", frames);
+
+	return 0;
+}
+
+/**
+ * @brief Stops both DMA and the SAI, the audio task has no block left to
+ * compute. Called from a task, the audio task (higher priority) is waiting
+ * for its next block meanwhile.
+ */
+void audio_stop(void)
+{
+	HAL_SAI_DMAStop(&hsai_BlockA2);
+	HAL_SAI_DMAStop(&hsai_BlockB2);
+	watchdog_pause(WATCHDOG_AUDIO);
+
+	// No block pending: the TX interrupts are stopped
+	audio_tx_seq = 0;
+	audio_done_seq = 0;
+	audio_misaligned = 0;
+}
+
+/**
+ * @brief Restarts after audio_stop(): both halves are computed from a
+ * silent input, then the DMA are started.
+ * @retval HAL_StatusTypeDef: Status of audio_start().
+ */
+HAL_StatusTypeDef audio_resume(void)
+{
+	memset(rxSAI, 0, SAI_BUFFER_LENGTH * sizeof(int16_t));
+	audio_process(0);
+	audio_process(1);
+
+	// Supervised again even if the start fails: no audio is a hang
+	watchdog_checkin(WATCHDOG_AUDIO);
+
+	return audio_start();
+}
+
+/**
+ * @brief Audio without the MCU (codec routing from the ADC). The SAI keeps
+ * running since it clocks the codec, but its DMA interrupts are masked: the
+ * audio task is not woken any more and the output is silence. Called from
+ * a task, the codec routing is up to the caller (after bypassing, before
+ * resuming).
+ * @param bypass: 1 to bypass, 0 to resume at the next half.
+ */
+void audio_set_bypass(int bypass)
+{
+	if (bypass && !audio_bypassed)
+	{
+		audio_bypassed = 1;
+		audio_dma_irq(0);
+		watchdog_pause(WATCHDOG_AUDIO);
+		memset(txSAI, 0, SAI_BUFFER_LENGTH * sizeof(int16_t));
+
+		// The VU meter falls back to silence instead of freezing
+		for (int ch = 0; ch < LEVEL_CHANNELS; ch++)
+		{
+			audio_dynamics.detector.db[ch] = LEVEL_DB_MIN;
+		}
+		sched_signal(SCHED_EVT_DISPLAY);
+	}
+	else if (!bypass && audio_bypassed)
+	{
+		// No half pending: the first interrupt is one block due
+		audio_bypassed = 0;
+		watchdog_checkin(WATCHDOG_AUDIO);
+		audio_dma_irq(1);
+	}
+}
+
+int audio_get_bypass(void)
+{
+	return audio_bypassed;
+}
+
+/**
+ * @brief Nothing for the MCU to do: line-in alone at unity gain, every
+ * stage off and no measurement. The codec can then play without it.
+ * @retval int: 1 if idle, 0 otherwise.
+ */
+int audio_mcu_idle(void)
+{
+	const mixer_source_t * sources = audio_mixer.sources;
+
+	return audio_source == AUDIO_SOURCE_LINE_IN
+			&& sources[audio_mix_line].enabled && sources[audio_mix_line].gain == INT16_MAX
+			&& !sources[audio_mix_gen].enabled
+			&& !sources[audio_mix_chime].active && !audio_chime.trigger
+			&& audio_rc.mode == RC_OFF && audio_eq.stages == 0
+			&& !audio_delay.enabled && !audio_reverb.enabled
+			&& !audio_dynamics.enabled && !audio_loudness.enabled
+			&& !audio_spectrum.enabled && audio_latency.state == LATENCY_IDLE;
+}
+
+/**
+ * @brief Waits until the audio task has taken the last schedule built.
+ * @param status: Result of a graph change, returned as is.
+ * @retval int: status, or -2 if the schedule has not been taken after 50 ms
+ * (audio stopped).
+ */
+int audio_graph_commit(int status)
+{
+	for (int i = 0; i < 50 && audio_graph.pending; i++)
+	{
+		osDelay(1);
+	}
+
+	return audio_graph.pending ? -2 : status;
+}
+
+/**
+ * @brief Waits until the audio task has applied every parameter posted.
+ * @retval int: 0, or -2 if not done after 50 ms (audio stopped).
+ */
+int audio_params_sync(void)
+{
+	for (int i = 0; i < 50 && !mailbox_empty(&audio_mailbox); i++)
+	{
+		osDelay(1);
+	}
+
+	return mailbox_empty(&audio_mailbox) ? 0 : -2;
+}
+
+/**
+ * @brief Measures the round trip from the output block to the input block,
+ * the loopback being set up by the caller. The output is replaced by the
+ * marker during the capture (85 ms). Recorded in the shell scratch, so from
+ * the shell only, like the benchmarks.
+ * @param signal: Marker.
+ * @param simulated: Frames of a simulated loop, on top of the DMA buffering
+ * (2 * audio_block_frames), LATENCY_NONE to use the input.
+ * @retval int32_t: Round trip in frames, LATENCY_NONE if not found or if the audio is stopped.
+ */
+int32_t audio_measure_latency(latency_signal_t signal, int32_t simulated)
+{
+	if (simulated != LATENCY_NONE)
+	{
+		simulated += 2 * audio_block_frames;
+	}
+	if (latency_start(&audio_latency, scratch_get(), signal, simulated) != 0)
+	{
+		return LATENCY_NONE;
+	}
+
+	uint32_t timeout = 2 * 1000U * LATENCY_CAPTURE_FRAMES / AUDIO_SAMPLE_RATE;
+
+	for (uint32_t i = 0; i < timeout && audio_latency.state == LATENCY_RUNNING; i++)
+	{
+		watchdog_checkin(WATCHDOG_SHELL);	// Started from the shell task
+		osDelay(1);
+	}
+	if (audio_latency.state == LATENCY_RUNNING)
+	{
+		// The scratch goes back to the shell: the audio task must not write it any more
+		latency_cancel(&audio_latency);
+		return LATENCY_NONE;
+	}
+
+	watchdog_checkin(WATCHDOG_SHELL);
+	return latency_analyze(&audio_latency);
+}
+
+/**
+ * EQ changes: several words each, applied by the audio task between two blocks.
+ */
+typedef struct {
+	uint32_t stage;
+	biquad_coefs_t coefs;
+} audio_eq_stage_msg_t;
+
+static ISR_CODE void audio_apply_eq_stage(void * ctx, const void * payload)
+{
+	const audio_eq_stage_msg_t * msg = payload;
+
+	biquad_set_stage(ctx, msg->stage, &msg->coefs);
+}
+
+static ISR_CODE void audio_apply_eq_stages(void * ctx, const void * payload)
+{
+	biquad_set_stages(ctx, *(const uint32_t *)payload);
+}
+
+static ISR_CODE void audio_apply_eq_type(void * ctx, const void * payload)
+{
+	biquad_set_type(ctx, *(const biquad_type_t *)payload);
+}
+
+/**
+ * @brief Loads the coefficients of one stage of audio_eq.
+ * @retval int: 0 on success, -1 if the stage does not exist or the mailbox is full.
+ */
+int audio_eq_set_stage(uint32_t stage, const biquad_coefs_t * coefs)
+{
+	audio_eq_stage_msg_t msg = { stage, *coefs };
+
+	if (stage >= BIQUAD_MAX_STAGES)
+	{
+		return -1;
+	}
+
+	return mailbox_post(&audio_mailbox, audio_apply_eq_stage, &audio_eq, &msg, sizeof(msg));
+}
+
+int audio_eq_set_stages(uint32_t stages)
+{
+	return mailbox_post(&audio_mailbox, audio_apply_eq_stages, &audio_eq, &stages, sizeof(stages));
+}
+
+int audio_eq_set_type(biquad_type_t type)
+{
+	return mailbox_post(&audio_mailbox, audio_apply_eq_type, &audio_eq, &type, sizeof(type));
+}
+
+/**
+ * Effect settings: each message carries a whole set of fields, written by
+ * the audio task between two blocks, so a block never runs with half of
+ * them. The enable flags and the echo time are single words, set directly.
+ */
+typedef struct {
+	rc_mode_t mode;
+	uint32_t cutoff;
+} audio_rc_msg_t;
+
+typedef struct {
+	int16_t feedback;
+	int16_t wet;
+	int16_t dry;
+} audio_delay_mix_msg_t;
+
+typedef struct {
+	int32_t room;
+	int32_t damping;
+	int32_t wet;
+} audio_reverb_msg_t;
+
+static ISR_CODE void audio_apply_rc(void * ctx, const void * payload)
+{
+	const audio_rc_msg_t * msg = payload;
+
+	rc_filter_set_cutoff(ctx, msg->cutoff);
+	rc_filter_set_mode(ctx, msg->mode);
+}
+
+static ISR_CODE void audio_apply_delay_mix(void * ctx, const void * payload)
+{
+	const audio_delay_mix_msg_t * msg = payload;
+
+	delay_set_mix(ctx, msg->feedback, msg->wet, msg->dry);
+}
+
+static ISR_CODE void audio_apply_reverb(void * ctx, const void * payload)
+{
+	const audio_reverb_msg_t * msg = payload;
+
+	reverb_set_params(ctx, msg->room, msg->damping, msg->wet);
+}
+
+static ISR_CODE void audio_apply_dynamics(void * ctx, const void * payload)
+{
+	dynamics_set_params(ctx, payload);
+}
+
+/**
+ * @brief Response and cutoff of audio_rc.
+ * @retval int: 0 on success, -1 if the cutoff is out of 1..fs / 2 or the mailbox is full.
+ */
+int audio_rc_set(rc_mode_t mode, uint32_t cutoff)
+{
+	audio_rc_msg_t msg = { mode, cutoff };
+
+	if (cutoff == 0 || cutoff > audio_rc.sample_rate / 2)
+	{
+		return -1;
+	}
+
+	return mailbox_post(&audio_mailbox, audio_apply_rc, &audio_rc, &msg, sizeof(msg));
+}
+
+/**
+ * @brief Feedback and wet/dry levels of audio_delay, Q15.
+ * @retval int: 0 on success, -1 if the mailbox is full.
+ */
+int audio_delay_set_mix(int16_t feedback, int16_t wet, int16_t dry)
+{
+	audio_delay_mix_msg_t msg = { feedback, wet, dry };
+
+	return mailbox_post(&audio_mailbox, audio_apply_delay_mix, &audio_delay, &msg, sizeof(msg));
+}
+
+/**
+ * @brief Room, damping and wet level of audio_reverb, 0..100 % each.
+ * @retval int: 0 on success, -1 if the mailbox is full.
+ */
+int audio_reverb_set_params(int room, int damping, int wet)
+{
+	audio_reverb_msg_t msg = { room, damping, wet };
+
+	return mailbox_post(&audio_mailbox, audio_apply_reverb, &audio_reverb, &msg, sizeof(msg));
+}
+
+/**
+ * @brief Every control of audio_dynamics, see dynamics_get_params() to change a few.
+ * @retval int: 0 on success, -1 if the look-ahead is out of range or the mailbox is full.
+ */
+int audio_dynamics_set(const dynamics_params_t * params)
+{
+	if (params->lookahead_ms < 0.0f || params->lookahead_ms > dynamics_max_lookahead(&audio_dynamics))
+	{
+		return -1;
+	}
+
+	return mailbox_post(&audio_mailbox, audio_apply_dynamics, &audio_dynamics, params, sizeof(*params));
+}
+
+void audio_set_source(audio_source_t source)
+{
+	if (source == AUDIO_SOURCE_RESAMPLED && audio_source != AUDIO_SOURCE_RESAMPLED)
+	{
+		audio_src_restart = 1;	// Handled by the audio task before its next block
+	}
+	audio_source = source;
+	mixer_enable(&audio_mixer, audio_mix_line, source == AUDIO_SOURCE_LINE_IN);
+	mixer_enable(&audio_mixer, audio_mix_gen, source != AUDIO_SOURCE_LINE_IN);
+}
+
+audio_source_t audio_get_source(void)
+{
+	return audio_source;
+}
+
+/**
+ * @brief Filter length of the converter, applied by the audio task with a restart.
+ */
+void audio_set_src_quality(src_quality_t quality)
+{
+	audio_src_quality = quality;
+	audio_src_restart = 1;
+}
+
+/**
+ * @brief Offset of the 44.1 kHz clock of the resampled source, to see the converter follow it.
+ */
+void audio_set_src_drift(int32_t ppm)
+{
+	audio_src_drift = ppm;
+}
+
+int32_t audio_get_src_drift(void)
+{
+	return audio_src_drift;
+}
+
+/**
+ * @brief Frames waiting in the FIFO of the resampled source.
+ */
+uint32_t audio_get_src_fill(void)
+{
+	return audio_src_fill;
+}
+
+static ISR_CODE void audio_notify_from_isr(uint32_t event)
+{
+	BaseType_t woken = pdFALSE;
+
+	if (audio_task != NULL)
+	{
+		xTaskNotifyFromISR(audio_task, event, eSetBits, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+
+ISR_CODE void HAL_SAI_TxHalfCpltCallback(SAI_HandleTypeDef * hsai)
+{
+	if (hsai == &hsai_BlockA2)
+	{
+		audio_tx_seq++;
+		audio_notify_from_isr(AUDIO_EVT_HALF);
+	}
+}
+
+ISR_CODE void HAL_SAI_TxCpltCallback(SAI_HandleTypeDef * hsai)
+{
+	if (hsai == &hsai_BlockA2)
+	{
+		audio_tx_seq++;
+		audio_notify_from_isr(AUDIO_EVT_FULL);
+	}
+}
+
+/**
+ * @brief Called by HAL_SAI_ErrorCallback(): counts the error and lets the
+ * audio task restart the block if its DMA has been stopped.
+ */
+ISR_CODE void audio_sai_error(SAI_HandleTypeDef * hsai)
+{
+	if (hsai == &hsai_BlockA2)
+	{
+		audio_stats.sai_errors[0]++;
+		audio_errors |= AUDIO_ERR_TX;
+	}
+	else if (hsai == &hsai_BlockB2)
+	{
+		audio_stats.sai_errors[1]++;
+		audio_errors |= AUDIO_ERR_RX;
+	}
+	audio_notify_from_isr(AUDIO_EVT_ERROR);
+}
+
+/**
+ * @brief Half of the buffer the DMA is transferring now.
+ */
+static inline uint32_t audio_dma_half(SAI_HandleTypeDef * hsai)
+{
+	uint32_t position = SAI_BUFFER_LENGTH - __HAL_DMA_GET_COUNTER(hsai->hdmatx);
+
+	return (position >= SAI_BUFFER_LENGTH / 2) ? 1 : 0;
+}
+
+/**
+ * @brief Restarts the blocks whose DMA has been stopped by an error (an
+ * underrun/overrun flag alone leaves it running). The other block keeps
+ * going, the halves are realigned afterwards by the resync.
+ */
+static void audio_recover(void)
+{
+	taskENTER_CRITICAL();
+	uint32_t errors = audio_errors;
+	audio_errors = 0;
+	taskEXIT_CRITICAL();
+
+	if ((errors & AUDIO_ERR_TX) && hsai_BlockA2.State == HAL_SAI_STATE_READY)
+	{
+		if (HAL_SAI_Transmit_DMA(&hsai_BlockA2, (uint8_t *)txSAI, SAI_BUFFER_LENGTH) != HAL_OK)
+		{
+			LOG_ERR(LOG_MOD_SAI, "Failed to restart SAI DMA transmission");
+		}
+		audio_stats.restarts++;
+		audio_done_seq = audio_tx_seq;
+	}
+
+	if ((errors & AUDIO_ERR_RX) && hsai_BlockB2.State == HAL_SAI_STATE_READY)
+	{
+		if (HAL_SAI_Receive_DMA(&hsai_BlockB2, (uint8_t *)rxSAI, SAI_BUFFER_LENGTH) != HAL_OK)
+		{
+			LOG_ERR(LOG_MOD_SAI, "Failed to restart SAI DMA reception");
+		}
+		audio_stats.restarts++;
+	}
+
+	if (audio_bypassed)
+	{
+		audio_dma_irq(0);
+	}
+}
+
+/**
+ * @brief Restarts the reception alone so that it writes the half the
+ * transmission is reading. Called right after the TX DMA has wrapped to
+ * the first half, the capture starts there too.
+ */
+static void audio_resync(void)
+{
+	HAL_SAI_DMAStop(&hsai_BlockB2);
+	if (HAL_SAI_Receive_DMA(&hsai_BlockB2, (uint8_t *)rxSAI, SAI_BUFFER_LENGTH) != HAL_OK)
+	{
+		LOG_ERR(LOG_MOD_SAI, "Failed to resync SAI DMA reception");
+	}
+	audio_stats.resyncs++;
+	audio_misaligned = 0;
+	LOG_WARN(LOG_MOD_AUDIO, "RX/TX resync");
+}
+
+/**
+ * @brief Missed deadline: the half which should have been refilled has
+ * been played again, the safe half gets silence or the block playing now
+ * (last good one) while the processing catches up.
+ */
+static ISR_CODE void audio_conceal(uint32_t half)
+{
+	int16_t * out = &txSAI[half * (SAI_BUFFER_LENGTH / 2)];
+
+	if (audio_fill == AUDIO_FILL_SILENCE)
+	{
+		memset(out, 0, SAI_BUFFER_LENGTH / 2 * sizeof(int16_t));
+	}
+	else
+	{
+		memcpy(out, &txSAI[(half ^ 1) * (SAI_BUFFER_LENGTH / 2)], SAI_BUFFER_LENGTH / 2 * sizeof(int16_t));
+	}
+}
+
+/**
+ * @brief Tells the display that the meter moved by 1 dB on a channel, at
+ * most every AUDIO_METER_PERIOD_MS, so that it sleeps while the level is
+ * steady.
+ */
+static ISR_CODE void audio_meter_publish(void)
+{
+	const TickType_t now = xTaskGetTickCount();
+	int changed = 0;
+
+	if (now - audio_meter_tick < AUDIO_METER_PERIOD_MS / portTICK_PERIOD_MS)
+	{
+		return;
+	}
+
+	for (int ch = 0; ch < 2; ch++)
+	{
+		int32_t db = audio_dynamics.detector.db[ch] / LEVEL_DB(1);
+
+		if (db < AUDIO_METER_FLOOR_DB) db = AUDIO_METER_FLOOR_DB;
+
+		if (db != audio_meter_db[ch])
+		{
+			audio_meter_db[ch] = db;
+			changed = 1;
+		}
+	}
+
+	if (changed)
+	{
+		audio_meter_tick = now;
+		sched_signal(SCHED_EVT_DISPLAY);
+	}
+}
+
+/**
+ * @brief Highest priority task, refills each DMA half as soon as it has been played.
+ * The sequence counter of the TX interrupts tells how many halves have been
+ * played since the last refill: one is on time, more is an underrun.
+ * After each block the DMA positions tell if it was late (TX already
+ * reading it) or if the input was overwritten (RX already writing it).
+ */
+void task_audio(void * unused)
+{
+	uint32_t events;
+
+	audio_task = xTaskGetCurrentTaskHandle();
+	audio_done_seq = audio_tx_seq;
+
+	for (;;)
+	{
+		xTaskNotifyWait(0, AUDIO_EVT_ALL, &events, portMAX_DELAY);
+
+		if (events & AUDIO_EVT_ERROR)
+		{
+			audio_recover();
+		}
+
+		const uint32_t seq = audio_tx_seq;
+		const uint32_t due = seq - audio_done_seq;
+
+		if (due == 0)
+		{
+			continue;
+		}
+		watchdog_checkin(WATCHDOG_AUDIO);
+
+		// The half the DMA is not reading is the one to write
+		const uint32_t half = audio_dma_half(&hsai_BlockA2) ^ 1;
+
+		if (half == 1 && audio_misaligned >= AUDIO_RESYNC_BLOCKS)
+		{
+			audio_resync();
+		}
+
+		if (due > 1)
+		{
+			audio_stats.underruns += due - 1;
+			audio_conceal(half);
+			LOG_DBG(LOG_MOD_AUDIO, "Underrun, %lu halves missed", due - 1);
+		}
+		else
+		{
+			uint32_t start = profiling_now();
+
+			audio_process(half);
+			for (uint32_t spin = profiling_now(); profiling_now() - spin < audio_stress_cycles; );
+
+			uint32_t cycles = profiling_now() - start;
+
+			if (cycles > audio_stats.max_cycles) audio_stats.max_cycles = cycles;
+			if (audio_dma_half(&hsai_BlockA2) == half) audio_stats.late++;
+			if (audio_dma_half(&hsai_BlockB2) == half) audio_stats.overruns++;
+		}
+
+		audio_misaligned = (audio_dma_half(&hsai_BlockB2) != audio_dma_half(&hsai_BlockA2)) ? audio_misaligned + 1 : 0;
+		audio_stats.blocks++;
+		audio_done_seq = seq;
+
+		audio_meter_publish();
+	}
+}
+
+/**
+ * @brief What replaces a block which missed its deadline.
+ */
+void audio_set_fill(audio_fill_t fill)
+{
+	audio_fill = fill;
+}
+
+audio_fill_t audio_get_fill(void)
+{
+	return audio_fill;
+}
+
+/**
+ * @brief Busy cycles added after each block, to check the deadline handling.
+ */
+void audio_set_stress(uint32_t cycles)
+{
+	audio_stress_cycles = cycles;
+}
+
+void audio_reset_stats(void)
+{
+	taskENTER_CRITICAL();
+	memset(&audio_stats, 0, sizeof(audio_stats));
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Low priority task, hands the mic energy measured by the audio task
+ * over to the loudness estimator every LOUDNESS_PERIOD_MS while it is enabled.
+ */
+void task_loudness(void * unused)
+{
+	TickType_t wake = xTaskGetTickCount();
+
+	for (;;)
+	{
+		while (!audio_loudness.enabled)
+		{
+			// Nothing to estimate: sleeps until enabled
+			sched_wait(SCHED_EVT_LOUDNESS, portMAX_DELAY);
+			wake = xTaskGetTickCount();
+		}
+		vTaskDelayUntil(&wake, LOUDNESS_PERIOD_MS / portTICK_PERIOD_MS);
+
+		taskENTER_CRITICAL();
+		uint64_t energy = audio_loudness.energy;
+		uint32_t samples = audio_loudness.samples;
+		audio_loudness.energy = 0;
+		audio_loudness.samples = 0;
+		taskEXIT_CRITICAL();
+
+		if (audio_loudness.enabled)
+		{
+			loudness_update(&audio_loudness, energy, samples);
+		}
+	}
+}
@@ -0,0 +1,138 @@
+/*
+ * audio.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_AUDIO_H_
+#define AUDIO_AUDIO_H_
+
+#include <stdint.h>
+#include "main.h"
+#include "../utils/mailbox.h"
+
+#include "biquad.h"
+#include "chime.h"
+#include "delay.h"
+#include "dynamics.h"
+#include "graph.h"
+#include "latency.h"
+#include "loudness.h"
+#include "mixer.h"
+#include "rc_filter.h"
+#include "reverb.h"
+#include "siggen.h"
+#include "spectrum.h"
+#include "src.h"
+
+#define AUDIO_SAMPLE_RATE 48000U
+#define AUDIO_CHANNELS 2
+
+/**
+ * Circular DMA buffers (SAI2 block A TX, block B RX), 16-bit samples,
+ * stereo interleaved. Each half is processed while the DMA plays the other one.
+ * The block size (frames per half) is a power of two selected with
+ * audio_set_block_frames(): the DMA buffers and the graph blocks are carved
+ * from a static pool sized for the largest one. Shorter blocks cut the
+ * latency (two blocks) but cost more per frame.
+ */
+#define AUDIO_MIN_BLOCK_FRAMES 32
+#define AUDIO_MAX_BLOCK_FRAMES 1024	// Pool of 28 KB in SRAM1, see DELAY_BUDGET_BYTES
+#define AUDIO_DEFAULT_BLOCK_FRAMES 128	// SAI_BUFFER_LENGTH 512
+#define SAI_BUFFER_LENGTH (2 * AUDIO_CHANNELS * audio_block_frames)	// Samples, both halves
+
+/**
+ * Resampled source: a generator running at 44.1 kHz with its own clock
+ * (optionally off by a few ppm) fills a FIFO, the converter empties it at 48 kHz.
+ */
+#define AUDIO_SRC_RATE 44100U
+#define AUDIO_SRC_FIFO_FRAMES 512
+
+/**
+ * @brief Main source of the output block, the line-in and generator sources
+ * of the mixer are switched accordingly.
+ */
+typedef enum
+{
+	AUDIO_SOURCE_LINE_IN = 0U,	// Codec ADC, copied to the output
+	AUDIO_SOURCE_GENERATOR,		// Test signal generator
+	AUDIO_SOURCE_RESAMPLED		// Generator at 44.1 kHz through the converter
+} audio_source_t;
+
+/**
+ * @brief What is played in place of a block which missed its deadline.
+ */
+typedef enum
+{
+	AUDIO_FILL_SILENCE = 0U,
+	AUDIO_FILL_REPEAT			// The last block computed
+} audio_fill_t;
+
+/**
+ * @brief Deadline and DMA counters of the audio task.
+ */
+typedef struct {
+	uint32_t blocks;			// Halves handled
+	uint32_t late;				// Finished after the TX DMA had started reading them
+	uint32_t underruns;			// Halves played again, the task woke up too late
+	uint32_t overruns;			// Input overwritten by the RX DMA before the end of the block
+	uint32_t sai_errors[2];		// TX, RX
+	uint32_t restarts;			// DMA restarted after an error
+	uint32_t resyncs;			// RX restarted to realign it on TX
+	uint32_t max_cycles;		// Longest block
+} audio_stats_t;
+
+extern audio_stats_t audio_stats;
+extern latency_t audio_latency;
+extern uint32_t audio_block_frames;		// Frames per half
+extern int16_t * rxSAI;
+extern int16_t * txSAI;
+
+extern mailbox_t audio_mailbox;	// Parameter updates applied at the start of a block
+extern graph_t audio_graph;	// Stages run on each block, see audio_init()
+extern mixer_t audio_mixer;	// First stage: line-in, generator and chime sources
+extern chime_t audio_chime;	// Warning chime, ducks the other mixer sources
+extern siggen_t audio_generator;
+extern rc_filter_t audio_rc;	// First order RC filter applied to every block, bypassed by default
+extern biquad_t audio_eq;	// Biquad cascade after the RC filter, bypassed when empty
+extern delay_t audio_delay;	// Echo on the filtered signal, disabled by default
+extern reverb_t audio_reverb;	// Reverb after the echo, disabled by default
+extern loudness_t audio_loudness;	// Noise-adaptive gain and shelves, before the compressor
+extern dynamics_t audio_dynamics;	// Compressor / limiter, last stage, its detector feeds the VU meter
+extern spectrum_t audio_spectrum;	// Capture of the output for the spectrum display
+extern src_t audio_src;	// 44.1 -> 48 kHz converter of the resampled source
+
+void audio_init(void);
+int audio_graph_commit(int status);
+int audio_params_sync(void);
+int audio_set_block_frames(uint32_t frames);
+void audio_set_bypass(int bypass);
+int audio_get_bypass(void);
+int audio_mcu_idle(void);
+int32_t audio_measure_latency(latency_signal_t signal, int32_t simulated);
+int audio_eq_set_stage(uint32_t stage, const biquad_coefs_t * coefs);
+int audio_eq_set_stages(uint32_t stages);
+int audio_eq_set_type(biquad_type_t type);
+int audio_rc_set(rc_mode_t mode, uint32_t cutoff);
+int audio_delay_set_mix(int16_t feedback, int16_t wet, int16_t dry);
+int audio_reverb_set_params(int room, int damping, int wet);
+int audio_dynamics_set(const dynamics_params_t * params);
+HAL_StatusTypeDef audio_start(void);
+void audio_stop(void);
+HAL_StatusTypeDef audio_resume(void);
+void audio_set_source(audio_source_t source);
+audio_source_t audio_get_source(void);
+void audio_set_src_quality(src_quality_t quality);
+void audio_set_src_drift(int32_t ppm);
+int32_t audio_get_src_drift(void);
+uint32_t audio_get_src_fill(void);
+void audio_sai_error(SAI_HandleTypeDef * hsai);
+void audio_set_fill(audio_fill_t fill);
+audio_fill_t audio_get_fill(void);
+void audio_set_stress(uint32_t cycles);
+void audio_reset_stats(void);
+void task_audio(void * unused);
+void task_loudness(void * unused);
+
+#endif /* AUDIO_AUDIO_H_ */
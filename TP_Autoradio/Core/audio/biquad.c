@@ -0,0 +1,390 @@
+/*
+ * biquad.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "biquad.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define BIQUAD_CHUNK 32	// Frames converted to Q31 at a time (on the caller stack)
+#define BIQUAD_ROUND ((int64_t)1 << (BIQUAD_COEF_SHIFT - 1))
+
+static const char * const biquad_type_names[BIQUAD_TYPE_COUNT] = {
+		"df1", "tdf2", "q15"
+};
+
+static const char * const biquad_shape_names[BIQUAD_SHAPE_COUNT] = {
+		"lp", "hp", "bp", "notch", "peak", "ls", "hs"
+};
+
+
+/**
+ * @brief One direct form I section on a Q31 buffer (in place).
+ */
+static ISR_CODE void biquad_df1_q31(const biquad_coefs_t * c, biquad_df1_state_t * s, int32_t * buf, uint32_t frames)
+{
+	const int32_t b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;
+	int32_t x1 = s->x1, x2 = s->x2, y1 = s->y1, y2 = s->y2;
+
+	for (uint32_t n = 0; n < frames; n++)
+	{
+		int32_t x0 = buf[n];
+		int64_t acc = BIQUAD_ROUND;
+
+		acc = dsp_mlal(acc, b0, x0);
+		acc = dsp_mlal(acc, b1, x1);
+		acc = dsp_mlal(acc, b2, x2);
+		acc = dsp_mlal(acc, a1, y1);
+		acc = dsp_mlal(acc, a2, y2);
+
+		x2 = x1;
+		x1 = x0;
+		y2 = y1;
+		y1 = dsp_sat_q31(acc >> BIQUAD_COEF_SHIFT);
+		buf[n] = y1;
+	}
+
+	s->x1 = x1;
+	s->x2 = x2;
+	s->y1 = y1;
+	s->y2 = y2;
+}
+
+/**
+ * @brief One transposed direct form II section on a Q31 buffer (in place).
+ * The two states keep the full 64-bit products, no rounding inside the loop.
+ */
+static ISR_CODE void biquad_tdf2_q31(const biquad_coefs_t * c, biquad_tdf2_state_t * s, int32_t * buf, uint32_t frames)
+{
+	const int32_t b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;
+	int64_t s1 = s->s1, s2 = s->s2;
+
+	for (uint32_t n = 0; n < frames; n++)
+	{
+		int32_t x0 = buf[n];
+		int32_t y0 = dsp_sat_q31(dsp_mlal(s1 + BIQUAD_ROUND, b0, x0) >> BIQUAD_COEF_SHIFT);
+
+		s1 = dsp_mlal(dsp_mlal(s2, b1, x0), a1, y0);
+		s2 = dsp_mlal((int64_t)b2 * x0, a2, y0);
+		buf[n] = y0;
+	}
+
+	s->s1 = s1;
+	s->s2 = s2;
+}
+
+/**
+ * @brief One direct form I section on 16-bit samples (in place, with a stride).
+ * The delayed samples are kept packed by pairs for SMLALD.
+ */
+static ISR_CODE void biquad_df1_q15(const uint32_t * c, biquad_q15_state_t * s, int16_t * buf, uint32_t stride, uint32_t frames)
+{
+	const int32_t b0 = (int32_t)c[0];
+	const uint32_t b12 = c[1], a12 = c[2];
+	uint32_t xs = s->x, ys = s->y;
+
+	for (uint32_t n = 0; n < frames; n++, buf += stride)
+	{
+		int32_t x0 = *buf;
+		int64_t acc = 1 << (BIQUAD_COEF_SHIFT - 16 - 1);
+
+		acc += b0 * x0;
+		acc = dsp_mlald(acc, b12, xs);
+		acc = dsp_mlald(acc, a12, ys);
+
+		int32_t y0 = dsp_sat16((int32_t)(acc >> (BIQUAD_COEF_SHIFT - 16)));
+
+		xs = dsp_pack16(x0, xs);
+		ys = dsp_pack16(y0, ys);
+		*buf = (int16_t)y0;
+	}
+
+	s->x = xs;
+	s->y = ys;
+}
+
+static inline int32_t biquad_q30_to_q14(int32_t c)
+{
+	return dsp_sat16((int32_t)(((int64_t)c + 0x8000) >> 16));
+}
+
+/**
+ * @brief Empty cascade (bypass) of the given type.
+ * @param bq: Cascade.
+ * @param type: Structure and arithmetic, see biquad_type_t.
+ */
+void biquad_init(biquad_t * bq, biquad_type_t type)
+{
+	memset(bq, 0, sizeof(*bq));
+	bq->type = (type < BIQUAD_TYPE_COUNT) ? type : BIQUAD_DF1_Q31;
+}
+
+/**
+ * @brief Changes the structure of the cascade, the states are cleared.
+ */
+void biquad_set_type(biquad_t * bq, biquad_type_t type)
+{
+	if (type < BIQUAD_TYPE_COUNT)
+	{
+		bq->type = type;
+		biquad_reset(bq);
+	}
+}
+
+/**
+ * @brief Clears the states of every channel and stage.
+ */
+void biquad_reset(biquad_t * bq)
+{
+	memset(&bq->state, 0, sizeof(bq->state));
+}
+
+/**
+ * @brief Loads the coefficients of one stage, the cascade grows to include it.
+ * @param bq: Cascade.
+ * @param stage: Stage index (0 to BIQUAD_MAX_STAGES - 1).
+ * @param coefs: Q2.30 coefficients, a1 and a2 negated.
+ * @retval int: 0 on success, -1 if the stage does not exist.
+ */
+int biquad_set_stage(biquad_t * bq, uint32_t stage, const biquad_coefs_t * coefs)
+{
+	if (stage >= BIQUAD_MAX_STAGES)
+	{
+		return -1;
+	}
+
+	bq->coefs[stage] = *coefs;
+	bq->coefs_q15[stage][0] = (uint32_t)biquad_q30_to_q14(coefs->b0);
+	bq->coefs_q15[stage][1] = dsp_pack16(biquad_q30_to_q14(coefs->b1), biquad_q30_to_q14(coefs->b2));
+	bq->coefs_q15[stage][2] = dsp_pack16(biquad_q30_to_q14(coefs->a1), biquad_q30_to_q14(coefs->a2));
+
+	if (stage >= bq->stages)
+	{
+		bq->stages = stage + 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Changes the number of active stages (0 bypasses the cascade).
+ */
+void biquad_set_stages(biquad_t * bq, uint32_t stages)
+{
+	bq->stages = (stages > BIQUAD_MAX_STAGES) ? BIQUAD_MAX_STAGES : stages;
+}
+
+/**
+ * @brief Runs every stage on a contiguous Q31 buffer of one channel (in place).
+ * @param bq: Cascade.
+ * @param channel: Channel owning the states.
+ * @param buffer: Q31 samples.
+ * @param frames: Number of samples.
+ */
+ISR_CODE void biquad_process_channel_q31(biquad_t * bq, uint32_t channel, int32_t * buffer, uint32_t frames)
+{
+	switch (bq->type)
+	{
+	case BIQUAD_DF1_Q31:
+		for (uint32_t s = 0; s < bq->stages; s++)
+		{
+			biquad_df1_q31(&bq->coefs[s], &bq->state.df1[channel][s], buffer, frames);
+		}
+		break;
+
+	case BIQUAD_TDF2_Q31:
+		for (uint32_t s = 0; s < bq->stages; s++)
+		{
+			biquad_tdf2_q31(&bq->coefs[s], &bq->state.tdf2[channel][s], buffer, frames);
+		}
+		break;
+
+	case BIQUAD_DF1_Q15:
+	default:
+	{
+		int16_t chunk[BIQUAD_CHUNK];
+
+		for (uint32_t done = 0; done < frames; done += BIQUAD_CHUNK)
+		{
+			uint32_t n = (frames - done < BIQUAD_CHUNK) ? frames - done : BIQUAD_CHUNK;
+
+			for (uint32_t i = 0; i < n; i++) chunk[i] = dsp_q31_to_q15(buffer[done + i]);
+			for (uint32_t s = 0; s < bq->stages; s++)
+			{
+				biquad_df1_q15(bq->coefs_q15[s], &bq->state.q15[channel][s], chunk, 1, n);
+			}
+			for (uint32_t i = 0; i < n; i++) buffer[done + i] = dsp_q15_to_q31(chunk[i]);
+		}
+		break;
+	}
+	}
+}
+
+/**
+ * @brief Filters one stereo interleaved block in place (one DMA half-buffer).
+ * The Q31 types run the whole cascade in 32 bits and round once at the end.
+ * @param bq: Cascade.
+ * @param block: BIQUAD_CHANNELS * frames samples.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void biquad_process(biquad_t * bq, int16_t * block, uint32_t frames)
+{
+	if (bq->stages == 0)
+	{
+		return;
+	}
+
+	for (uint32_t ch = 0; ch < BIQUAD_CHANNELS; ch++)
+	{
+		if (bq->type == BIQUAD_DF1_Q15)
+		{
+			for (uint32_t s = 0; s < bq->stages; s++)
+			{
+				biquad_df1_q15(bq->coefs_q15[s], &bq->state.q15[ch][s], block + ch, BIQUAD_CHANNELS, frames);
+			}
+			continue;
+		}
+
+		int32_t chunk[BIQUAD_CHUNK];
+
+		for (uint32_t done = 0; done < frames; done += BIQUAD_CHUNK)
+		{
+			uint32_t n = (frames - done < BIQUAD_CHUNK) ? frames - done : BIQUAD_CHUNK;
+			int16_t * samples = block + BIQUAD_CHANNELS * done + ch;
+
+			for (uint32_t i = 0; i < n; i++) chunk[i] = dsp_q15_to_q31(samples[BIQUAD_CHANNELS * i]);
+			biquad_process_channel_q31(bq, ch, chunk, n);
+			for (uint32_t i = 0; i < n; i++) samples[BIQUAD_CHANNELS * i] = dsp_q31_to_q15(chunk[i]);
+		}
+	}
+}
+
+static int biquad_to_q30(float x, int32_t * q)
+{
+	if (x >= 2.0f || x < -2.0f)
+	{
+		return -1;
+	}
+
+	double v = (double)x * (double)(1 << BIQUAD_COEF_SHIFT);
+
+	*q = (v >= (double)INT32_MAX) ? INT32_MAX : (int32_t)lrint(v);
+
+	return 0;
+}
+
+/**
+ * @brief Computes the coefficients of a stage (RBJ audio EQ cookbook), in float:
+ * only called when a parameter changes, never per block.
+ * @param coefs: Result.
+ * @param shape: Filter shape.
+ * @param fs: Sample rate in Hz.
+ * @param f0: Cutoff or center frequency in Hz.
+ * @param q: Quality factor (0.707 for Butterworth low/high-pass).
+ * @param gain_db: Gain of the peak and shelf shapes, ignored otherwise.
+ * @retval int: 0 on success, -1 if a parameter or a coefficient is out of range.
+ */
+int biquad_design(biquad_coefs_t * coefs, biquad_shape_t shape, float fs, float f0, float q, float gain_db)
+{
+	if (f0 <= 0.0f || f0 >= 0.5f * fs || q <= 0.0f)
+	{
+		return -1;
+	}
+
+	float w0 = 2.0f * (float)M_PI * f0 / fs;
+	float cw = cosf(w0);
+	float alpha = sinf(w0) / (2.0f * q);
+	float A = powf(10.0f, gain_db / 40.0f);
+	float sq = 2.0f * sqrtf(A) * alpha;
+	float b0, b1, b2, a0, a1, a2;
+
+	switch (shape)
+	{
+	case BIQUAD_LOWPASS:
+		b0 = (1.0f - cw) / 2.0f; b1 = 1.0f - cw; b2 = b0;
+		a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+		break;
+	case BIQUAD_HIGHPASS:
+		b0 = (1.0f + cw) / 2.0f; b1 = -(1.0f + cw); b2 = b0;
+		a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+		break;
+	case BIQUAD_BANDPASS:
+		b0 = alpha; b1 = 0.0f; b2 = -alpha;
+		a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+		break;
+	case BIQUAD_NOTCH:
+		b0 = 1.0f; b1 = -2.0f * cw; b2 = 1.0f;
+		a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+		break;
+	case BIQUAD_PEAK:
+		b0 = 1.0f + alpha * A; b1 = -2.0f * cw; b2 = 1.0f - alpha * A;
+		a0 = 1.0f + alpha / A; a1 = -2.0f * cw; a2 = 1.0f - alpha / A;
+		break;
+	case BIQUAD_LOWSHELF:
+		b0 = A * ((A + 1.0f) - (A - 1.0f) * cw + sq);
+		b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cw);
+		b2 = A * ((A + 1.0f) - (A - 1.0f) * cw - sq);
+		a0 = (A + 1.0f) + (A - 1.0f) * cw + sq;
+		a1 = -2.0f * ((A - 1.0f) + (A + 1.0f) * cw);
+		a2 = (A + 1.0f) + (A - 1.0f) * cw - sq;
+		break;
+	case BIQUAD_HIGHSHELF:
+		b0 = A * ((A + 1.0f) + (A - 1.0f) * cw + sq);
+		b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cw);
+		b2 = A * ((A + 1.0f) + (A - 1.0f) * cw - sq);
+		a0 = (A + 1.0f) - (A - 1.0f) * cw + sq;
+		a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cw);
+		a2 = (A + 1.0f) - (A - 1.0f) * cw - sq;
+		break;
+	default:
+		return -1;
+	}
+
+	// Normalized by a0, feedback coefficients negated
+	if (biquad_to_q30(b0 / a0, &coefs->b0) || biquad_to_q30(b1 / a0, &coefs->b1)
+			|| biquad_to_q30(b2 / a0, &coefs->b2) || biquad_to_q30(-a1 / a0, &coefs->a1)
+			|| biquad_to_q30(-a2 / a0, &coefs->a2))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int biquad_type_from_name(const char * name)
+{
+	for (int i = 0; i < BIQUAD_TYPE_COUNT; i++)
+	{
+		if (strcmp(name, biquad_type_names[i]) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int biquad_shape_from_name(const char * name)
+{
+	for (int i = 0; i < BIQUAD_SHAPE_COUNT; i++)
+	{
+		if (strcmp(name, biquad_shape_names[i]) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * biquad_type_name(biquad_type_t type)
+{
+	return (type < BIQUAD_TYPE_COUNT) ? biquad_type_names[type] : "?";
+}
@@ -0,0 +1,89 @@
+/*
+ * biquad.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_BIQUAD_H_
+#define AUDIO_BIQUAD_H_
+
+#include <stdint.h>
+
+#define BIQUAD_MAX_STAGES 6
+#define BIQUAD_CHANNELS 2		// Stereo interleaved blocks
+#define BIQUAD_COEF_SHIFT 30	// Coefficients in Q2.30, range [-2, 2)
+
+/**
+ * @brief Structure and arithmetic of the cascade.
+ */
+typedef enum
+{
+	BIQUAD_DF1_Q31 = 0U,	// Direct form I, 32-bit data, 64-bit accumulator (SMLAL)
+	BIQUAD_TDF2_Q31,		// Transposed direct form II, 64-bit states (SMLAL)
+	BIQUAD_DF1_Q15,			// Direct form I, 16-bit data, dual MAC (SMLALD), cheapest
+	BIQUAD_TYPE_COUNT
+} biquad_type_t;
+
+/**
+ * @brief Shapes of biquad_design() (RBJ audio EQ cookbook).
+ */
+typedef enum
+{
+	BIQUAD_LOWPASS = 0U,
+	BIQUAD_HIGHPASS,
+	BIQUAD_BANDPASS,
+	BIQUAD_NOTCH,
+	BIQUAD_PEAK,
+	BIQUAD_LOWSHELF,
+	BIQUAD_HIGHSHELF,
+	BIQUAD_SHAPE_COUNT
+} biquad_shape_t;
+
+/**
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]
+ * a1 and a2 are stored negated (a0 = 1), so that every term is accumulated.
+ */
+typedef struct {
+	int32_t b0, b1, b2, a1, a2;	// Q2.30
+} biquad_coefs_t;
+
+typedef struct {
+	int32_t x1, x2, y1, y2;
+} biquad_df1_state_t;
+
+typedef struct {
+	int64_t s1, s2;				// Q2.61
+} biquad_tdf2_state_t;
+
+typedef struct {
+	uint32_t x;					// x[n-1] | x[n-2] << 16
+	uint32_t y;					// y[n-1] | y[n-2] << 16
+} biquad_q15_state_t;
+
+typedef struct {
+	biquad_type_t type;
+	uint32_t stages;			// 0: bypass
+	biquad_coefs_t coefs[BIQUAD_MAX_STAGES];
+	uint32_t coefs_q15[BIQUAD_MAX_STAGES][3];	// Q2.14 {b0, b1 | b2, a1 | a2} for SMLALD
+	union {
+		biquad_df1_state_t df1[BIQUAD_CHANNELS][BIQUAD_MAX_STAGES];
+		biquad_tdf2_state_t tdf2[BIQUAD_CHANNELS][BIQUAD_MAX_STAGES];
+		biquad_q15_state_t q15[BIQUAD_CHANNELS][BIQUAD_MAX_STAGES];
+	} state;
+} biquad_t;
+
+void biquad_init(biquad_t * bq, biquad_type_t type);
+void biquad_set_type(biquad_t * bq, biquad_type_t type);
+void biquad_reset(biquad_t * bq);
+int biquad_set_stage(biquad_t * bq, uint32_t stage, const biquad_coefs_t * coefs);
+void biquad_set_stages(biquad_t * bq, uint32_t stages);
+void biquad_process(biquad_t * bq, int16_t * block, uint32_t frames);
+void biquad_process_channel_q31(biquad_t * bq, uint32_t channel, int32_t * buffer, uint32_t frames);
+
+int biquad_design(biquad_coefs_t * coefs, biquad_shape_t shape, float fs, float f0, float q, float gain_db);
+int biquad_type_from_name(const char * name);
+int biquad_shape_from_name(const char * name);
+const char * biquad_type_name(biquad_type_t type);
+
+#endif /* AUDIO_BIQUAD_H_ */
@@ -0,0 +1,92 @@
+/*
+ * chime.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "chime.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define CHIME_ONE (1 << 30)
+
+
+/**
+ * @brief Silent, -6 dBFS.
+ */
+void chime_init(chime_t * ch, uint32_t sample_rate)
+{
+	memset(ch, 0, sizeof(*ch));
+
+	ch->sample_rate = sample_rate;
+	ch->amplitude = 16384;
+}
+
+/**
+ * @brief Starts a chime at the next block, a chime still playing is restarted.
+ * @param ch: Chime.
+ * @param frequency: Pitch in Hz.
+ * @param ms: Time to decay to -60 dB, it stops there.
+ */
+void chime_play(chime_t * ch, float frequency, uint32_t ms)
+{
+	uint32_t length = ms * ch->sample_rate / 1000U;
+
+	if (length == 0)
+	{
+		return;
+	}
+
+	ch->next.phase_inc = (uint32_t)((double)frequency * 4294967296.0 / ch->sample_rate);
+	ch->next.decay = (int32_t)(powf(10.0f, -3.0f / (float)length) * CHIME_ONE);
+	ch->next.length = length;
+	__atomic_signal_fence(__ATOMIC_RELEASE);	// 'next' written before the flag
+	ch->trigger = 1;
+}
+
+/**
+ * @brief Mixer source, see mixer_fill_t.
+ */
+ISR_CODE int chime_fill(void * ctx, int16_t * block, uint32_t frames)
+{
+	chime_t * ch = ctx;
+
+	if (ch->trigger)
+	{
+		__atomic_signal_fence(__ATOMIC_ACQUIRE);
+		ch->phase = 0;
+		ch->phase_inc = ch->next.phase_inc;
+		ch->decay = ch->next.decay;
+		ch->remaining = ch->next.length;
+		ch->envelope = CHIME_ONE;
+		ch->trigger = 0;
+	}
+
+	if (ch->remaining == 0)
+	{
+		return 0;
+	}
+
+	for (uint32_t n = 0; n < frames; n++)
+	{
+		int32_t level = (int32_t)(((int64_t)ch->envelope * ch->amplitude) >> 30);
+		int16_t v = 0;
+
+		if (ch->remaining > 0)
+		{
+			v = (int16_t)((sine_q15[ch->phase >> (32 - SINE_TABLE_BITS)] * level) >> 15);
+			ch->phase += ch->phase_inc;
+			ch->envelope = (int32_t)(((int64_t)ch->envelope * ch->decay) >> 30);
+			ch->remaining--;
+		}
+		block[2*n] = v;
+		block[2*n + 1] = v;
+	}
+
+	return 1;
+}
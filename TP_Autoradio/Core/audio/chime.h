@@ -0,0 +1,37 @@
+/*
+ * chime.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_CHIME_H_
+#define AUDIO_CHIME_H_
+
+#include <stdint.h>
+
+/**
+ * Warning chime: a sine with an exponential decay to -60 dB, started from a
+ * task with chime_play() and rendered by the audio task as a mixer source.
+ */
+typedef struct {
+	uint32_t sample_rate;
+	uint32_t phase;
+	uint32_t phase_inc;
+	int32_t envelope;		// Q30
+	int32_t decay;			// Q30, factor per sample
+	uint32_t remaining;		// Frames
+	int16_t amplitude;		// Q15
+	struct {
+		uint32_t phase_inc;
+		int32_t decay;
+		uint32_t length;
+	} next;					// Written by chime_play(), started by the audio task
+	volatile uint8_t trigger;
+} chime_t;
+
+void chime_init(chime_t * ch, uint32_t sample_rate);
+void chime_play(chime_t * ch, float frequency, uint32_t ms);
+int chime_fill(void * ctx, int16_t * block, uint32_t frames);
+
+#endif /* AUDIO_CHIME_H_ */
@@ -0,0 +1,150 @@
+/*
+ * delay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "delay.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define DELAY_DEFAULT_MS 80.0f			// Fits the 4096 frames line (85 ms at 48 kHz)
+
+
+/**
+ * @brief Attaches a line to the effect, disabled, 80 ms / 40 % feedback / 30 % wet.
+ * A line too short for DELAY_DEFAULT_MS starts at the longest delay it holds.
+ * @param dl: Effect.
+ * @param line: DELAY_CHANNELS * length samples, see DELAY_MEM for its placement.
+ * @param length: Frames, must be a power of two.
+ * @param sample_rate: Sample rate in Hz.
+ * @retval int: 0 on success, -1 if the length is not a power of two.
+ */
+int delay_init(delay_t * dl, int16_t * line, uint32_t length, uint32_t sample_rate)
+{
+	if (length < 4 || (length & (length - 1)) != 0)
+	{
+		return -1;
+	}
+
+	memset(dl, 0, sizeof(*dl));
+	dl->line = line;
+	dl->mask = length - 1;
+	dl->sample_rate = sample_rate;
+	delay_set_mix(dl, 13107, 9830, 32767);
+	if (delay_set_time(dl, DELAY_DEFAULT_MS) != 0)
+	{
+		dl->delay_target = (dl->mask - 1) << 16;
+	}
+	dl->delay = dl->delay_target;
+	delay_clear(dl);
+
+	return 0;
+}
+
+void delay_clear(delay_t * dl)
+{
+	memset(dl->line, 0, DELAY_CHANNELS * (dl->mask + 1) * sizeof(int16_t));
+}
+
+/**
+ * @brief Enables or bypasses the effect. The line is cleared before being
+ * enabled (the audio task does not touch it while bypassed), so that no old echo comes back.
+ */
+void delay_enable(delay_t * dl, int enable)
+{
+	if (enable && !dl->enabled)
+	{
+		delay_clear(dl);
+		dl->delay = dl->delay_target;
+	}
+	dl->enabled = (enable != 0);
+}
+
+/**
+ * @brief Changes the delay, it glides over the next block (no click, short pitch bend).
+ * @param dl: Effect.
+ * @param ms: Delay in milliseconds, fractional values allowed.
+ * @retval int: 0 on success, -1 if the line is too short or the delay below 1 frame.
+ */
+int delay_set_time(delay_t * dl, float ms)
+{
+	float frames = ms * (float)dl->sample_rate / 1000.0f;
+
+	if (frames < 1.0f || frames > (float)(dl->mask - 1))
+	{
+		return -1;
+	}
+
+	dl->delay_target = (uint32_t)(frames * 65536.0f);
+
+	return 0;
+}
+
+float delay_get_time(const delay_t * dl)
+{
+	return (float)dl->delay_target / 65536.0f * 1000.0f / (float)dl->sample_rate;
+}
+
+/**
+ * @brief Feedback and wet/dry levels, Q15 (feedback is limited to 0.95).
+ */
+void delay_set_mix(delay_t * dl, int16_t feedback, int16_t wet, int16_t dry)
+{
+	dl->feedback = (feedback > 31130) ? 31130 : (feedback < -31130) ? -31130 : feedback;
+	dl->wet = wet;
+	dl->dry = dry;
+}
+
+/**
+ * @brief Applies the echo to one stereo interleaved block in place.
+ * No branch in the loop: the read and write positions wrap with the mask,
+ * the delay glides linearly to its target and the outputs saturate (SSAT).
+ * @param dl: Effect.
+ * @param block: DELAY_CHANNELS * frames samples.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void delay_process(delay_t * dl, int16_t * block, uint32_t frames)
+{
+	if (!dl->enabled)
+	{
+		return;
+	}
+
+	int16_t * const line = dl->line;
+	const uint32_t mask = dl->mask;
+	const int32_t feedback = dl->feedback, wet = dl->wet, dry = dl->dry;
+	const uint32_t target = dl->delay_target;
+	uint32_t delay = dl->delay;
+	int32_t step = ((int32_t)target - (int32_t)delay) / (int32_t)frames;
+	uint32_t write = dl->write;
+
+	for (uint32_t n = 0; n < frames; n++, block += DELAY_CHANNELS)
+	{
+		delay += step;
+
+		uint32_t newer = (write - (delay >> 16)) & mask;
+		uint32_t older = (newer - 1) & mask;
+		int32_t frac = (delay & 0xFFFF) >> 1;	// Q15
+
+		for (uint32_t ch = 0; ch < DELAY_CHANNELS; ch++)
+		{
+			int32_t x = block[ch];
+			int32_t a = line[DELAY_CHANNELS * newer + ch];
+			int32_t b = line[DELAY_CHANNELS * older + ch];
+			int32_t echo = a + (((b - a) * frac) >> 15);
+
+			line[DELAY_CHANNELS * write + ch] = (int16_t)dsp_sat16(x + ((feedback * echo) >> 15));
+			block[ch] = (int16_t)dsp_sat16((dry * x + wet * echo) >> 15);
+		}
+
+		write = (write + 1) & mask;
+	}
+
+	dl->write = write;
+	dl->delay = target;
+}
@@ -0,0 +1,62 @@
+/*
+ * delay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_DELAY_H_
+#define AUDIO_DELAY_H_
+
+#include <stdint.h>
+
+#define DELAY_CHANNELS 2				// Stereo interleaved lines
+
+/**
+ * Allocation budget of the echo line, its length is the largest power of two
+ * of stereo frames fitting in it (16 KB: 4096 frames, 85 ms at 48 kHz). SRAM1
+ * is shared with the audio block pool, sized for AUDIO_MAX_BLOCK_FRAMES.
+ * DELAY_IN_RAM2 moves it to SRAM2 (budget <= 16 KB, the stacks live there too).
+ */
+#define DELAY_BUDGET_BYTES (16 * 1024)
+#define DELAY_IN_RAM2 0
+
+#define DELAY_BUDGET_FRAMES (DELAY_BUDGET_BYTES / (DELAY_CHANNELS * sizeof(int16_t)))
+#define DELAY_POW2_FLOOR(n) \
+	((n) >= 65536 ? 65536 : (n) >= 32768 ? 32768 : (n) >= 16384 ? 16384 : \
+	 (n) >= 8192 ? 8192 : (n) >= 4096 ? 4096 : (n) >= 2048 ? 2048 : \
+	 (n) >= 1024 ? 1024 : (n) >= 512 ? 512 : 256)
+#define DELAY_LENGTH DELAY_POW2_FLOOR(DELAY_BUDGET_FRAMES)	// Frames
+
+#if (DELAY_IN_RAM2)
+#define DELAY_MEM RAM2
+#else
+#define DELAY_MEM RAM
+#endif
+
+/**
+ * y = dry * x + wet * line(t - d), line(t) = x + feedback * line(t - d)
+ * The delay d is fractional (Q16.16 frames), read with a linear interpolation.
+ */
+typedef struct {
+	int16_t * line;					// DELAY_CHANNELS * length samples
+	uint32_t mask;					// length - 1, length is a power of two
+	uint32_t write;					// Next frame written
+	uint32_t sample_rate;
+	uint32_t delay;					// Q16.16 frames, reached at the end of the previous block
+	volatile uint32_t delay_target;
+	volatile int32_t feedback;		// Q15
+	volatile int32_t wet;			// Q15
+	volatile int32_t dry;			// Q15
+	volatile uint8_t enabled;
+} delay_t;
+
+int delay_init(delay_t * dl, int16_t * line, uint32_t length, uint32_t sample_rate);
+void delay_clear(delay_t * dl);
+void delay_enable(delay_t * dl, int enable);
+int delay_set_time(delay_t * dl, float ms);
+float delay_get_time(const delay_t * dl);
+void delay_set_mix(delay_t * dl, int16_t feedback, int16_t wet, int16_t dry);
+void delay_process(delay_t * dl, int16_t * block, uint32_t frames);
+
+#endif /* AUDIO_DELAY_H_ */
@@ -0,0 +1,134 @@
+/*
+ * dsp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_DSP_H_
+#define AUDIO_DSP_H_
+
+#include <stdint.h>
+
+/**
+ * Fixed-point primitives shared by the audio stages.
+ * On the Cortex-M4 they map to the DSP extension (SMLAL, SMLALD, SSAT, PKHBT,
+ * QADD16...), elsewhere (host builds) to portable C with the same results.
+ */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "main.h"
+#define DSP_USE_INTRINSICS 1
+#else
+#define DSP_USE_INTRINSICS 0
+#endif
+
+#define DSP_Q15_ONE 32768
+#define DSP_Q31_MAX INT32_MAX
+#define DSP_Q31_MIN INT32_MIN
+
+/**
+ * @brief 64-bit multiply-accumulate: acc + a * b (SMLAL).
+ */
+static inline int64_t dsp_mlal(int64_t acc, int32_t a, int32_t b)
+{
+	return acc + (int64_t)a * b;	// GCC emits SMLAL
+}
+
+/**
+ * @brief Dual 16-bit multiply-accumulate into 64 bits: acc + x.lo * y.lo + x.hi * y.hi (SMLALD).
+ */
+static inline int64_t dsp_mlald(int64_t acc, uint32_t x, uint32_t y)
+{
+#if (DSP_USE_INTRINSICS)
+	return (int64_t)__SMLALD(x, y, (uint64_t)acc);
+#else
+	return acc + (int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+/**
+ * @brief Dual 16-bit multiply-accumulate into 32 bits (SMLAD).
+ */
+static inline int32_t dsp_mlad(int32_t acc, uint32_t x, uint32_t y)
+{
+#if (DSP_USE_INTRINSICS)
+	return (int32_t)__SMLAD(x, y, (uint32_t)acc);
+#else
+	return acc + (int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+/**
+ * @brief Packs two 16-bit values in a word: lo in bits 0-15, hi in bits 16-31 (PKHBT).
+ */
+static inline uint32_t dsp_pack16(int32_t lo, int32_t hi)
+{
+#if (DSP_USE_INTRINSICS)
+	return __PKHBT(lo, hi, 16);
+#else
+	return ((uint32_t)lo & 0xFFFFU) | ((uint32_t)hi << 16);
+#endif
+}
+
+/**
+ * @brief Dual 16-bit saturating addition: x.lo + y.lo, x.hi + y.hi (QADD16).
+ */
+static inline uint32_t dsp_qadd16(uint32_t x, uint32_t y)
+{
+#if (DSP_USE_INTRINSICS)
+	return __QADD16(x, y);
+#else
+	int32_t lo = (int32_t)(int16_t)x + (int16_t)y;
+	int32_t hi = (int32_t)(int16_t)(x >> 16) + (int16_t)(y >> 16);
+
+	lo = (lo > INT16_MAX) ? INT16_MAX : (lo < INT16_MIN) ? INT16_MIN : lo;
+	hi = (hi > INT16_MAX) ? INT16_MAX : (hi < INT16_MIN) ? INT16_MIN : hi;
+	return ((uint32_t)lo & 0xFFFFU) | ((uint32_t)hi << 16);
+#endif
+}
+
+/**
+ * @brief Saturates to the int16_t range (SSAT #16).
+ */
+static inline int32_t dsp_sat16(int32_t x)
+{
+#if (DSP_USE_INTRINSICS)
+	return __SSAT(x, 16);
+#else
+	return (x > INT16_MAX) ? INT16_MAX : (x < INT16_MIN) ? INT16_MIN : x;
+#endif
+}
+
+/**
+ * @brief Saturates a 64-bit accumulator to Q31.
+ */
+static inline int32_t dsp_sat_q31(int64_t x)
+{
+	return (x > DSP_Q31_MAX) ? DSP_Q31_MAX : (x < DSP_Q31_MIN) ? DSP_Q31_MIN : (int32_t)x;
+}
+
+/**
+ * @brief Q15 sample to Q31.
+ */
+static inline int32_t dsp_q15_to_q31(int16_t x)
+{
+	return (int32_t)x << 16;
+}
+
+/**
+ * @brief Q31 to Q15, rounded and saturated.
+ */
+static inline int16_t dsp_q31_to_q15(int32_t x)
+{
+	return (int16_t)dsp_sat16((int32_t)(((int64_t)x + 0x8000) >> 16));
+}
+
+/**
+ * @brief Q15 multiplication, result saturated.
+ */
+static inline int16_t dsp_mul_q15(int16_t a, int16_t b)
+{
+	return (int16_t)dsp_sat16(((int32_t)a * b) >> 15);
+}
+
+#endif /* AUDIO_DSP_H_ */
@@ -0,0 +1,236 @@
+/*
+ * dynamics.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "dynamics.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+
+/**
+ * @brief Static curve: gain reduction for a given input level, quadratic in the knee.
+ * @param level: Input level in Q8 dB.
+ * @retval int32_t: Gain in Q8 dB, <= 0.
+ */
+static ISR_CODE int32_t dynamics_curve(const dynamics_t * dyn, int32_t level)
+{
+	const int32_t slope = dyn->slope, knee = dyn->knee;
+	int32_t over = level - dyn->threshold;
+
+	if (2 * over <= -knee)
+	{
+		return 0;
+	}
+	if (2 * over >= knee)
+	{
+		return -(int32_t)(((int64_t)over * slope) >> 15);
+	}
+
+	int64_t x = over + knee / 2;
+
+	return -(int32_t)(((x * x * slope) >> 15) / (2 * knee));
+}
+
+/**
+ * @brief Disabled, -12 dB threshold, 4:1, 5 ms / 200 ms, 6 dB knee, no look-ahead.
+ * @param dyn: Stage.
+ * @param sample_rate: Sample rate in Hz.
+ * @param block_frames: Frames per dynamics_process() call, sets the detector ballistics.
+ */
+void dynamics_init(dynamics_t * dyn, uint32_t sample_rate, uint32_t block_frames)
+{
+	memset(dyn, 0, sizeof(*dyn));
+
+	dyn->sample_rate = sample_rate;
+	dyn->block_frames = block_frames;
+	dyn->gain = LEVEL_GAIN_ONE;
+	level_follower_init(&dyn->detector);
+	dynamics_set_threshold(dyn, -12.0f);
+	dynamics_set_ratio(dyn, 4.0f);
+	dynamics_set_times(dyn, 5.0f, 200.0f);
+	dynamics_set_knee(dyn, 6.0f);
+}
+
+/**
+ * @brief New block size: the detector ballistics are recomputed, the
+ * look-ahead line and the gain cleared. Not to be called while
+ * dynamics_process() runs.
+ */
+void dynamics_set_block(dynamics_t * dyn, uint32_t block_frames)
+{
+	dyn->block_frames = block_frames;
+	dynamics_set_times(dyn, dyn->attack_ms, dyn->release_ms);
+	memset(dyn->line, 0, sizeof(dyn->line));
+	dyn->gain = LEVEL_GAIN_ONE;
+	dyn->reduction = 0;
+}
+
+/**
+ * @brief Enables or bypasses the stage, the look-ahead line is cleared first.
+ * The detector keeps running while bypassed, for the VU meter.
+ */
+void dynamics_enable(dynamics_t * dyn, int enable)
+{
+	if (enable && !dyn->enabled)
+	{
+		memset(dyn->line, 0, sizeof(dyn->line));
+		dyn->gain = LEVEL_GAIN_ONE;
+	}
+	dyn->enabled = (enable != 0);
+	dyn->reduction = 0;
+}
+
+void dynamics_set_threshold(dynamics_t * dyn, float db)
+{
+	dyn->threshold = (int32_t)(db * 256.0f);
+}
+
+/**
+ * @brief Compression ratio, 1 (no effect) to DYN_RATIO_MAX, infinite above (limiter).
+ */
+void dynamics_set_ratio(dynamics_t * dyn, float ratio)
+{
+	if (ratio < 1.0f) ratio = 1.0f;
+
+	dyn->ratio = ratio;
+	dyn->slope = (ratio > DYN_RATIO_MAX) ? 32768 : (int32_t)(32768.0f * (1.0f - 1.0f / ratio));
+}
+
+/**
+ * @brief Envelope time constants, shorter than a block means instantaneous.
+ */
+void dynamics_set_times(dynamics_t * dyn, float attack_ms, float release_ms)
+{
+	float block_ms = 1000.0f * (float)dyn->block_frames / (float)dyn->sample_rate;
+
+	dyn->attack_ms = (attack_ms < 0.0f) ? 0.0f : attack_ms;
+	dyn->release_ms = (release_ms < 0.0f) ? 0.0f : release_ms;
+	level_follower_set_times(&dyn->detector, dyn->attack_ms, dyn->release_ms, block_ms);
+}
+
+void dynamics_set_knee(dynamics_t * dyn, float db)
+{
+	dyn->knee = (db < 0.0f) ? 0 : (int32_t)(db * 256.0f);
+}
+
+/**
+ * @brief Gain added after the compression, clamped to 0..DYN_MAKEUP_MAX dB.
+ */
+void dynamics_set_makeup(dynamics_t * dyn, float db)
+{
+	db = (db < 0.0f) ? 0.0f : (db > DYN_MAKEUP_MAX) ? DYN_MAKEUP_MAX : db;
+	dyn->makeup = (int32_t)(db * 256.0f);
+}
+
+/**
+ * @brief Look-ahead delay, the audio is delayed and the detector is not.
+ * @retval int: 0 on success, -1 if longer than the line.
+ */
+int dynamics_set_lookahead(dynamics_t * dyn, float ms)
+{
+	float frames = ms * (float)dyn->sample_rate / 1000.0f;
+
+	if (frames < 0.0f || frames > (float)(DYN_LOOKAHEAD_LENGTH - 1))
+	{
+		return -1;
+	}
+
+	dyn->lookahead = (uint32_t)(frames + 0.5f);
+
+	return 0;
+}
+
+float dynamics_get_lookahead(const dynamics_t * dyn)
+{
+	return (float)dyn->lookahead * 1000.0f / (float)dyn->sample_rate;
+}
+
+/**
+ * @brief Longest look-ahead the line holds, in milliseconds.
+ */
+float dynamics_max_lookahead(const dynamics_t * dyn)
+{
+	return (float)(DYN_LOOKAHEAD_LENGTH - 1) * 1000.0f / (float)dyn->sample_rate;
+}
+
+/**
+ * @brief Every control at once, for the audio task between two blocks.
+ * @retval int: 0 on success, -1 if the look-ahead is longer than the line
+ * (nothing changed then).
+ */
+int dynamics_set_params(dynamics_t * dyn, const dynamics_params_t * params)
+{
+	if (dynamics_set_lookahead(dyn, params->lookahead_ms) != 0)
+	{
+		return -1;
+	}
+
+	dynamics_set_threshold(dyn, params->threshold);
+	dynamics_set_ratio(dyn, params->ratio);
+	dynamics_set_times(dyn, params->attack_ms, params->release_ms);
+	dynamics_set_knee(dyn, params->knee);
+	dynamics_set_makeup(dyn, params->makeup);
+
+	return 0;
+}
+
+/**
+ * @brief Current controls, to change some of them with dynamics_set_params().
+ */
+void dynamics_get_params(const dynamics_t * dyn, dynamics_params_t * params)
+{
+	params->threshold = (float)dyn->threshold / 256.0f;
+	params->ratio = dyn->ratio;
+	params->attack_ms = dyn->attack_ms;
+	params->release_ms = dyn->release_ms;
+	params->knee = (float)dyn->knee / 256.0f;
+	params->makeup = (float)dyn->makeup / 256.0f;
+	params->lookahead_ms = dynamics_get_lookahead(dyn);
+}
+
+/**
+ * @brief Compresses one stereo interleaved block in place.
+ * @param dyn: Stage.
+ * @param block: DYN_CHANNELS * frames samples.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void dynamics_process(dynamics_t * dyn, int16_t * block, uint32_t frames)
+{
+	level_follower_update(&dyn->detector, block, frames);
+
+	if (!dyn->enabled)
+	{
+		return;
+	}
+
+	const int32_t reduction = dynamics_curve(dyn, level_follower_linked(&dyn->detector));
+	const uint32_t target = level_db_to_gain(reduction + dyn->makeup);
+	const uint32_t mask = DYN_LOOKAHEAD_LENGTH - 1;
+	const uint32_t lookahead = dyn->lookahead;
+	int16_t * const line = dyn->line;
+	int32_t gain = (int32_t)dyn->gain;
+	int32_t step = ((int32_t)target - gain) / (int32_t)frames;
+	uint32_t write = dyn->write;
+
+	for (uint32_t n = 0; n < frames; n++, block += DYN_CHANNELS)
+	{
+		uint32_t read = (write - lookahead) & mask;
+
+		gain += step;
+		line[DYN_CHANNELS * write] = block[0];
+		line[DYN_CHANNELS * write + 1] = block[1];
+		block[0] = (int16_t)dsp_sat16((int32_t)(((int64_t)line[DYN_CHANNELS * read] * gain) >> 16));
+		block[1] = (int16_t)dsp_sat16((int32_t)(((int64_t)line[DYN_CHANNELS * read + 1] * gain) >> 16));
+		write = (write + 1) & mask;
+	}
+
+	dyn->write = write;
+	dyn->gain = target;
+	dyn->reduction = reduction;
+}
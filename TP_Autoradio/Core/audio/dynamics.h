@@ -0,0 +1,81 @@
+/*
+ * dynamics.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_DYNAMICS_H_
+#define AUDIO_DYNAMICS_H_
+
+#include <stdint.h>
+
+#include "level.h"
+
+/**
+ * Stereo-linked compressor / limiter.
+ * The gain computer runs once per block on the envelope of the louder channel
+ * (soft knee, Q8 dB), the gain then moves linearly sample by sample towards
+ * its new value. The optional look-ahead delays the audio so that the gain
+ * has already come down when a peak reaches the output: one block of
+ * look-ahead with a null attack makes a peak limiter.
+ * The line is not sized for the largest blocks (AUDIO_MAX_BLOCK_FRAMES): it
+ * is in SRAM2, and 1024 frames of look-ahead would need an 8 KB line. Up to
+ * DYN_LOOKAHEAD_LENGTH - 1 frames per block the limiter is exact. Above, the
+ * look-ahead is clamped to the line, and a peak in the first frames of a
+ * block (block - look-ahead) leaves with the gain only partly down: the
+ * output may overshoot the threshold, smaller blocks for a strict ceiling.
+ */
+#define DYN_CHANNELS 2
+#define DYN_LOOKAHEAD_LENGTH 256	// Frames, power of two: 255 frames (5.3 ms at 48 kHz) of look-ahead at most
+#define DYN_RATIO_MAX 50.0f			// Ratios above are treated as infinite (limiter)
+#define DYN_MAKEUP_MAX 24.0f		// dB
+
+/**
+ * Every control at once, to change a whole setting between two blocks.
+ */
+typedef struct {
+	float threshold;				// dB
+	float ratio;
+	float attack_ms;
+	float release_ms;
+	float knee;						// dB
+	float makeup;					// dB
+	float lookahead_ms;
+} dynamics_params_t;
+
+typedef struct {
+	level_follower_t detector;		// Envelope of the input, also read by the VU meter
+	int16_t line[DYN_CHANNELS * DYN_LOOKAHEAD_LENGTH];
+	uint32_t write;
+	uint32_t sample_rate;
+	uint32_t block_frames;			// Detector update period
+	volatile uint32_t lookahead;	// Frames
+	volatile int32_t threshold;		// Q8 dB
+	volatile int32_t slope;			// Q15, 1 - 1 / ratio
+	volatile int32_t knee;			// Q8 dB, total width
+	volatile int32_t makeup;		// Q8 dB
+	uint32_t gain;					// Q16, reached at the end of the last block
+	volatile int32_t reduction;		// Q8 dB, last gain reduction (<= 0)
+	float ratio;
+	float attack_ms;
+	float release_ms;
+	volatile uint8_t enabled;
+} dynamics_t;
+
+void dynamics_init(dynamics_t * dyn, uint32_t sample_rate, uint32_t block_frames);
+void dynamics_set_block(dynamics_t * dyn, uint32_t block_frames);
+void dynamics_enable(dynamics_t * dyn, int enable);
+void dynamics_set_threshold(dynamics_t * dyn, float db);
+void dynamics_set_ratio(dynamics_t * dyn, float ratio);
+void dynamics_set_times(dynamics_t * dyn, float attack_ms, float release_ms);
+void dynamics_set_knee(dynamics_t * dyn, float db);
+void dynamics_set_makeup(dynamics_t * dyn, float db);
+int dynamics_set_lookahead(dynamics_t * dyn, float ms);
+float dynamics_get_lookahead(const dynamics_t * dyn);
+float dynamics_max_lookahead(const dynamics_t * dyn);
+int dynamics_set_params(dynamics_t * dyn, const dynamics_params_t * params);
+void dynamics_get_params(const dynamics_t * dyn, dynamics_params_t * params);
+void dynamics_process(dynamics_t * dyn, int16_t * block, uint32_t frames);
+
+#endif /* AUDIO_DYNAMICS_H_ */
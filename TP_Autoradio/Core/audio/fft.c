@@ -0,0 +1,149 @@
+/*
+ * fft.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "fft.h"
+
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define FFT_COS(i) sine_q15[((i) + SINE_TABLE_SIZE / 4) & (SINE_TABLE_SIZE - 1)]
+#define FFT_SIN(i) sine_q15[(i) & (SINE_TABLE_SIZE - 1)]
+
+
+/**
+ * @brief Tells if n is a supported real FFT size.
+ */
+int fft_valid_size(uint32_t n)
+{
+	uint32_t m = n / 2;
+
+	if (n < 8 || n > FFT_MAX_SIZE || (m & (m - 1)) != 0)
+	{
+		return 0;
+	}
+
+	return (m & 0x55555555U) != 0;	// Power of 4: the single bit is at an even position
+}
+
+/**
+ * @brief Radix-4 decimation in frequency, complex, in place, output in base 4 digit reversed order.
+ * Every stage divides by 4, so the result is scaled by 1/m and never overflows.
+ * @param x: m complex values, re/im interleaved, Q15 range.
+ * @param m: Number of points, a power of 4.
+ * @param step: Sine table stride of W_m.
+ */
+static ISR_CODE void fft_radix4(int32_t * x, uint32_t m, uint32_t step)
+{
+	for (uint32_t n2 = m; n2 > 1; n2 >>= 2, step <<= 2)
+	{
+		const uint32_t n1 = n2 >> 2;
+
+		for (uint32_t j = 0; j < n1; j++)
+		{
+			const int32_t c1 = FFT_COS(j * step), s1 = FFT_SIN(j * step);
+			const int32_t c2 = FFT_COS(2 * j * step), s2 = FFT_SIN(2 * j * step);
+			const int32_t c3 = FFT_COS(3 * j * step), s3 = FFT_SIN(3 * j * step);
+
+			for (uint32_t i = j; i < m; i += n2)
+			{
+				int32_t * a = &x[2 * i];
+				int32_t * b = &x[2 * (i + n1)];
+				int32_t * c = &x[2 * (i + 2 * n1)];
+				int32_t * d = &x[2 * (i + 3 * n1)];
+
+				int32_t t0r = (a[0] + c[0]) >> 2, t0i = (a[1] + c[1]) >> 2;
+				int32_t t1r = (a[0] - c[0]) >> 2, t1i = (a[1] - c[1]) >> 2;
+				int32_t t2r = (b[0] + d[0]) >> 2, t2i = (b[1] + d[1]) >> 2;
+				int32_t t3r = (b[0] - d[0]) >> 2, t3i = (b[1] - d[1]) >> 2;
+
+				// k = 1: t1 - j t3, k = 2: t0 - t2, k = 3: t1 + j t3, then times W^(k j)
+				int32_t y1r = t1r + t3i, y1i = t1i - t3r;
+				int32_t y2r = t0r - t2r, y2i = t0i - t2i;
+				int32_t y3r = t1r - t3i, y3i = t1i + t3r;
+
+				a[0] = t0r + t2r;
+				a[1] = t0i + t2i;
+				b[0] = (y1r * c1 + y1i * s1) >> 15;
+				b[1] = (y1i * c1 - y1r * s1) >> 15;
+				c[0] = (y2r * c2 + y2i * s2) >> 15;
+				c[1] = (y2i * c2 - y2r * s2) >> 15;
+				d[0] = (y3r * c3 + y3i * s3) >> 15;
+				d[1] = (y3i * c3 - y3r * s3) >> 15;
+			}
+		}
+	}
+
+	// Base 4 digit reversal
+	for (uint32_t i = 1, bits = __builtin_ctz(m); i < m; i++)
+	{
+		uint32_t r = 0;
+
+		for (uint32_t k = 0; k < bits; k += 2)
+		{
+			r |= ((i >> k) & 3) << (bits - 2 - k);
+		}
+		if (r > i)
+		{
+			int32_t tr = x[2 * i], ti = x[2 * i + 1];
+
+			x[2 * i] = x[2 * r];
+			x[2 * i + 1] = x[2 * r + 1];
+			x[2 * r] = tr;
+			x[2 * r + 1] = ti;
+		}
+	}
+}
+
+/**
+ * @brief Real FFT in place.
+ * @param buffer: In: n real Q15 samples. Out: bins 0 to n/2 - 1, re/im interleaved,
+ * scaled by 2/n (a full scale sine on a bin gives 32767). The imaginary part
+ * of bin 0 holds the Nyquist bin.
+ * @param n: Size, see fft_valid_size().
+ * @retval int: 0 on success, -1 if the size is not supported.
+ */
+ISR_CODE int fft_real_q15(int32_t * buffer, uint32_t n)
+{
+	if (!fft_valid_size(n))
+	{
+		return -1;
+	}
+
+	const uint32_t m = n / 2;
+	const uint32_t step = SINE_TABLE_SIZE / n;	// Stride of W_n
+
+	// Even samples as real parts, odd ones as imaginary parts
+	fft_radix4(buffer, m, 2 * step);
+
+	// X[k] = (Z[k] + Z*[m-k]) / 2 - j W^k (Z[k] - Z*[m-k]) / 2, for k and m - k at once
+	int32_t z0r = buffer[0], z0i = buffer[1];
+
+	buffer[0] = z0r + z0i;
+	buffer[1] = z0r - z0i;
+
+	for (uint32_t k = 1; k <= m / 2; k++)
+	{
+		int32_t * p = &buffer[2 * k];
+		int32_t * q = &buffer[2 * (m - k)];
+		int32_t er = (p[0] + q[0]) >> 1, ei = (p[1] - q[1]) >> 1;	// (Z[k] + Z*[m-k]) / 2
+		int32_t orr = (p[1] + q[1]) >> 1, oii = (q[0] - p[0]) >> 1;	// (Z[k] - Z*[m-k]) / 2j
+		int32_t c = FFT_COS(k * step), s = FFT_SIN(k * step);
+		int32_t wr = (orr * c + oii * s) >> 15;						// W^k = c - j s
+		int32_t wi = (oii * c - orr * s) >> 15;
+
+		// Bin m - k is the conjugate symmetric counterpart: E* - conj(W^k O) with W^(m-k) = -conj(W^k)
+		p[0] = er + wr;
+		p[1] = ei + wi;
+		if (q != p)
+		{
+			q[0] = er - wr;
+			q[1] = wi - ei;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * fft.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_FFT_H_
+#define AUDIO_FFT_H_
+
+#include <stdint.h>
+
+/**
+ * Fixed-point real FFT: a radix-4 complex FFT of n/2 points on the even/odd
+ * samples, followed by the split into the n/2 bins of the real signal.
+ * The twiddles are read from the flash sine table, which limits n to its size.
+ * Valid sizes: n/2 a power of 4, i.e. 8, 32, 128, 512.
+ */
+#define FFT_MAX_SIZE 512
+
+int fft_valid_size(uint32_t n);
+int fft_real_q15(int32_t * buffer, uint32_t n);
+
+#endif /* AUDIO_FFT_H_ */
@@ -0,0 +1,429 @@
+/*
+ * graph.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "graph.h"
+
+#include <string.h>
+
+#include "../utils/sections.h"
+
+
+static inline int16_t * graph_block(const graph_t * g, uint32_t buffer)
+{
+	return &g->pool[buffer * GRAPH_CHANNELS * g->max_frames];
+}
+
+static int graph_valid(const graph_t * g, int node)
+{
+	return node >= 0 && node < g->count;
+}
+
+/**
+ * @brief Empty graph.
+ * @param g: Graph.
+ * @param pool: GRAPH_MAX_BUFFERS * GRAPH_CHANNELS * max_frames samples.
+ * @param max_frames: Largest block processed.
+ */
+void graph_init(graph_t * g, int16_t * pool, uint32_t max_frames)
+{
+	memset(g, 0, sizeof(*g));
+
+	g->pool = pool;
+	g->max_frames = max_frames;
+	g->output = GRAPH_NONE;
+}
+
+/**
+ * @brief Moves the blocks to another pool, for another block size.
+ * Not to be called while graph_process() runs.
+ */
+void graph_set_pool(graph_t * g, int16_t * pool, uint32_t max_frames)
+{
+	g->pool = pool;
+	g->max_frames = max_frames;
+}
+
+/**
+ * @brief Clears the state of the linked stages which have a reset and the
+ * cycle counts. Not to be called while graph_process() runs.
+ */
+void graph_reset(graph_t * g)
+{
+	for (int i = 0; i < g->count; i++)
+	{
+		graph_node_t * node = &g->nodes[i];
+
+		if (node->linked && node->stage->reset != NULL)
+		{
+			node->stage->reset(node->ctx);
+		}
+		profiling_zone_reset(&node->zone);
+	}
+	profiling_zone_reset(&g->zone);
+}
+
+/**
+ * @brief Declares a stage, not linked yet.
+ * @retval int: Index of the node, -1 if the table is full.
+ */
+int graph_add(graph_t * g, const graph_stage_t * stage, void * ctx)
+{
+	if (g->count >= GRAPH_MAX_NODES)
+	{
+		return -1;
+	}
+
+	graph_node_t * node = &g->nodes[g->count];
+
+	memset(node, 0, sizeof(*node));
+	node->stage = stage;
+	node->ctx = ctx;
+	node->input = GRAPH_NONE;
+
+	return g->count++;
+}
+
+/**
+ * @retval int: Index of the node running this stage, -1 if none.
+ */
+int graph_find(const graph_t * g, const char * name)
+{
+	for (int i = 0; i < g->count; i++)
+	{
+		if (strcmp(g->nodes[i].stage->name, name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Adds a node to the graph, fed by input (GRAPH_NONE for a source).
+ * Takes effect at the next graph_build().
+ */
+int graph_link(graph_t * g, int node, int input)
+{
+	if (!graph_valid(g, node) || (input != GRAPH_NONE && !graph_valid(g, input)))
+	{
+		return -1;
+	}
+
+	g->nodes[node].input = (uint8_t)input;
+	g->nodes[node].linked = 1;
+
+	return 0;
+}
+
+/**
+ * @brief Node giving the output of the graph.
+ */
+void graph_set_output(graph_t * g, int node)
+{
+	if (graph_valid(g, node))
+	{
+		g->output = (uint8_t)node;
+	}
+}
+
+void graph_bypass(graph_t * g, int node, int bypass)
+{
+	if (graph_valid(g, node))
+	{
+		g->nodes[node].bypass = (bypass != 0);
+	}
+}
+
+/**
+ * @brief Inserts an unlinked node after another one: it takes over the
+ * readers of 'after' (and the output, if it was the output), then the graph
+ * is rebuilt. Nothing changes if the build fails.
+ * @retval int: 0 on success, -1 if not possible, -2 if the previous build is still pending.
+ */
+int graph_insert(graph_t * g, int node, int after)
+{
+	if (!graph_valid(g, node) || !graph_valid(g, after) || g->nodes[node].linked || !g->nodes[after].linked)
+	{
+		return -1;
+	}
+
+	uint8_t inputs[GRAPH_MAX_NODES];
+	const uint8_t output = g->output;
+
+	for (int i = 0; i < g->count; i++)
+	{
+		inputs[i] = g->nodes[i].input;
+		if (g->nodes[i].linked && g->nodes[i].input == after)
+		{
+			g->nodes[i].input = (uint8_t)node;
+		}
+	}
+	if (g->output == after)
+	{
+		g->output = (uint8_t)node;
+	}
+
+	if (g->nodes[node].stage->reset != NULL)
+	{
+		g->nodes[node].stage->reset(g->nodes[node].ctx);
+	}
+	profiling_zone_reset(&g->nodes[node].zone);
+	graph_link(g, node, after);
+
+	int status = graph_build(g);
+
+	if (status != 0)
+	{
+		for (int i = 0; i < g->count; i++)
+		{
+			g->nodes[i].input = inputs[i];
+		}
+		g->nodes[node].linked = 0;
+		g->output = output;
+	}
+
+	return status;
+}
+
+/**
+ * @brief Removes a node, its readers are fed by its input instead, then the
+ * graph is rebuilt. Nothing changes if the build fails (a source with readers).
+ * @retval int: 0 on success, -1 if not possible, -2 if the previous build is still pending.
+ */
+int graph_remove(graph_t * g, int node)
+{
+	if (!graph_valid(g, node) || !g->nodes[node].linked)
+	{
+		return -1;
+	}
+
+	uint8_t inputs[GRAPH_MAX_NODES];
+	const uint8_t output = g->output;
+	const uint8_t input = g->nodes[node].input;
+
+	for (int i = 0; i < g->count; i++)
+	{
+		inputs[i] = g->nodes[i].input;
+		if (g->nodes[i].linked && g->nodes[i].input == node)
+		{
+			g->nodes[i].input = input;
+		}
+	}
+	if (g->output == node)
+	{
+		g->output = input;
+	}
+	g->nodes[node].linked = 0;
+
+	int status = graph_build(g);
+
+	if (status != 0)
+	{
+		for (int i = 0; i < g->count; i++)
+		{
+			g->nodes[i].input = inputs[i];
+		}
+		g->nodes[node].linked = 1;
+		g->output = output;
+	}
+
+	return status;
+}
+
+/**
+ * @brief Compiles the linked nodes into the schedule not in use, which the
+ * audio task takes at its next block.
+ * @retval int: 0 on success, -1 if the graph has a cycle, a node without
+ * input, no output or needs more than GRAPH_MAX_BUFFERS blocks,
+ * -2 if the previous build has not been taken yet.
+ */
+int graph_build(graph_t * g)
+{
+	graph_schedule_t * sc = &g->schedule[g->active ^ 1];
+	uint8_t order[GRAPH_MAX_NODES];
+	uint8_t step_of[GRAPH_MAX_NODES];	// Step of each node
+	uint8_t value[GRAPH_MAX_NODES];		// Node which wrote the block seen at the output of each node
+	uint8_t last[GRAPH_MAX_NODES];		// Last step reading the block of each value
+	uint8_t buffer[GRAPH_MAX_NODES];	// Block of each value
+	uint8_t owner[GRAPH_MAX_BUFFERS];	// Value in each block
+	uint32_t count = 0;
+	int progress;
+
+	if (g->pending)
+	{
+		return -2;
+	}
+	if (g->output == GRAPH_NONE || !g->nodes[g->output].linked)
+	{
+		return -1;
+	}
+
+	// Topological order: a node comes once its input has been placed
+	memset(step_of, GRAPH_NONE, sizeof(step_of));
+	do
+	{
+		progress = 0;
+		for (uint32_t n = 0; n < g->count; n++)
+		{
+			const graph_node_t * node = &g->nodes[n];
+
+			if (!node->linked || step_of[n] != GRAPH_NONE)
+			{
+				continue;
+			}
+			if ((node->stage->flags & GRAPH_SOURCE) ? (node->input == GRAPH_NONE) :
+					(node->input != GRAPH_NONE && step_of[node->input] != GRAPH_NONE))
+			{
+				step_of[n] = (uint8_t)count;
+				order[count++] = (uint8_t)n;
+				progress = 1;
+			}
+		}
+	} while (progress);
+
+	for (uint32_t n = 0; n < g->count; n++)
+	{
+		if (g->nodes[n].linked && step_of[n] == GRAPH_NONE)
+		{
+			return -1;
+		}
+	}
+
+	// Liveness: a sink passes the block of its input on
+	memset(value, 0, sizeof(value));
+	for (uint32_t s = 0; s < count; s++)
+	{
+		const graph_node_t * node = &g->nodes[order[s]];
+
+		value[order[s]] = (node->stage->flags & GRAPH_SINK) ? value[node->input] : order[s];
+		last[value[order[s]]] = (uint8_t)s;
+		if (node->input != GRAPH_NONE)
+		{
+			last[value[node->input]] = (uint8_t)s;
+		}
+	}
+	last[value[g->output]] = GRAPH_NONE;	// Read after the last step
+
+	// Blocks: in place when the input dies here, from the pool otherwise
+	memset(owner, GRAPH_NONE, sizeof(owner));
+	sc->buffers = 0;
+
+	for (uint32_t s = 0; s < count; s++)
+	{
+		const uint8_t n = order[s];
+		const graph_node_t * node = &g->nodes[n];
+		uint8_t in = GRAPH_NONE, out = GRAPH_NONE;
+
+		if (node->input != GRAPH_NONE)
+		{
+			in = buffer[value[node->input]];
+		}
+
+		if (in != GRAPH_NONE && ((node->stage->flags & GRAPH_SINK) || last[value[node->input]] == s))
+		{
+			out = in;
+		}
+		else
+		{
+			for (uint8_t b = 0; b < GRAPH_MAX_BUFFERS; b++)
+			{
+				if (owner[b] == GRAPH_NONE)
+				{
+					out = b;
+					break;
+				}
+			}
+			if (out == GRAPH_NONE)
+			{
+				return -1;
+			}
+			if (out + 1 > sc->buffers)
+			{
+				sc->buffers = out + 1;
+			}
+		}
+
+		buffer[value[n]] = out;
+		owner[out] = value[n];
+		sc->steps[s].node = n;
+		sc->steps[s].in = (in == GRAPH_NONE) ? out : in;
+		sc->steps[s].out = out;
+
+		for (uint8_t b = 0; b < GRAPH_MAX_BUFFERS; b++)
+		{
+			if (owner[b] != GRAPH_NONE && last[owner[b]] == s)
+			{
+				owner[b] = GRAPH_NONE;
+			}
+		}
+	}
+
+	sc->count = (uint8_t)count;
+	sc->output = buffer[value[g->output]];
+
+	__atomic_signal_fence(__ATOMIC_RELEASE);	// Schedule written before the flag
+	g->pending = 1;
+
+	return 0;
+}
+
+/**
+ * @brief Runs the schedule, then copies the output block to out.
+ * @param g: Graph.
+ * @param out: GRAPH_CHANNELS * frames samples.
+ * @param frames: Number of frames, max_frames at most.
+ */
+ISR_CODE void graph_process(graph_t * g, int16_t * out, uint32_t frames)
+{
+	const uint32_t bytes = GRAPH_CHANNELS * frames * sizeof(int16_t);
+
+	if (g->pending)
+	{
+		__atomic_signal_fence(__ATOMIC_ACQUIRE);
+		g->active ^= 1;
+		g->pending = 0;
+	}
+
+	const graph_schedule_t * sc = &g->schedule[g->active];
+
+	profiling_zone_begin(&g->zone);
+
+	for (uint32_t s = 0; s < sc->count; s++)
+	{
+		const graph_step_t * step = &sc->steps[s];
+		graph_node_t * node = &g->nodes[step->node];
+		int16_t * block = graph_block(g, step->out);
+
+		if (step->in != step->out)
+		{
+			memcpy(block, graph_block(g, step->in), bytes);
+		}
+
+		if (!node->bypass)
+		{
+			profiling_zone_begin(&node->zone);
+			node->stage->process(node->ctx, block, frames);
+			profiling_zone_end(&node->zone);
+		}
+		else if (node->stage->flags & GRAPH_SOURCE)
+		{
+			memset(block, 0, bytes);
+		}
+	}
+
+	if (sc->count > 0)
+	{
+		memcpy(out, graph_block(g, sc->output), bytes);
+	}
+	else
+	{
+		memset(out, 0, bytes);
+	}
+
+	profiling_zone_end(&g->zone);
+}
@@ -0,0 +1,91 @@
+/*
+ * graph.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_GRAPH_H_
+#define AUDIO_GRAPH_H_
+
+#include <stdint.h>
+
+#include "../utils/profiling.h"
+
+/**
+ * Audio graph: stages declared once at init, linked by their input, and
+ * compiled by graph_build() into a flat schedule (topological order) with
+ * the intermediate blocks taken from a preallocated pool.
+ * A block whose last reader is the current stage is processed in place,
+ * otherwise (fan-out) it is copied first; blocks are given back to the pool
+ * after their last reader, so a chain runs in a single block.
+ * The schedule is double buffered: a new one is built by a task and picked
+ * up by the audio task at the start of its next block.
+ */
+#define GRAPH_MAX_NODES 12
+#define GRAPH_MAX_BUFFERS 3
+#define GRAPH_CHANNELS 2
+#define GRAPH_NONE 0xFF
+
+#define GRAPH_SOURCE (1U << 0)	// No input, writes its block
+#define GRAPH_SINK (1U << 1)	// Only reads its block, its output is its input
+
+/**
+ * @brief Stage interface. The parameters are in the context of the stage
+ * (its own structure and setters), the graph only moves blocks.
+ */
+typedef struct {
+	const char * name;
+	void (* process)(void * ctx, int16_t * block, uint32_t frames);	// In place, GRAPH_CHANNELS interleaved
+	void (* reset)(void * ctx);		// Clears the state when the stage is inserted, may be NULL
+	uint8_t flags;
+} graph_stage_t;
+
+typedef struct {
+	const graph_stage_t * stage;
+	void * ctx;
+	uint8_t input;				// Node feeding this one, GRAPH_NONE for a source
+	uint8_t linked;				// Part of the graph
+	volatile uint8_t bypass;	// Skipped, the block goes through unchanged (a source gives silence)
+	profiling_zone_t zone;		// Cycles of process()
+} graph_node_t;
+
+typedef struct {
+	uint8_t node;
+	uint8_t in;				// Block read
+	uint8_t out;			// Block written, the input is copied into it first if different
+} graph_step_t;
+
+typedef struct {
+	graph_step_t steps[GRAPH_MAX_NODES];
+	uint8_t count;
+	uint8_t output;			// Block holding the output of the graph
+	uint8_t buffers;		// Blocks used
+} graph_schedule_t;
+
+typedef struct {
+	graph_node_t nodes[GRAPH_MAX_NODES];
+	uint8_t count;
+	uint8_t output;					// Node giving the output of the graph
+	graph_schedule_t schedule[2];
+	volatile uint8_t active;		// Schedule run by the audio task
+	volatile uint8_t pending;		// The other one is ready
+	int16_t * pool;					// GRAPH_MAX_BUFFERS blocks of max_frames
+	uint32_t max_frames;
+	profiling_zone_t zone;			// Whole graph
+} graph_t;
+
+void graph_init(graph_t * g, int16_t * pool, uint32_t max_frames);
+void graph_set_pool(graph_t * g, int16_t * pool, uint32_t max_frames);
+void graph_reset(graph_t * g);
+int graph_add(graph_t * g, const graph_stage_t * stage, void * ctx);
+int graph_find(const graph_t * g, const char * name);
+int graph_link(graph_t * g, int node, int input);
+int graph_insert(graph_t * g, int node, int after);
+int graph_remove(graph_t * g, int node);
+void graph_set_output(graph_t * g, int node);
+void graph_bypass(graph_t * g, int node, int bypass);
+int graph_build(graph_t * g);
+void graph_process(graph_t * g, int16_t * out, uint32_t frames);
+
+#endif /* AUDIO_GRAPH_H_ */
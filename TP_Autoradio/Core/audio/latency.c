@@ -0,0 +1,229 @@
+/*
+ * latency.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "latency.h"
+
+#include <string.h>
+
+#include "../utils/sections.h"
+
+#define LATENCY_MLS_TAPS 0x0204U		// x^10 + x^7 + 1, Galois form
+#define LATENCY_MIN_RATIO 8				// Peak above the mean level for a valid result
+
+
+/**
+ * @brief Idle, marker at -12 dBFS.
+ */
+void latency_init(latency_t * lt)
+{
+	memset(lt, 0, sizeof(*lt));
+
+	lt->level = 8192;
+	lt->simulated = LATENCY_NONE;
+}
+
+/**
+ * @brief Marker sample emitted at a given frame.
+ */
+static inline int32_t latency_marker(const latency_t * lt, int32_t frame)
+{
+	if (frame < 0)
+	{
+		return 0;
+	}
+	if (lt->signal == LATENCY_IMPULSE)
+	{
+		return (frame == 0) ? lt->level : 0;
+	}
+	if ((uint32_t)frame >= LATENCY_MLS_LENGTH)
+	{
+		return 0;
+	}
+
+	return ((lt->mls[frame / 32U] >> (frame % 32U)) & 1U) ? lt->level : -lt->level;
+}
+
+/**
+ * @brief Starts a measurement at the next block.
+ * @param lt: Measurement.
+ * @param capture: Recording of LATENCY_CAPTURE_FRAMES samples, lent until
+ * the analysis or the cancellation.
+ * @param signal: Marker.
+ * @param simulated: Round trip in frames fed back to the input instead of
+ * the captured block (test without loopback), LATENCY_NONE to use the input.
+ * @retval int: 0, or -1 if a measurement is running.
+ */
+int latency_start(latency_t * lt, int16_t * capture, latency_signal_t signal, int32_t simulated)
+{
+	if (lt->state == LATENCY_RUNNING)
+	{
+		return -1;
+	}
+
+	uint32_t lfsr = 1;
+
+	memset(lt->mls, 0, sizeof(lt->mls));
+	for (uint32_t i = 0; i < LATENCY_MLS_LENGTH; i++)
+	{
+		lt->mls[i / 32U] |= (lfsr & 1U) << (i % 32U);
+		lfsr = (lfsr >> 1) ^ ((lfsr & 1U) ? LATENCY_MLS_TAPS : 0U);
+	}
+
+	lt->capture = capture;
+	lt->signal = signal;
+	lt->simulated = simulated;
+	lt->position = 0;
+	lt->peak = 0;
+	lt->floor = 0;
+
+	__atomic_signal_fence(__ATOMIC_RELEASE);	// Set up before the audio task sees it
+	lt->state = LATENCY_RUNNING;
+
+	return 0;
+}
+
+/**
+ * @brief Gives up a measurement which has not completed (audio stopped):
+ * back to idle, the audio task no longer writes the recording. From a task
+ * of lower priority than the audio task, which is never interrupted by it
+ * in the middle of a block.
+ */
+void latency_cancel(latency_t * lt)
+{
+	lt->state = LATENCY_IDLE;
+}
+
+/**
+ * @brief Audio task, after the block has been computed: while running, the
+ * output is replaced by the marker (other sources muted) and the input is
+ * recorded. Nothing is done otherwise.
+ * @param lt: Measurement.
+ * @param in: Captured block, LATENCY_CHANNELS interleaved.
+ * @param out: Output block, LATENCY_CHANNELS interleaved.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void latency_process(latency_t * lt, const int16_t * in, int16_t * out, uint32_t frames)
+{
+	if (lt->state != LATENCY_RUNNING)
+	{
+		return;
+	}
+	__atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+	for (uint32_t n = 0; n < frames; n++, in += LATENCY_CHANNELS, out += LATENCY_CHANNELS)
+	{
+		const int32_t frame = (int32_t)lt->position;
+		const int16_t marker = (int16_t)latency_marker(lt, frame);
+
+		out[0] = marker;
+		out[1] = marker;
+
+		lt->capture[frame] = (lt->simulated == LATENCY_NONE) ? in[0] :
+				(int16_t)latency_marker(lt, frame - lt->simulated);
+
+		if (++lt->position == LATENCY_CAPTURE_FRAMES)
+		{
+			__atomic_signal_fence(__ATOMIC_RELEASE);
+			lt->state = LATENCY_CAPTURED;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Finds the marker in the recording, to be called once the state is
+ * LATENCY_CAPTURED; back to idle afterwards. About 3 M additions for the MLS,
+ * not for the audio task.
+ * @retval int32_t: Round trip in frames, LATENCY_NONE if the marker has not
+ * been found (no loopback, too much noise).
+ */
+int32_t latency_analyze(latency_t * lt)
+{
+	int32_t result = LATENCY_NONE;
+	int64_t sum = 0;
+	uint32_t count;
+
+	if (lt->state != LATENCY_CAPTURED)
+	{
+		return LATENCY_NONE;
+	}
+	__atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+	lt->peak = 0;
+
+	if (lt->signal == LATENCY_IMPULSE)
+	{
+		// Largest sample, then the first one reaching half of it (the
+		// converter filters ring before their main peak)
+		for (uint32_t i = 0; i < LATENCY_CAPTURE_FRAMES; i++)
+		{
+			int32_t x = (lt->capture[i] < 0) ? -lt->capture[i] : lt->capture[i];
+
+			sum += x;
+			if (x > lt->peak) lt->peak = x;
+		}
+		count = LATENCY_CAPTURE_FRAMES;
+
+		for (uint32_t i = 0; i < LATENCY_CAPTURE_FRAMES; i++)
+		{
+			if (2 * ((lt->capture[i] < 0) ? -lt->capture[i] : lt->capture[i]) >= lt->peak)
+			{
+				result = (int32_t)i;
+				break;
+			}
+		}
+	}
+	else
+	{
+		// Correlation with the sequence (+-1): the peak is at the delay
+		count = LATENCY_CAPTURE_FRAMES - LATENCY_MLS_LENGTH + 1U;
+
+		for (uint32_t lag = 0; lag < count; lag++)
+		{
+			const int16_t * x = &lt->capture[lag];
+			int32_t corr = 0;
+
+			for (uint32_t i = 0; i < LATENCY_MLS_LENGTH; i++)
+			{
+				corr += ((lt->mls[i / 32U] >> (i % 32U)) & 1U) ? x[i] : -x[i];
+			}
+			if (corr < 0) corr = -corr;		// The loop may invert
+			sum += corr;
+			if (corr > lt->peak)
+			{
+				lt->peak = corr;
+				result = (int32_t)lag;
+			}
+		}
+
+		// A true match correlates most of the energy of its window, a
+		// partial one (round trip out of range) does not
+		if (result != LATENCY_NONE)
+		{
+			int32_t energy = 0;
+
+			for (uint32_t i = 0; i < LATENCY_MLS_LENGTH; i++)
+			{
+				energy += (lt->capture[result + i] < 0) ? -lt->capture[result + i] : lt->capture[result + i];
+			}
+			if (2 * lt->peak < energy)
+			{
+				result = LATENCY_NONE;
+			}
+		}
+	}
+
+	lt->floor = (int32_t)(sum / count);
+	if (lt->peak == 0 || lt->peak < LATENCY_MIN_RATIO * lt->floor)
+	{
+		result = LATENCY_NONE;
+	}
+
+	lt->state = LATENCY_IDLE;
+
+	return result;
+}
@@ -0,0 +1,63 @@
+/*
+ * latency.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_LATENCY_H_
+#define AUDIO_LATENCY_H_
+
+#include <stdint.h>
+
+/**
+ * Round trip measurement: the audio task replaces its output with a marker
+ * (single impulse or maximum length sequence) and records its input, the
+ * output being looped back to the input (cable, or the codec I2S loopback).
+ * The delay is then found by a task, first sample above the threshold for
+ * the impulse, correlation peak for the MLS (robust to noise and to the
+ * smearing of the converters).
+ * Both streams are counted in frames of the blocks processed: an output frame
+ * is played two halves after it is written, so the result includes the
+ * DMA buffering as well as the converters.
+ * The recording is lent by the caller for the measurement only: it must not
+ * be reused before the analysis or latency_cancel().
+ */
+#define LATENCY_MLS_ORDER 10
+#define LATENCY_MLS_LENGTH ((1U << LATENCY_MLS_ORDER) - 1U)	// 1023 frames
+#define LATENCY_CAPTURE_FRAMES 4096		// Longest round trip: 4096 - LATENCY_MLS_LENGTH frames
+#define LATENCY_CHANNELS 2
+#define LATENCY_NONE (-1)
+
+typedef enum
+{
+	LATENCY_IMPULSE = 0U,
+	LATENCY_MLS
+} latency_signal_t;
+
+typedef enum
+{
+	LATENCY_IDLE = 0U,
+	LATENCY_RUNNING,		// Owned by the audio task
+	LATENCY_CAPTURED		// Owned by the task which started it
+} latency_state_t;
+
+typedef struct {
+	volatile uint8_t state;				// latency_state_t
+	uint8_t signal;						// latency_signal_t
+	int16_t level;						// Q15, amplitude of the marker
+	int32_t simulated;					// Frames of a simulated loop instead of the input, LATENCY_NONE if off
+	uint32_t position;					// Frames emitted and recorded
+	uint32_t mls[(LATENCY_MLS_LENGTH + 31U) / 32U];	// Sequence, one bit per frame
+	int16_t * capture;					// Left channel of the input, LATENCY_CAPTURE_FRAMES
+	int32_t peak;						// Detection level of the result
+	int32_t floor;						// Mean level around it
+} latency_t;
+
+void latency_init(latency_t * lt);
+int latency_start(latency_t * lt, int16_t * capture, latency_signal_t signal, int32_t simulated);
+void latency_cancel(latency_t * lt);
+void latency_process(latency_t * lt, const int16_t * in, int16_t * out, uint32_t frames);
+int32_t latency_analyze(latency_t * lt);
+
+#endif /* AUDIO_LATENCY_H_ */
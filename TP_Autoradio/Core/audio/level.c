@@ -0,0 +1,126 @@
+/*
+ * level.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "level.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define LEVEL_LOG2_TO_DB 1578264	// 20 log10(2) * 256 / 65536, Q26
+#define LEVEL_DB_TO_LOG2 2786635	// 65536 / (20 log10(2) * 256), Q16
+
+
+/**
+ * @brief Amplitude to decibels: log2 from the leading zeros and the flash
+ * table (32 segments per octave, linear interpolation, error below 0.002 dB).
+ * @param amplitude: Q15 amplitude, 32768 = 0 dB.
+ * @retval int32_t: Level in Q8 dB, LEVEL_DB_MIN at most for a null amplitude.
+ */
+ISR_CODE int32_t level_to_db(uint32_t amplitude)
+{
+	if (amplitude == 0)
+	{
+		return LEVEL_DB_MIN;
+	}
+
+	int32_t e = 31 - __builtin_clz(amplitude);
+	uint32_t m = (e >= 30) ? amplitude >> (e - 30) : amplitude << (30 - e);	// [2^30, 2^31)
+	uint32_t i = (m >> (30 - LOG2_TABLE_BITS)) & (LOG2_TABLE_SIZE - 1);
+	uint32_t frac = (m >> (30 - LOG2_TABLE_BITS - 16)) & 0xFFFF;
+	int32_t log2 = (e - 15) * 65536 + (int32_t)(log2_q16[i] + (((log2_q16[i + 1] - log2_q16[i]) * frac) >> 16));
+	int32_t db = (int32_t)(((int64_t)log2 * LEVEL_LOG2_TO_DB) >> 26);
+
+	return (db < LEVEL_DB_MIN) ? LEVEL_DB_MIN : db;
+}
+
+/**
+ * @brief Decibels to a linear gain, inverse of level_to_db().
+ * @param db: Q8 dB, clamped to LEVEL_DB_MAX.
+ * @retval uint32_t: Gain in Q16 (LEVEL_GAIN_ONE = 0 dB), 0 below -96 dB.
+ */
+ISR_CODE uint32_t level_db_to_gain(int32_t db)
+{
+	if (db > LEVEL_DB_MAX)
+	{
+		db = LEVEL_DB_MAX;
+	}
+
+	int32_t log2 = (int32_t)(((int64_t)db * LEVEL_DB_TO_LOG2) >> 16);
+	int32_t shift = 14 - (log2 >> 16);		// Q30 mantissa to Q16 times 2^integer part
+	uint32_t f = (uint32_t)log2 & 0xFFFF;
+	uint32_t i = f >> (16 - LOG2_TABLE_BITS);
+	uint32_t frac = f & ((1 << (16 - LOG2_TABLE_BITS)) - 1);
+	uint32_t mant = exp2_q30[i] + (uint32_t)(((uint64_t)(exp2_q30[i + 1] - exp2_q30[i]) * frac) >> (16 - LOG2_TABLE_BITS));
+
+	return (shift >= 32) ? 0 : mant >> shift;
+}
+
+/**
+ * @brief Silent envelope, instantaneous ballistics until level_follower_set_times().
+ */
+void level_follower_init(level_follower_t * lf)
+{
+	memset(lf, 0, sizeof(*lf));
+
+	lf->attack = 32767;
+	lf->release = 32767;
+	for (int ch = 0; ch < LEVEL_CHANNELS; ch++)
+	{
+		lf->db[ch] = LEVEL_DB_MIN;
+	}
+}
+
+/**
+ * @brief Time constants of the envelope (63 % of a step), 0 for instantaneous.
+ * @param block_ms: Period of level_follower_update() calls.
+ */
+void level_follower_set_times(level_follower_t * lf, float attack_ms, float release_ms, float block_ms)
+{
+	lf->attack = (attack_ms > 0.0f) ? (int32_t)(32767.0f * (1.0f - expf(-block_ms / attack_ms))) : 32767;
+	lf->release = (release_ms > 0.0f) ? (int32_t)(32767.0f * (1.0f - expf(-block_ms / release_ms))) : 32767;
+}
+
+/**
+ * @brief Follows the peak of one stereo interleaved block and publishes it in dB.
+ * @param lf: Follower.
+ * @param block: LEVEL_CHANNELS * frames samples, read only.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void level_follower_update(level_follower_t * lf, const int16_t * block, uint32_t frames)
+{
+	int32_t peak[LEVEL_CHANNELS] = { 0 };
+
+	for (uint32_t n = 0; n < frames; n++, block += LEVEL_CHANNELS)
+	{
+		for (int ch = 0; ch < LEVEL_CHANNELS; ch++)
+		{
+			int32_t x = block[ch];
+
+			x = (x < 0) ? -x : x;
+			peak[ch] = (x > peak[ch]) ? x : peak[ch];
+		}
+	}
+
+	for (int ch = 0; ch < LEVEL_CHANNELS; ch++)
+	{
+		int32_t coef = (peak[ch] > lf->env[ch]) ? lf->attack : lf->release;
+
+		lf->env[ch] += ((peak[ch] - lf->env[ch]) * coef) >> 15;
+		lf->db[ch] = level_to_db((uint32_t)lf->env[ch]);
+	}
+}
+
+/**
+ * @brief Loudest channel, for a stereo-linked gain.
+ */
+ISR_CODE int32_t level_follower_linked(const level_follower_t * lf)
+{
+	return (lf->db[0] > lf->db[1]) ? lf->db[0] : lf->db[1];
+}
@@ -0,0 +1,43 @@
+/*
+ * level.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_LEVEL_H_
+#define AUDIO_LEVEL_H_
+
+#include <stdint.h>
+
+/**
+ * Fixed-point decibels and the block envelope follower shared by the
+ * dynamics stage and the VU meter.
+ * Levels are in Q8 dB (1/256 dB), 0 dB being a full scale Q15 amplitude.
+ */
+#define LEVEL_CHANNELS 2
+#define LEVEL_DB(db) ((int32_t)((db) * 256))	// dB to Q8
+#define LEVEL_DB_MIN LEVEL_DB(-120)			// Returned for a null amplitude
+#define LEVEL_DB_MAX LEVEL_DB(48)			// Largest gain of level_db_to_gain()
+#define LEVEL_GAIN_ONE (1 << 16)			// 0 dB gain in Q16
+
+/**
+ * Peak envelope, updated once per block: the block peak is followed with the
+ * attack coefficient when rising, the release one when falling.
+ */
+typedef struct {
+	int32_t attack;					// Q15, 1 - exp(-T / tau), T = block period
+	int32_t release;				// Q15
+	int32_t env[LEVEL_CHANNELS];	// Q15 amplitude
+	volatile int32_t db[LEVEL_CHANNELS];	// Published envelope, Q8 dB
+} level_follower_t;
+
+int32_t level_to_db(uint32_t amplitude);
+uint32_t level_db_to_gain(int32_t db);
+
+void level_follower_init(level_follower_t * lf);
+void level_follower_set_times(level_follower_t * lf, float attack_ms, float release_ms, float block_ms);
+void level_follower_update(level_follower_t * lf, const int16_t * block, uint32_t frames);
+int32_t level_follower_linked(const level_follower_t * lf);
+
+#endif /* AUDIO_LEVEL_H_ */
@@ -0,0 +1,181 @@
+/*
+ * loudness.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "loudness.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define LOUDNESS_MIN_SAMPLES 4800		// Quiet samples needed for a measurement (100 ms at 48 kHz)
+#define LOUDNESS_GAIN_SLOPE 50			// % of the excess noise compensated by the gain
+#define LOUDNESS_BASS_SLOPE 60
+#define LOUDNESS_TREBLE_SLOPE 30
+
+
+static inline int32_t loudness_clamp(int32_t x, int32_t min, int32_t max)
+{
+	return (x < min) ? min : (x > max) ? max : x;
+}
+
+/**
+ * @brief Moves a value towards its target by LOUDNESS_STEP at most.
+ */
+static inline int32_t loudness_slew(int32_t value, int32_t target)
+{
+	return value + loudness_clamp(target - value, -LOUDNESS_STEP, LOUDNESS_STEP);
+}
+
+static void loudness_design(loudness_t * ld, biquad_coefs_t coefs[2])
+{
+	biquad_design(&coefs[0], BIQUAD_LOWSHELF, (float)ld->sample_rate, LOUDNESS_BASS_HZ, 0.707f, (float)ld->bass_db / 256.0f);
+	biquad_design(&coefs[1], BIQUAD_HIGHSHELF, (float)ld->sample_rate, LOUDNESS_TREBLE_HZ, 0.707f, (float)ld->treble_db / 256.0f);
+}
+
+/**
+ * @brief Disabled, flat, reference at -60 dBFS, measures below -40 dBFS of programme.
+ */
+void loudness_init(loudness_t * ld, uint32_t sample_rate)
+{
+	biquad_coefs_t flat[2];
+
+	memset(ld, 0, sizeof(*ld));
+
+	ld->sample_rate = sample_rate;
+	ld->gain = LEVEL_GAIN_ONE;
+	ld->gain_now = LEVEL_GAIN_ONE;
+	ld->quiet = LEVEL_DB(-40);
+	ld->reference = LEVEL_DB(-60);
+	ld->noise = ld->reference;
+	ld->mic = LEVEL_DB_MIN;
+
+	biquad_init(&ld->eq, BIQUAD_DF1_Q31);
+	loudness_design(ld, flat);
+	biquad_set_stage(&ld->eq, 0, &flat[0]);
+	biquad_set_stage(&ld->eq, 1, &flat[1]);
+}
+
+/**
+ * @brief Enables or bypasses the compensation, it restarts flat from the reference.
+ */
+void loudness_enable(loudness_t * ld, int enable)
+{
+	if (enable && !ld->enabled)
+	{
+		ld->noise = ld->reference;
+		ld->energy = 0;
+		ld->samples = 0;
+		ld->gain_now = ld->gain;
+		biquad_reset(&ld->eq);
+	}
+	ld->enabled = (enable != 0);
+}
+
+/**
+ * @brief Mic level of a quiet cabin, nothing is added below it.
+ */
+void loudness_set_reference(loudness_t * ld, float db)
+{
+	ld->reference = (int32_t)(db * 256.0f);
+}
+
+/**
+ * @brief Audio task side, once per block: accumulates the mic energy if the
+ * programme is quiet, then applies the shelves and the gain in place.
+ * @param ld: Loudness.
+ * @param mic: Captured block (the mic is mono, the left channel is used).
+ * @param block: LOUDNESS_CHANNELS * frames samples to compensate.
+ * @param frames: Number of frames.
+ * @param programme: Current programme level in Q8 dB.
+ */
+ISR_CODE void loudness_process(loudness_t * ld, const int16_t * mic, int16_t * block, uint32_t frames, int32_t programme)
+{
+	if (!ld->enabled)
+	{
+		return;
+	}
+
+	if (programme < ld->quiet)
+	{
+		uint64_t energy = 0;
+
+		for (uint32_t n = 0; n < frames; n++)
+		{
+			energy = dsp_mlal(energy, mic[LOUDNESS_CHANNELS * n], mic[LOUDNESS_CHANNELS * n]);
+		}
+		ld->energy += energy;
+		ld->samples += frames;
+	}
+
+	if (ld->pending)
+	{
+		__atomic_signal_fence(__ATOMIC_ACQUIRE);
+		biquad_set_stage(&ld->eq, 0, &ld->next[0]);
+		biquad_set_stage(&ld->eq, 1, &ld->next[1]);
+		ld->pending = 0;
+	}
+
+	biquad_process(&ld->eq, block, frames);
+
+	const uint32_t target = ld->gain;
+	int32_t gain = (int32_t)ld->gain_now;
+	int32_t step = ((int32_t)target - gain) / (int32_t)frames;
+
+	for (uint32_t n = 0; n < frames; n++, block += LOUDNESS_CHANNELS)
+	{
+		gain += step;
+		block[0] = (int16_t)dsp_sat16((int32_t)(((int64_t)block[0] * gain) >> 16));
+		block[1] = (int16_t)dsp_sat16((int32_t)(((int64_t)block[1] * gain) >> 16));
+	}
+
+	ld->gain_now = target;
+}
+
+/**
+ * @brief Low priority side, every LOUDNESS_PERIOD_MS: updates the noise floor
+ * and moves the compensation one step towards its new target.
+ * The floor goes down quickly and up slowly, so that a short noise (a voice,
+ * a horn) does not raise the volume.
+ * @param ld: Loudness.
+ * @param energy: Mic energy accumulated by loudness_process() since the last call.
+ * @param samples: Number of samples in it, too few means no quiet passage.
+ */
+void loudness_update(loudness_t * ld, uint64_t energy, uint32_t samples)
+{
+	if (samples >= LOUDNESS_MIN_SAMPLES)
+	{
+		// Mean power in Q30, 10 log10(P / 2^30) = (20 log10(P) - 20 log10(2^30)) / 2
+		uint32_t power = (uint32_t)(energy / samples);
+
+		ld->mic = (level_to_db(power) - level_to_db(1U << 30)) / 2;
+		ld->noise += (ld->mic - ld->noise) / ((ld->mic < ld->noise) ? 4 : 16);
+	}
+
+	int32_t excess = ld->noise - ld->reference;
+
+	if (excess < 0) excess = 0;
+
+	ld->gain_db = loudness_slew(ld->gain_db, loudness_clamp(excess * LOUDNESS_GAIN_SLOPE / 100, 0, LOUDNESS_GAIN_MAX));
+	ld->gain = level_db_to_gain(ld->gain_db);
+
+	// The shelves wait while the previous ones have not been loaded by the audio task
+	if (!ld->pending)
+	{
+		int32_t bass = loudness_slew(ld->bass_db, loudness_clamp(excess * LOUDNESS_BASS_SLOPE / 100, 0, LOUDNESS_BASS_MAX));
+		int32_t treble = loudness_slew(ld->treble_db, loudness_clamp(excess * LOUDNESS_TREBLE_SLOPE / 100, 0, LOUDNESS_TREBLE_MAX));
+
+		if (bass != ld->bass_db || treble != ld->treble_db)
+		{
+			ld->bass_db = bass;
+			ld->treble_db = treble;
+			loudness_design(ld, ld->next);
+			__atomic_signal_fence(__ATOMIC_RELEASE);	// 'next' written before the flag
+			ld->pending = 1;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ * loudness.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_LOUDNESS_H_
+#define AUDIO_LOUDNESS_H_
+
+#include <stdint.h>
+
+#include "biquad.h"
+#include "level.h"
+
+/**
+ * Noise-adaptive loudness: the cabin noise is measured on the microphone
+ * (ADC switched to MIC) while the programme is quiet, so that the speakers
+ * do not bias the estimate. The louder the noise above the reference, the
+ * more gain, bass and treble are added, a fraction of a dB per update.
+ *
+ * The work is split in two:
+ *  - loudness_process(), audio task: mic energy of the quiet blocks, shelves and gain;
+ *  - loudness_update(), low priority: estimate, targets and filter design.
+ * The new shelves are handed over with the 'pending' flag: the low priority
+ * side only writes 'next' while it is clear, the audio task loads and clears it.
+ */
+#define LOUDNESS_CHANNELS 2
+#define LOUDNESS_PERIOD_MS 250			// loudness_update() period
+#define LOUDNESS_BASS_HZ 150.0f			// Low shelf, road noise masks the lows first
+#define LOUDNESS_TREBLE_HZ 6000.0f		// High shelf
+#define LOUDNESS_STEP LEVEL_DB(0.25)	// Largest change per update (1 dB/s)
+#define LOUDNESS_GAIN_MAX LEVEL_DB(12)
+#define LOUDNESS_BASS_MAX LEVEL_DB(9)
+#define LOUDNESS_TREBLE_MAX LEVEL_DB(6)
+
+typedef struct {
+	biquad_t eq;					// Low shelf + high shelf, run by the audio task
+	biquad_coefs_t next[2];			// Designed by loudness_update()
+	volatile uint8_t pending;		// 'next' is ready to be loaded
+	volatile uint32_t gain;			// Q16, target of the audio task ramp
+	uint32_t gain_now;				// Q16, reached at the end of the last block
+	uint64_t energy;				// Sum of the squared mic samples of the quiet blocks
+	uint32_t samples;
+	uint32_t sample_rate;
+	int32_t quiet;					// Programme level below which the mic is measured, Q8 dB
+	int32_t reference;				// Mic level needing no compensation, Q8 dB
+	int32_t noise;					// Noise floor estimate, Q8 dB
+	int32_t mic;					// Last measurement, Q8 dB (LEVEL_DB_MIN if none)
+	int32_t gain_db;				// Applied compensation, Q8 dB
+	int32_t bass_db;
+	int32_t treble_db;
+	volatile uint8_t enabled;
+} loudness_t;
+
+void loudness_init(loudness_t * ld, uint32_t sample_rate);
+void loudness_enable(loudness_t * ld, int enable);
+void loudness_set_reference(loudness_t * ld, float db);
+void loudness_process(loudness_t * ld, const int16_t * mic, int16_t * block, uint32_t frames, int32_t programme);
+void loudness_update(loudness_t * ld, uint64_t energy, uint32_t samples);
+
+#endif /* AUDIO_LOUDNESS_H_ */
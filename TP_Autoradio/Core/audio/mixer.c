@@ -0,0 +1,221 @@
+/*
+ * mixer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "mixer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define MIXER_KNEE_Q15 ((int32_t)(MIXER_KNEE * 32768.0f))
+#define MIXER_KNEE_SLOPE ((int32_t)(32768.0f / (4.0f * (1.0f - MIXER_KNEE))))	// Q15
+
+
+/**
+ * @brief No source, ducking at -12 dB.
+ */
+void mixer_init(mixer_t * mx)
+{
+	memset(mx, 0, sizeof(*mx));
+	mx->duck_now = DSP_Q15_ONE;
+	mixer_set_ducking(mx, -12.0f);
+}
+
+/**
+ * @brief Registers a source, enabled at full gain. To be called before the
+ * audio task uses the mixer, or from a task: the source is complete before
+ * it is counted.
+ * @param mx: Mixer.
+ * @param name: Name used by the shell, kept as a pointer.
+ * @param fill: Callback producing the source.
+ * @param ctx: Passed to the callback.
+ * @param ducks: Non zero if the others are lowered while this one plays.
+ * @retval int: Index of the source, -1 if the table is full.
+ */
+int mixer_add(mixer_t * mx, const char * name, mixer_fill_t fill, void * ctx, int ducks)
+{
+	uint32_t n = mx->count;
+
+	if (n >= MIXER_MAX_SOURCES)
+	{
+		return -1;
+	}
+
+	mixer_source_t * src = &mx->sources[n];
+
+	src->name = name;
+	src->fill = fill;
+	src->ctx = ctx;
+	src->gain = INT16_MAX;
+	src->gain_now = 0;
+	src->enabled = 1;
+	src->ducks = (ducks != 0);
+	src->active = 0;
+
+	__atomic_signal_fence(__ATOMIC_RELEASE);	// Source written before it is counted
+	mx->count = n + 1;
+
+	return (int)n;
+}
+
+/**
+ * @retval int: Index of the source with this name, -1 if none.
+ */
+int mixer_find(const mixer_t * mx, const char * name)
+{
+	for (uint32_t i = 0; i < mx->count; i++)
+	{
+		if (strcmp(mx->sources[i].name, name) == 0)
+		{
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+void mixer_enable(mixer_t * mx, int source, int enable)
+{
+	if (source >= 0 && (uint32_t)source < mx->count)
+	{
+		mx->sources[source].enabled = (enable != 0);
+	}
+}
+
+/**
+ * @brief Gain of a source in Q15, ramped over the next block.
+ */
+void mixer_set_gain(mixer_t * mx, int source, int16_t gain)
+{
+	if (source >= 0 && (uint32_t)source < mx->count)
+	{
+		mx->sources[source].gain = (gain < 0) ? 0 : gain;
+	}
+}
+
+/**
+ * @brief Gain applied to the other sources while a ducking source plays.
+ */
+void mixer_set_ducking(mixer_t * mx, float db)
+{
+	float gain = powf(10.0f, db / 20.0f);
+
+	mx->duck_gain = (int16_t)((gain >= 1.0f) ? INT16_MAX : gain * 32768.0f);
+}
+
+/**
+ * @brief Adds one source to the bus, with its gain ramped from the previous
+ * block and halved for the headroom.
+ */
+static ISR_CODE void mixer_accumulate(mixer_t * mx, mixer_source_t * src, int32_t target, uint32_t frames)
+{
+	const int16_t * x = mx->scratch;
+	int32_t gain = src->gain_now;
+	int32_t step = (target - gain) / (int32_t)frames;
+
+	for (uint32_t n = 0; n < frames; n++, x += MIXER_CHANNELS)
+	{
+		gain += step;
+
+		// Q15 gain and -6 dB: >> 16
+		uint32_t pair = dsp_pack16((x[0] * gain) >> 16, (x[1] * gain) >> 16);
+
+		mx->bus[n] = dsp_qadd16(mx->bus[n], pair);
+	}
+
+	src->gain_now = target;
+}
+
+/**
+ * @brief Bus (half scale) to full scale: linear up to the knee, then a
+ * parabola reaching full scale with a zero slope.
+ */
+static inline int32_t mixer_soft_clip(int32_t x)
+{
+	int32_t a = (x < 0) ? -x : x;
+
+	if (a > MIXER_KNEE_Q15)
+	{
+		int32_t d = a - MIXER_KNEE_Q15;
+
+		a = MIXER_KNEE_Q15 + d - ((((d * d) >> 15) * MIXER_KNEE_SLOPE) >> 15);
+		if (a > INT16_MAX || d > 2 * (32768 - MIXER_KNEE_Q15)) a = INT16_MAX;
+	}
+
+	return (x < 0) ? -a : a;
+}
+
+/**
+ * @brief Mixes every enabled source into out.
+ * The ducking sources go first, so that the others are lowered in the same block.
+ * Blocks longer than MIXER_MAX_FRAMES are mixed in chunks, each source is
+ * then called once per chunk.
+ * @param mx: Mixer.
+ * @param out: MIXER_CHANNELS * frames samples, overwritten.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void mixer_process(mixer_t * mx, int16_t * out, uint32_t frames)
+{
+	for (; frames > MIXER_MAX_FRAMES; frames -= MIXER_MAX_FRAMES, out += MIXER_CHANNELS * MIXER_MAX_FRAMES)
+	{
+		mixer_process(mx, out, MIXER_MAX_FRAMES);
+	}
+
+	const uint32_t count = mx->count;
+	int ducking = 0;
+
+	__atomic_signal_fence(__ATOMIC_ACQUIRE);
+	memset(mx->bus, 0, frames * sizeof(mx->bus[0]));
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			// Ducking at once, release over MIXER_DUCK_RELEASE_BLOCKS
+			int32_t release = mx->duck_now + (DSP_Q15_ONE - mx->duck_gain) / MIXER_DUCK_RELEASE_BLOCKS;
+
+			mx->duck_now = ducking ? mx->duck_gain : (release > DSP_Q15_ONE) ? DSP_Q15_ONE : release;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			mixer_source_t * src = &mx->sources[i];
+
+			if (src->ducks != (pass == 0))
+			{
+				continue;
+			}
+
+			src->active = src->enabled && src->fill(src->ctx, mx->scratch, frames);
+			if (!src->active)
+			{
+				src->gain_now = 0;	// Fades in when it comes back
+				continue;
+			}
+
+			int32_t target = src->gain;
+
+			if (pass == 0)
+			{
+				ducking = 1;
+			}
+			else
+			{
+				target = (target * mx->duck_now) >> 15;
+			}
+			mixer_accumulate(mx, src, target, frames);
+		}
+	}
+
+	for (uint32_t n = 0; n < frames; n++, out += MIXER_CHANNELS)
+	{
+		out[0] = (int16_t)mixer_soft_clip((int32_t)(int16_t)mx->bus[n] * 2);
+		out[1] = (int16_t)mixer_soft_clip((int32_t)(int16_t)(mx->bus[n] >> 16) * 2);
+	}
+}
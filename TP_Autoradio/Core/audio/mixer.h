@@ -0,0 +1,64 @@
+/*
+ * mixer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_MIXER_H_
+#define AUDIO_MIXER_H_
+
+#include <stdint.h>
+
+/**
+ * Sums up to MIXER_MAX_SOURCES stereo sources into the output block.
+ * Each source is a callback filling a scratch block, scaled by its own Q15
+ * gain (ramped over the block), then added to the bus with saturating dual
+ * 16-bit adds. The bus has MIXER_HEADROOM_DB of headroom, a soft clipper
+ * brings it back to full scale at the end.
+ * A source registered with 'ducks' (prompt, chime) lowers all the others by
+ * the ducking gain while it plays.
+ * Sources are registered from a static table at init, nothing is allocated.
+ */
+#define MIXER_MAX_SOURCES 4
+#define MIXER_CHANNELS 2
+#define MIXER_MAX_FRAMES 256
+#define MIXER_HEADROOM_DB 6				// The bus is at half scale
+#define MIXER_KNEE 0.7f					// Soft clipping starts at -3 dBFS
+#define MIXER_DUCK_RELEASE_BLOCKS 32	// Back to full gain after a prompt (170 ms with 256 frames)
+
+/**
+ * @brief Fills frames stereo frames.
+ * @retval int: 0 if the source is silent (the block is not used), 1 otherwise.
+ */
+typedef int (* mixer_fill_t)(void * ctx, int16_t * block, uint32_t frames);
+
+typedef struct {
+	const char * name;
+	mixer_fill_t fill;
+	void * ctx;
+	volatile int16_t gain;		// Q15
+	int32_t gain_now;			// Q15, reached at the end of the previous block
+	volatile uint8_t enabled;
+	uint8_t ducks;				// Lowers the other sources while active
+	uint8_t active;				// Produced something in the last block
+} mixer_source_t;
+
+typedef struct {
+	mixer_source_t sources[MIXER_MAX_SOURCES];
+	volatile uint32_t count;
+	volatile int16_t duck_gain;		// Q15, gain of the others while a ducking source plays
+	int32_t duck_now;				// Q15
+	int16_t scratch[MIXER_CHANNELS * MIXER_MAX_FRAMES];	// Output of the current source
+	uint32_t bus[MIXER_MAX_FRAMES];					// Sum, one L/R pair per word
+} mixer_t;
+
+void mixer_init(mixer_t * mx);
+int mixer_add(mixer_t * mx, const char * name, mixer_fill_t fill, void * ctx, int ducks);
+int mixer_find(const mixer_t * mx, const char * name);
+void mixer_enable(mixer_t * mx, int source, int enable);
+void mixer_set_gain(mixer_t * mx, int source, int16_t gain);
+void mixer_set_ducking(mixer_t * mx, float db);
+void mixer_process(mixer_t * mx, int16_t * out, uint32_t frames);
+
+#endif /* AUDIO_MIXER_H_ */
@@ -0,0 +1,201 @@
+/*
+ * rc_filter.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "rc_filter.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define RC_PI_Q30 3373259426ULL		// pi in Q2.30
+#define RC_HALVINGS 3				// Angle divided by 8 before the Taylor series
+#define RC_GAIN_ONE (1 << 14)		// 1.0 in Q14
+
+static const char * const rc_mode_names[RC_MODE_COUNT] = {
+		"off", "lp", "hp"
+};
+
+
+/**
+ * @brief Coefficient g / (1 + g) with g = tan(pi fc / fs), in Q31, integer arithmetic only.
+ * g / (1 + g) = sin / (sin + cos): both come from Taylor series on a eighth of
+ * the angle (< 0.2 rad) followed by 3 double-angle steps, error below 1e-8.
+ * @param cutoff: Cutoff frequency in Hz, clamped to fs / 2.
+ * @param sample_rate: Sample rate in Hz.
+ * @retval int32_t: Coefficient in Q31.
+ */
+int32_t rc_filter_coef_q31(uint32_t cutoff, uint32_t sample_rate)
+{
+	if (cutoff == 0)
+	{
+		return 0;
+	}
+	if (cutoff >= sample_rate / 2)
+	{
+		return INT32_MAX;
+	}
+
+	// x = pi fc / fs / 8, Q31
+	int64_t x = (int64_t)(((uint64_t)cutoff * RC_PI_Q30) / sample_rate) >> (RC_HALVINGS - 1);
+	int64_t x2 = (x * x) >> 31;
+	int64_t x3 = (x2 * x) >> 31;
+	int64_t x4 = (x2 * x2) >> 31;
+	int64_t x5 = (x4 * x) >> 31;
+	int64_t x6 = (x4 * x2) >> 31;
+	int64_t sn = x - x3 / 6 + x5 / 120;
+	int64_t cs = (1LL << 31) - x2 / 2 + x4 / 24 - x6 / 720;
+
+	for (int i = 0; i < RC_HALVINGS; i++)
+	{
+		int64_t s2 = (2 * sn * cs) >> 31;
+
+		cs = ((cs * cs) >> 31) - ((sn * sn) >> 31);
+		sn = s2;
+	}
+
+	int64_t coef = (sn << 31) / (sn + cs);
+
+	return (coef > INT32_MAX) ? INT32_MAX : (int32_t)coef;
+}
+
+/**
+ * @brief Bypassed filter, cutoff at 1 kHz.
+ */
+void rc_filter_init(rc_filter_t * rc, uint32_t sample_rate)
+{
+	memset(rc, 0, sizeof(*rc));
+
+	rc->sample_rate = sample_rate;
+	rc->gain_x = RC_GAIN_ONE;
+	rc->gain_x_target = RC_GAIN_ONE;
+	rc_filter_set_cutoff(rc, 1000);
+	rc->coef = rc->coef_target;
+}
+
+/**
+ * @brief Selects the response, the change is crossfaded over the next block.
+ */
+void rc_filter_set_mode(rc_filter_t * rc, rc_mode_t mode)
+{
+	switch (mode)
+	{
+	case RC_LOWPASS:
+		rc->gain_x_target = 0;
+		rc->gain_lp_target = RC_GAIN_ONE;
+		break;
+	case RC_HIGHPASS:
+		rc->gain_x_target = RC_GAIN_ONE;
+		rc->gain_lp_target = -RC_GAIN_ONE;
+		break;
+	case RC_OFF:
+	default:
+		mode = RC_OFF;
+		rc->gain_x_target = RC_GAIN_ONE;
+		rc->gain_lp_target = 0;
+		break;
+	}
+
+	rc->mode = mode;
+}
+
+/**
+ * @brief Changes the cutoff, the coefficient moves linearly over the next block.
+ * @param rc: Filter.
+ * @param cutoff: Cutoff frequency in Hz (1 to fs / 2).
+ * @retval int: 0 on success, -1 if the cutoff is out of range.
+ */
+int rc_filter_set_cutoff(rc_filter_t * rc, uint32_t cutoff)
+{
+	if (cutoff == 0 || cutoff > rc->sample_rate / 2)
+	{
+		return -1;
+	}
+
+	rc->cutoff = cutoff;
+	rc->coef_target = rc_filter_coef_q31(cutoff, rc->sample_rate);
+
+	return 0;
+}
+
+/**
+ * @brief Filters one stereo interleaved block in place.
+ * The coefficient and the output mix are interpolated sample by sample from
+ * their previous value to the target, so a change never produces a step.
+ * @param rc: Filter.
+ * @param block: RC_CHANNELS * frames samples.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void rc_filter_process(rc_filter_t * rc, int16_t * block, uint32_t frames)
+{
+	const int32_t coef_target = rc->coef_target;
+	const int32_t gain_x_target = rc->gain_x_target;
+	const int32_t gain_lp_target = rc->gain_lp_target;
+
+	if (rc->mode == RC_OFF && rc->gain_lp == 0 && gain_lp_target == 0)
+	{
+		// Bypassed: the states follow the input, ready for a step-free restart
+		rc->s[0] = (int32_t)block[RC_CHANNELS * (frames - 1)] << 14;
+		rc->s[1] = (int32_t)block[RC_CHANNELS * (frames - 1) + 1] << 14;
+		rc->coef = coef_target;
+		return;
+	}
+
+	// Ramps: coefficient in Q31, gains in Q14 << 15
+	int32_t coef = rc->coef;
+	int32_t d_coef = (coef_target - coef) / (int32_t)frames;
+	int32_t gain_x = rc->gain_x << 15;
+	int32_t d_gain_x = ((gain_x_target - rc->gain_x) << 15) / (int32_t)frames;
+	int32_t gain_lp = rc->gain_lp << 15;
+	int32_t d_gain_lp = ((gain_lp_target - rc->gain_lp) << 15) / (int32_t)frames;
+	int32_t s0 = rc->s[0], s1 = rc->s[1];
+
+	for (uint32_t n = 0; n < frames; n++, block += RC_CHANNELS)
+	{
+		coef += d_coef;
+		gain_x += d_gain_x;
+		gain_lp += d_gain_lp;
+
+		const int32_t gx = gain_x >> 15, glp = gain_lp >> 15;
+		int32_t x0 = (int32_t)block[0] << 14;	// Q29, the state needs 2 bits of headroom
+		int32_t x1 = (int32_t)block[1] << 14;
+		int32_t v0 = (int32_t)(((int64_t)coef * (x0 - s0)) >> 31);
+		int32_t v1 = (int32_t)(((int64_t)coef * (x1 - s1)) >> 31);
+		int32_t lp0 = v0 + s0;
+		int32_t lp1 = v1 + s1;
+
+		s0 = lp0 + v0;
+		s1 = lp1 + v1;
+
+		block[0] = (int16_t)dsp_sat16((int32_t)(((int64_t)gx * x0 + (int64_t)glp * lp0) >> (14 + 14)));
+		block[1] = (int16_t)dsp_sat16((int32_t)(((int64_t)gx * x1 + (int64_t)glp * lp1) >> (14 + 14)));
+	}
+
+	rc->s[0] = s0;
+	rc->s[1] = s1;
+	rc->coef = coef_target;
+	rc->gain_x = gain_x_target;
+	rc->gain_lp = gain_lp_target;
+}
+
+int rc_filter_mode_from_name(const char * name)
+{
+	for (int i = 0; i < RC_MODE_COUNT; i++)
+	{
+		if (strcmp(name, rc_mode_names[i]) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * rc_filter_mode_name(rc_mode_t mode)
+{
+	return (mode < RC_MODE_COUNT) ? rc_mode_names[mode] : "?";
+}
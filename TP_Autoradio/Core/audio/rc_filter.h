@@ -0,0 +1,55 @@
+/*
+ * rc_filter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_RC_FILTER_H_
+#define AUDIO_RC_FILTER_H_
+
+#include <stdint.h>
+
+#define RC_CHANNELS 2	// Stereo interleaved blocks
+
+/**
+ * @brief Response of the stage, switching is crossfaded over one block.
+ */
+typedef enum
+{
+	RC_OFF = 0U,
+	RC_LOWPASS,
+	RC_HIGHPASS,
+	RC_MODE_COUNT
+} rc_mode_t;
+
+/**
+ * First order RC filter, bilinear transform with prewarping (topology
+ * preserving form, stable while the cutoff moves):
+ *   v = G (x - s), lp = v + s, s = lp + v, with G = g / (1 + g), g = tan(pi fc / fs)
+ * |H(fc)| is exactly -3 dB like the analog RC, and the high-pass is x - lp,
+ * like the voltage across the resistor. Output = gain_x * x + gain_lp * lp.
+ */
+typedef struct {
+	uint32_t sample_rate;
+	rc_mode_t mode;
+	uint32_t cutoff;			// Hz
+	int32_t coef;				// G in Q31, reached at the end of the previous block
+	volatile int32_t coef_target;
+	int32_t gain_x;				// Q14
+	int32_t gain_lp;			// Q14
+	volatile int32_t gain_x_target;
+	volatile int32_t gain_lp_target;
+	int32_t s[RC_CHANNELS];		// Q29 states
+} rc_filter_t;
+
+void rc_filter_init(rc_filter_t * rc, uint32_t sample_rate);
+void rc_filter_set_mode(rc_filter_t * rc, rc_mode_t mode);
+int rc_filter_set_cutoff(rc_filter_t * rc, uint32_t cutoff);
+void rc_filter_process(rc_filter_t * rc, int16_t * block, uint32_t frames);
+int32_t rc_filter_coef_q31(uint32_t cutoff, uint32_t sample_rate);
+
+int rc_filter_mode_from_name(const char * name);
+const char * rc_filter_mode_name(rc_mode_t mode);
+
+#endif /* AUDIO_RC_FILTER_H_ */
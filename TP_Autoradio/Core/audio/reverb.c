@@ -0,0 +1,285 @@
+/*
+ * reverb.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "reverb.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "../utils/sections.h"
+
+#define REVERB_INPUT_SHIFT 3		// (L + R) / 8, Freeverb's fixed gain is 0.015 * 8 combs
+#define REVERB_WET_SCALE 2.88f		// Freeverb output scale (3 * 0.96) once the combs are averaged
+#define REVERB_Q13_MAX 32767
+
+// Delays in samples at 44.1 kHz (Jezar's tunings, mutually prime)
+static const uint16_t reverb_comb_tunings[8] = {
+		1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617
+};
+static const uint16_t reverb_allpass_tunings[REVERB_ALLPASSES] = {
+		556, 441, 341, 225
+};
+
+
+/**
+ * @brief Runs one comb over a chunk and adds its output to the accumulator.
+ * The line is walked by contiguous segments, so the wrap test is done once
+ * per segment instead of once per sample.
+ */
+static ISR_CODE void reverb_comb(reverb_comb_t * c, const int32_t * in, int32_t * acc,
+		uint32_t frames, int32_t feedback, int32_t damp)
+{
+	const int32_t damp2 = 32768 - damp;
+	int32_t store = c->store;
+	uint32_t index = c->index;
+	uint32_t n = 0;
+
+	while (n < frames)
+	{
+		uint32_t run = c->length - index;
+		int16_t * p = &c->line[index];
+
+		if (run > frames - n) run = frames - n;
+
+		for (uint32_t i = 0; i < run; i++, n++)
+		{
+			int32_t out = p[i];
+
+			store = (out * damp2 + store * damp) >> 15;
+			p[i] = (int16_t)dsp_sat16(in[n] + ((store * feedback) >> 15));
+			acc[n] += out;
+		}
+
+		index += run;
+		if (index == c->length) index = 0;
+	}
+
+	c->index = index;
+	c->store = store;
+}
+
+/**
+ * @brief Runs one allpass (feedback 0.5) over a chunk, in place.
+ */
+static ISR_CODE void reverb_allpass(reverb_allpass_t * a, int32_t * io, uint32_t frames)
+{
+	uint32_t index = a->index;
+	uint32_t n = 0;
+
+	while (n < frames)
+	{
+		uint32_t run = a->length - index;
+		int16_t * p = &a->line[index];
+
+		if (run > frames - n) run = frames - n;
+
+		for (uint32_t i = 0; i < run; i++, n++)
+		{
+			int32_t delayed = p[i];
+			int32_t x = io[n];
+
+			io[n] = dsp_sat16(delayed - x);
+			p[i] = (int16_t)dsp_sat16(x + (delayed >> 1));
+		}
+
+		index += run;
+		if (index == a->length) index = 0;
+	}
+
+	a->index = index;
+}
+
+/**
+ * @brief Carves the lines out of the pool, disabled, room 50 % / damping 50 % / wet 20 %.
+ * @param rv: Effect.
+ * @param pool: REVERB_POOL_SAMPLES samples, owned by the effect from now on.
+ */
+void reverb_init(reverb_t * rv, int16_t * pool)
+{
+	memset(rv, 0, sizeof(*rv));
+
+	for (uint32_t i = 0; i < REVERB_MAX_COMBS; i++)
+	{
+		rv->combs[i].line = pool;
+		rv->combs[i].length = REVERB_TUNE(reverb_comb_tunings[i]);
+		pool += rv->combs[i].length;
+	}
+
+	for (uint32_t ch = 0; ch < 2; ch++)
+	{
+		for (uint32_t i = 0; i < REVERB_ALLPASSES; i++)
+		{
+			rv->allpasses[ch][i].line = pool;
+			rv->allpasses[ch][i].length = REVERB_TUNE(reverb_allpass_tunings[i] + ch * REVERB_STEREO_SPREAD);
+			pool += rv->allpasses[ch][i].length;
+		}
+	}
+
+	rv->active_combs = REVERB_MAX_COMBS;
+	reverb_set_params(rv, 50, 50, 20);
+	reverb_clear(rv);
+}
+
+static void reverb_clear_comb(reverb_comb_t * c)
+{
+	memset(c->line, 0, c->length * sizeof(int16_t));
+	c->index = 0;
+	c->store = 0;
+}
+
+void reverb_clear(reverb_t * rv)
+{
+	for (uint32_t i = 0; i < REVERB_MAX_COMBS; i++)
+	{
+		reverb_clear_comb(&rv->combs[i]);
+	}
+
+	for (uint32_t ch = 0; ch < 2; ch++)
+	{
+		for (uint32_t i = 0; i < REVERB_ALLPASSES; i++)
+		{
+			memset(rv->allpasses[ch][i].line, 0, rv->allpasses[ch][i].length * sizeof(int16_t));
+			rv->allpasses[ch][i].index = 0;
+		}
+	}
+}
+
+/**
+ * @brief Enables or bypasses the effect, the lines are cleared before being enabled
+ * (the audio task does not touch them while bypassed), so that no old tail comes back.
+ */
+void reverb_enable(reverb_t * rv, int enable)
+{
+	if (enable && !rv->enabled)
+	{
+		reverb_clear(rv);
+	}
+	rv->enabled = (enable != 0);
+}
+
+/**
+ * @brief Freeverb controls, each one clamped to 0..100 %.
+ * @param rv: Effect.
+ * @param room: Room size, comb feedback from 0.70 to 0.98.
+ * @param damping: High frequency damping, comb low-pass from 0 to 0.4.
+ * @param wet: Reverberated level, the dry signal stays at 0 dB.
+ */
+void reverb_set_params(reverb_t * rv, int room, int damping, int wet)
+{
+	room = (room < 0) ? 0 : (room > 100) ? 100 : room;
+	damping = (damping < 0) ? 0 : (damping > 100) ? 100 : damping;
+	wet = (wet < 0) ? 0 : (wet > 100) ? 100 : wet;
+
+	float gain = REVERB_WET_SCALE * (float)wet / 100.0f * 8192.0f;
+
+	rv->room = (uint8_t)room;
+	rv->damping = (uint8_t)damping;
+	rv->wet = (uint8_t)wet;
+	rv->feedback = (int32_t)((0.70f + 0.28f * (float)room / 100.0f) * 32768.0f);
+	rv->damp = (int32_t)(0.4f * (float)damping / 100.0f * 32768.0f);
+	rv->wet_gain = (gain > REVERB_Q13_MAX) ? REVERB_Q13_MAX : (int32_t)gain;
+	rv->dry = 32767;
+}
+
+/**
+ * @brief Number of combs run by the audio task, fewer combs cost less CPU
+ * (the pool stays sized for REVERB_MAX_COMBS). The combs brought back are
+ * cleared first (the audio task does not touch them while inactive), so
+ * that they do not replay the tail they held when they were stopped.
+ * @retval int: 0 on success, -1 if out of 1..REVERB_MAX_COMBS.
+ */
+int reverb_set_active_combs(reverb_t * rv, uint32_t combs)
+{
+	if (combs == 0 || combs > REVERB_MAX_COMBS)
+	{
+		return -1;
+	}
+
+	for (uint32_t i = rv->active_combs; i < combs; i++)
+	{
+		reverb_clear_comb(&rv->combs[i]);
+	}
+
+	__atomic_signal_fence(__ATOMIC_RELEASE);	// Cleared before the audio task runs them
+	rv->active_combs = combs;
+
+	return 0;
+}
+
+/**
+ * @brief Bytes of delay lines needed by a build with the given number of combs.
+ */
+uint32_t reverb_memory(uint32_t combs)
+{
+	uint32_t samples = REVERB_ALLPASS_SAMPLES;
+
+	for (uint32_t i = 0; i < combs && i < 8; i++)
+	{
+		samples += REVERB_TUNE(reverb_comb_tunings[i]);
+	}
+
+	return samples * sizeof(int16_t);
+}
+
+/**
+ * @brief Adds the reverberation to one stereo interleaved block in place.
+ * The block is cut into chunks of REVERB_CHUNK frames, and each comb or allpass
+ * runs over a whole chunk before the next one (its state stays in registers).
+ * @param rv: Effect.
+ * @param block: 2 * frames samples.
+ * @param frames: Number of frames.
+ */
+ISR_CODE void reverb_process(reverb_t * rv, int16_t * block, uint32_t frames)
+{
+	if (!rv->enabled)
+	{
+		return;
+	}
+
+	const uint32_t combs = rv->active_combs;
+	const int32_t feedback = rv->feedback, damp = rv->damp;
+	const int32_t wet_gain = rv->wet_gain, dry = rv->dry;
+	const int32_t average = 32768 / (int32_t)combs;
+	int32_t in[REVERB_CHUNK], left[REVERB_CHUNK], right[REVERB_CHUNK];
+
+	while (frames > 0)
+	{
+		uint32_t chunk = (frames > REVERB_CHUNK) ? REVERB_CHUNK : frames;
+
+		for (uint32_t n = 0; n < chunk; n++)
+		{
+			in[n] = ((int32_t)block[2*n] + block[2*n + 1]) >> REVERB_INPUT_SHIFT;
+			left[n] = 0;
+		}
+
+		for (uint32_t i = 0; i < combs; i++)
+		{
+			reverb_comb(&rv->combs[i], in, left, chunk, feedback, damp);
+		}
+
+		for (uint32_t n = 0; n < chunk; n++)
+		{
+			left[n] = (left[n] * average) >> 15;
+			right[n] = left[n];
+		}
+
+		for (uint32_t i = 0; i < REVERB_ALLPASSES; i++)
+		{
+			reverb_allpass(&rv->allpasses[0][i], left, chunk);
+			reverb_allpass(&rv->allpasses[1][i], right, chunk);
+		}
+
+		for (uint32_t n = 0; n < chunk; n++)
+		{
+			block[2*n] = (int16_t)dsp_sat16(((dry * block[2*n]) >> 15) + ((wet_gain * left[n]) >> 13));
+			block[2*n + 1] = (int16_t)dsp_sat16(((dry * block[2*n + 1]) >> 15) + ((wet_gain * right[n]) >> 13));
+		}
+
+		block += 2 * chunk;
+		frames -= chunk;
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * reverb.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_REVERB_H_
+#define AUDIO_REVERB_H_
+
+#include <stdint.h>
+
+/**
+ * Freeverb (Schroeder-Moorer) in fixed point: a bank of parallel low-pass
+ * feedback combs fed with (L + R) / 2, then one chain of series allpasses per
+ * channel, the right one detuned by the stereo spread.
+ * The comb bank is shared by both channels (Freeverb sums L + R at its input
+ * anyway): half the memory of the original for a slightly narrower image.
+ *
+ * Memory (int16_t lines at 48 kHz) and cost, see 'R bench' for the cycles:
+ *   combs   samples (combs + allpasses)   pool
+ *     4      5374 + 3502                 17.3 KB
+ *     6      8545 + 3502                 23.5 KB  (default)
+ *     8     12000 + 3502                 30.3 KB  (original Freeverb density)
+ */
+#define REVERB_MAX_COMBS 6		// Sizes the static pool, 1 to 8
+#define REVERB_ALLPASSES 4
+#define REVERB_SAMPLE_RATE 48000
+#define REVERB_CHUNK 32			// Frames processed at a time (scratch buffers on the stack)
+
+// Freeverb tunings are given at 44.1 kHz
+#define REVERB_TUNE(n) (((n) * REVERB_SAMPLE_RATE + 22050) / 44100)
+#define REVERB_STEREO_SPREAD 23
+
+// Size of the pool given to reverb_init(), in samples
+#define REVERB_COMB_SIZE(i, n) ((REVERB_MAX_COMBS > (i)) ? REVERB_TUNE(n) : 0)
+#define REVERB_COMB_SAMPLES (REVERB_COMB_SIZE(0, 1116) + REVERB_COMB_SIZE(1, 1188)	\
+		+ REVERB_COMB_SIZE(2, 1277) + REVERB_COMB_SIZE(3, 1356) + REVERB_COMB_SIZE(4, 1422)	\
+		+ REVERB_COMB_SIZE(5, 1491) + REVERB_COMB_SIZE(6, 1557) + REVERB_COMB_SIZE(7, 1617))
+#define REVERB_ALLPASS_SIZE(n) (REVERB_TUNE(n) + REVERB_TUNE((n) + REVERB_STEREO_SPREAD))
+#define REVERB_ALLPASS_SAMPLES (REVERB_ALLPASS_SIZE(556) + REVERB_ALLPASS_SIZE(441)	\
+		+ REVERB_ALLPASS_SIZE(341) + REVERB_ALLPASS_SIZE(225))
+#define REVERB_POOL_SAMPLES (REVERB_COMB_SAMPLES + REVERB_ALLPASS_SAMPLES)
+
+typedef struct {
+	int16_t * line;
+	uint32_t length;
+	uint32_t index;
+	int32_t store;				// One-pole low-pass in the feedback path, Q15
+} reverb_comb_t;
+
+typedef struct {
+	int16_t * line;
+	uint32_t length;
+	uint32_t index;
+} reverb_allpass_t;
+
+typedef struct {
+	reverb_comb_t combs[REVERB_MAX_COMBS];
+	reverb_allpass_t allpasses[2][REVERB_ALLPASSES];	// Left, right
+	uint32_t active_combs;
+	volatile int32_t feedback;	// Q15, from the room size
+	volatile int32_t damp;		// Q15, from the damping
+	volatile int32_t wet_gain;	// Q13, includes the Freeverb output scaling
+	volatile int32_t dry;		// Q15
+	uint8_t room;				// %
+	uint8_t damping;			// %
+	uint8_t wet;				// %
+	volatile uint8_t enabled;
+} reverb_t;
+
+void reverb_init(reverb_t * rv, int16_t * pool);
+void reverb_clear(reverb_t * rv);
+void reverb_enable(reverb_t * rv, int enable);
+void reverb_set_params(reverb_t * rv, int room, int damping, int wet);
+int reverb_set_active_combs(reverb_t * rv, uint32_t combs);
+uint32_t reverb_memory(uint32_t combs);
+void reverb_process(reverb_t * rv, int16_t * block, uint32_t frames);
+
+#endif /* AUDIO_REVERB_H_ */
@@ -0,0 +1,291 @@
+/*
+ * siggen.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "siggen.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define SIGGEN_FULL_SCALE 32767.0f
+#define SIGGEN_PINK_SHIFT (8 + 3)	// Q23 -> Q15, and -18 dB to keep the peaks in range
+
+static const char * const siggen_wave_names[SIGGEN_COUNT] = {
+		"sine", "tri", "square", "saw", "white", "pink"
+};
+
+
+/**
+ * @brief Sine from the flash wavetable, linear interpolation (~ -100 dB error).
+ * @param phase: Fraction of a period (2^32 = 1 period).
+ * @retval int32_t: Q15 sample.
+ */
+static inline int32_t siggen_sine(uint32_t phase)
+{
+	uint32_t i = phase >> (32 - SINE_TABLE_BITS);
+	int32_t frac = (phase >> (32 - SINE_TABLE_BITS - 15)) & 0x7FFF;
+	int32_t a = sine_q15[i];
+
+	return a + (((sine_q15[i + 1] - a) * frac) >> 15);
+}
+
+/**
+ * @brief Triangle starting at 0 and rising, peak at 1/4 and trough at 3/4 of the period.
+ */
+static inline int32_t siggen_triangle(uint32_t phase)
+{
+	int32_t v = (int32_t)(phase + 0x40000000U);
+
+	return ((v ^ (v >> 31)) >> 15) - 32768;
+}
+
+static inline uint32_t siggen_xorshift(uint32_t * state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x;
+}
+
+/**
+ * @brief Tells if the phase is less than one sample away from a discontinuity.
+ * @param x: Distance in samples, in (-1, 0) before the edge and [0, 1) after it.
+ * @retval int: 1 if a correction is needed.
+ */
+static inline int siggen_near_edge(uint32_t phase, uint32_t edge, uint32_t inc, float * x)
+{
+	uint32_t after = phase - edge;
+	uint32_t before = edge - phase;
+
+	if (after < inc)
+	{
+		*x = (float)after / (float)inc;
+		return 1;
+	}
+	if (before < inc)
+	{
+		*x = -(float)before / (float)inc;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief PolyBLEP residual of a unit step.
+ */
+static inline float siggen_blep(float x)
+{
+	return (x < 0.0f) ? 0.5f * (x + 1.0f) * (x + 1.0f) : -0.5f * (1.0f - x) * (1.0f - x);
+}
+
+/**
+ * @brief PolyBLAMP residual of a unit slope change (per sample).
+ */
+static inline float siggen_blamp(float x)
+{
+	float r = 1.0f - ((x < 0.0f) ? -x : x);
+
+	return r * r * r * (1.0f / 6.0f);
+}
+
+/**
+ * @brief Resets the generator: 1 kHz sine at -6 dBFS.
+ * @param gen: Generator.
+ * @param sample_rate: Output sample rate in Hz.
+ */
+void siggen_init(siggen_t * gen, uint32_t sample_rate)
+{
+	memset(gen, 0, sizeof(*gen));
+
+	gen->sample_rate = sample_rate;
+	gen->noise = 0x12345678U;
+	gen->amplitude = 16384;
+	siggen_set_frequency(gen, 1000.0f);
+}
+
+void siggen_set_wave(siggen_t * gen, siggen_wave_t wave)
+{
+	if (wave < SIGGEN_COUNT)
+	{
+		gen->wave = wave;
+	}
+}
+
+/**
+ * @brief Sets the frequency, anything between 0 and fs/2 (excluded).
+ * @param gen: Generator.
+ * @param frequency: Frequency in Hz, fractional values allowed.
+ */
+void siggen_set_frequency(siggen_t * gen, float frequency)
+{
+	float nyquist = 0.5f * gen->sample_rate;
+
+	if (frequency < 0.0f) frequency = 0.0f;
+	if (frequency >= nyquist) frequency = nyquist - 1.0f;
+
+	gen->phase_inc = (uint32_t)((double)frequency * 4294967296.0 / gen->sample_rate);
+}
+
+float siggen_frequency(const siggen_t * gen)
+{
+	return (float)((double)gen->phase_inc * gen->sample_rate / 4294967296.0);
+}
+
+void siggen_set_amplitude(siggen_t * gen, int16_t amplitude)
+{
+	gen->amplitude = (amplitude < 0) ? 0 : amplitude;
+}
+
+void siggen_set_band_limited(siggen_t * gen, int enable)
+{
+	gen->band_limited = (enable != 0);
+}
+
+/**
+ * @brief Fills a stereo interleaved block, both channels get the same signal.
+ * Called by the audio task for every DMA half-block, so the phase and the
+ * noise states are continuous from one block to the next.
+ * @param gen: Generator.
+ * @param block: Destination, 2 * frames samples.
+ * @param frames: Number of stereo frames.
+ */
+ISR_CODE void siggen_fill(siggen_t * gen, int16_t * block, uint32_t frames)
+{
+	uint32_t phase = gen->phase;
+	const uint32_t inc = gen->phase_inc;
+	const int32_t amplitude = gen->amplitude;
+	const int band_limited = gen->band_limited && (inc != 0);
+	float x;
+
+#define SIGGEN_OUT(s)														\
+	do {																	\
+		int16_t out = (int16_t)((dsp_sat16(s) * amplitude) >> 15);			\
+		block[0] = out;														\
+		block[1] = out;														\
+		block += 2;															\
+	} while (0)
+
+	switch (gen->wave)
+	{
+	case SIGGEN_SINE:
+		for (uint32_t n = 0; n < frames; n++, phase += inc)
+		{
+			SIGGEN_OUT(siggen_sine(phase));
+		}
+		break;
+
+	case SIGGEN_TRIANGLE:
+	{
+		// Slope change at the corners: 8 * f / fs full scale per sample
+		const float corner = 8.0f * SIGGEN_FULL_SCALE * ((float)inc / 4294967296.0f);
+
+		for (uint32_t n = 0; n < frames; n++, phase += inc)
+		{
+			int32_t s = siggen_triangle(phase);
+
+			if (band_limited)
+			{
+				if (siggen_near_edge(phase, 0x40000000U, inc, &x)) s -= (int32_t)(corner * siggen_blamp(x));
+				if (siggen_near_edge(phase, 0xC0000000U, inc, &x)) s += (int32_t)(corner * siggen_blamp(x));
+			}
+			SIGGEN_OUT(s);
+		}
+		break;
+	}
+
+	case SIGGEN_SQUARE:
+		for (uint32_t n = 0; n < frames; n++, phase += inc)
+		{
+			int32_t s = (phase < 0x80000000U) ? 32767 : -32768;
+
+			if (band_limited)
+			{
+				if (siggen_near_edge(phase, 0x00000000U, inc, &x)) s += (int32_t)(2.0f * SIGGEN_FULL_SCALE * siggen_blep(x));
+				if (siggen_near_edge(phase, 0x80000000U, inc, &x)) s -= (int32_t)(2.0f * SIGGEN_FULL_SCALE * siggen_blep(x));
+			}
+			SIGGEN_OUT(s);
+		}
+		break;
+
+	case SIGGEN_SAW:
+		for (uint32_t n = 0; n < frames; n++, phase += inc)
+		{
+			int32_t s = (int32_t)phase >> 16;	// Rising from 0, falls at 1/2
+
+			if (band_limited && siggen_near_edge(phase, 0x80000000U, inc, &x))
+			{
+				s -= (int32_t)(2.0f * SIGGEN_FULL_SCALE * siggen_blep(x));
+			}
+			SIGGEN_OUT(s);
+		}
+		break;
+
+	case SIGGEN_WHITE:
+		for (uint32_t n = 0; n < frames; n++)
+		{
+			SIGGEN_OUT((int32_t)siggen_xorshift(&gen->noise) >> 16);
+		}
+		break;
+
+	case SIGGEN_PINK:
+	{
+		// Paul Kellet's economy filter (-3 dB/octave within 0.5 dB above 40 Hz at 48 kHz)
+		int32_t b0 = gen->pink[0], b1 = gen->pink[1], b2 = gen->pink[2];
+
+		for (uint32_t n = 0; n < frames; n++)
+		{
+			int32_t white = (int32_t)siggen_xorshift(&gen->noise) >> 16;	// Q15
+
+			b0 = (int32_t)(((int64_t)b0 * 32691) >> 15) + ((white * 3246) >> 7);	// 0.99765, 0.0990460
+			b1 = (int32_t)(((int64_t)b1 * 31556) >> 15) + ((white * 9716) >> 7);	// 0.96300, 0.2965164
+			b2 = (int32_t)(((int64_t)b2 * 18678) >> 15) + ((white * 34494) >> 7);	// 0.57000, 1.0526913
+			SIGGEN_OUT((b0 + b1 + b2 + ((white * 6056) >> 7)) >> SIGGEN_PINK_SHIFT);	// 0.1848
+		}
+		gen->pink[0] = b0;
+		gen->pink[1] = b1;
+		gen->pink[2] = b2;
+		break;
+	}
+
+	default:
+		memset(block, 0, 2 * frames * sizeof(int16_t));
+		break;
+	}
+
+#undef SIGGEN_OUT
+
+	gen->phase = phase;
+}
+
+/**
+ * @brief Looks up a waveform by its shell name.
+ * @retval int: The waveform, or -1 if the name is unknown.
+ */
+int siggen_wave_from_name(const char * name)
+{
+	for (int i = 0; i < SIGGEN_COUNT; i++)
+	{
+		if (strcmp(name, siggen_wave_names[i]) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * siggen_wave_name(siggen_wave_t wave)
+{
+	return (wave < SIGGEN_COUNT) ? siggen_wave_names[wave] : "?";
+}
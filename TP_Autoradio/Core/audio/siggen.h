@@ -0,0 +1,49 @@
+/*
+ * siggen.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_SIGGEN_H_
+#define AUDIO_SIGGEN_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Waveforms of the test signal generator.
+ */
+typedef enum
+{
+	SIGGEN_SINE = 0U,
+	SIGGEN_TRIANGLE,
+	SIGGEN_SQUARE,
+	SIGGEN_SAW,
+	SIGGEN_WHITE,
+	SIGGEN_PINK,
+	SIGGEN_COUNT
+} siggen_wave_t;
+
+typedef struct {
+	siggen_wave_t wave;
+	uint8_t band_limited;	// PolyBLEP/BLAMP correction of the discontinuities
+	uint32_t sample_rate;
+	uint32_t phase;			// Fraction of a period, wraps at 2^32
+	uint32_t phase_inc;		// f * 2^32 / fs
+	int16_t amplitude;		// Q15
+	uint32_t noise;			// xorshift32 state, never 0
+	int32_t pink[3];		// Pink noise filter states, Q23
+} siggen_t;
+
+void siggen_init(siggen_t * gen, uint32_t sample_rate);
+void siggen_set_wave(siggen_t * gen, siggen_wave_t wave);
+void siggen_set_frequency(siggen_t * gen, float frequency);
+void siggen_set_amplitude(siggen_t * gen, int16_t amplitude);
+void siggen_set_band_limited(siggen_t * gen, int enable);
+void siggen_fill(siggen_t * gen, int16_t * block, uint32_t frames);
+
+int siggen_wave_from_name(const char * name);
+const char * siggen_wave_name(siggen_wave_t wave);
+float siggen_frequency(const siggen_t * gen);
+
+#endif /* AUDIO_SIGGEN_H_ */
@@ -0,0 +1,148 @@
+/*
+ * spectrum.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "spectrum.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define SPECTRUM_LEVELS (SPECTRUM_LEDS / SPECTRUM_BANDS)	// LEDs per band
+#define SPECTRUM_WINDOW_GAIN LEVEL_DB(6)	// Hann window halves a sine on a bin
+#define SPECTRUM_RELEASE LEVEL_DB(SPECTRUM_RELEASE_DB_S * SPECTRUM_PERIOD_MS / 1000.0)
+
+
+/**
+ * @brief Log-spaced bands from SPECTRUM_LOW_HZ to fs / 2, each one at least one bin wide.
+ */
+void spectrum_init(spectrum_t * sp, uint32_t sample_rate)
+{
+	const float bin_hz = (float)sample_rate / SPECTRUM_FFT_SIZE;
+	const uint32_t bins = SPECTRUM_FFT_SIZE / 2;
+	const float low = SPECTRUM_LOW_HZ / bin_hz;
+	const float ratio = powf((float)bins / low, 1.0f / SPECTRUM_BANDS);
+
+	memset(sp, 0, sizeof(*sp));
+
+	// Lower edge of band b at low * ratio^(b - 1/2), bin 0 (DC) is left out
+	sp->edges[0] = 1;
+	for (uint32_t b = 1; b <= SPECTRUM_BANDS; b++)
+	{
+		uint32_t edge = (uint32_t)(low * powf(ratio, (float)b - 0.5f) + 0.5f);
+
+		if (edge <= sp->edges[b - 1]) edge = sp->edges[b - 1] + 1;
+		sp->edges[b] = (edge > bins) ? bins : edge;
+		sp->band[b - 1] = LEVEL_DB_MIN;
+	}
+	sp->edges[SPECTRUM_BANDS] = bins;
+}
+
+/**
+ * @brief Starts or stops the capture by the audio task.
+ */
+void spectrum_enable(spectrum_t * sp, int enable)
+{
+	sp->enabled = (enable != 0);
+}
+
+/**
+ * @brief Audio task side: appends the mono mix of a stereo interleaved block to the ring.
+ */
+ISR_CODE void spectrum_capture(spectrum_t * sp, const int16_t * block, uint32_t frames)
+{
+	if (!sp->enabled)
+	{
+		return;
+	}
+
+	uint32_t write = sp->write;
+
+	for (uint32_t n = 0; n < frames; n++)
+	{
+		sp->capture[write] = (int16_t)(((int32_t)block[2*n] + block[2*n + 1]) >> 1);
+		write = (write + 1) & (SPECTRUM_FFT_SIZE - 1);
+	}
+
+	sp->write = write;
+}
+
+/**
+ * @brief Copies the last SPECTRUM_FFT_SIZE samples in time order.
+ * To be called with the audio task held off (critical section), it is short.
+ */
+void spectrum_snapshot(spectrum_t * sp)
+{
+	uint32_t read = sp->write;
+
+	for (uint32_t n = 0; n < SPECTRUM_FFT_SIZE; n++)
+	{
+		sp->fft[n] = sp->capture[read];
+		read = (read + 1) & (SPECTRUM_FFT_SIZE - 1);
+	}
+}
+
+/**
+ * @brief Display task side: Hann window, FFT and bands of the last snapshot.
+ * A band rises at once to its loudest bin and falls at SPECTRUM_RELEASE_DB_S.
+ */
+void spectrum_update(spectrum_t * sp)
+{
+	const uint32_t step = SINE_TABLE_SIZE / SPECTRUM_FFT_SIZE;
+
+	for (uint32_t n = 0; n < SPECTRUM_FFT_SIZE; n++)
+	{
+		int32_t w = (32768 - sine_q15[(n * step + SINE_TABLE_SIZE / 4) & (SINE_TABLE_SIZE - 1)]) >> 1;
+
+		sp->fft[n] = (sp->fft[n] * w) >> 15;
+	}
+
+	fft_real_q15(sp->fft, SPECTRUM_FFT_SIZE);
+
+	for (uint32_t b = 0; b < SPECTRUM_BANDS; b++)
+	{
+		uint32_t peak = 0;
+
+		for (uint32_t k = sp->edges[b]; k < sp->edges[b + 1]; k++)
+		{
+			int32_t re = sp->fft[2*k], im = sp->fft[2*k + 1];
+			uint32_t power = (uint32_t)(re * re) + (uint32_t)(im * im);
+
+			peak = (power > peak) ? power : peak;
+		}
+
+		// Power in Q30: 10 log10(P / 2^30) = (20 log10(P) - 20 log10(2^30)) / 2
+		int32_t db = (level_to_db(peak) - level_to_db(1U << 30)) / 2 + SPECTRUM_WINDOW_GAIN;
+		int32_t fall = sp->band[b] - SPECTRUM_RELEASE;
+
+		sp->band[b] = (db > fall) ? db : fall;
+	}
+}
+
+/**
+ * @brief LED pattern of the bands, 1 = on, LED j * SPECTRUM_BANDS + b for step j of band b.
+ */
+uint16_t spectrum_leds(const spectrum_t * sp)
+{
+	uint16_t leds = 0;
+
+	for (uint32_t b = 0; b < SPECTRUM_BANDS; b++)
+	{
+		for (uint32_t j = 0; j < SPECTRUM_LEVELS; j++)
+		{
+			int32_t threshold = LEVEL_DB(-SPECTRUM_RANGE_DB) + (int32_t)j * LEVEL_DB(SPECTRUM_RANGE_DB) / SPECTRUM_LEVELS;
+
+			if (sp->band[b] > threshold)
+			{
+				leds |= 1U << (j * SPECTRUM_BANDS + b);
+			}
+		}
+	}
+
+	return leds;
+}
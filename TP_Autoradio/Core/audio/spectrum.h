@@ -0,0 +1,48 @@
+/*
+ * spectrum.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_SPECTRUM_H_
+#define AUDIO_SPECTRUM_H_
+
+#include <stdint.h>
+
+#include "fft.h"
+#include "level.h"
+
+/**
+ * Spectrum analyser for the LED bar.
+ * The audio task only copies the mono output into a ring (spectrum_capture());
+ * the display task takes a snapshot at its own rate, then windows it, runs
+ * the FFT and reduces the bins to log-spaced bands with falling ballistics.
+ * With 16 bands each LED is one band, with 8 bands each band has two LEDs
+ * (GPA for the first step, GPB for the second).
+ */
+#define SPECTRUM_FFT_SIZE 512			// 93.75 Hz bins at 48 kHz, see fft_valid_size()
+#define SPECTRUM_BANDS 16				// 8 or 16
+#define SPECTRUM_LEDS 16
+#define SPECTRUM_PERIOD_MS 40			// Display rate of the FFT (25 Hz)
+#define SPECTRUM_RANGE_DB 48			// Lowest level shown
+#define SPECTRUM_RELEASE_DB_S 30		// Fall rate of a band
+#define SPECTRUM_LOW_HZ 100.0f			// Centre of the first band
+
+typedef struct {
+	int16_t capture[SPECTRUM_FFT_SIZE];	// Mono ring written by the audio task
+	uint32_t write;
+	int32_t fft[SPECTRUM_FFT_SIZE];		// Snapshot, then bins
+	uint16_t edges[SPECTRUM_BANDS + 1];	// First bin of each band, then the end
+	int32_t band[SPECTRUM_BANDS];		// Q8 dB, with ballistics
+	volatile uint8_t enabled;
+} spectrum_t;
+
+void spectrum_init(spectrum_t * sp, uint32_t sample_rate);
+void spectrum_enable(spectrum_t * sp, int enable);
+void spectrum_capture(spectrum_t * sp, const int16_t * block, uint32_t frames);
+void spectrum_snapshot(spectrum_t * sp);
+void spectrum_update(spectrum_t * sp);
+uint16_t spectrum_leds(const spectrum_t * sp);
+
+#endif /* AUDIO_SPECTRUM_H_ */
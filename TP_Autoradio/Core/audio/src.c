@@ -0,0 +1,194 @@
+/*
+ * src.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "src.h"
+
+#include <string.h>
+
+#include "dsp.h"
+#include "tables.h"
+#include "../utils/sections.h"
+
+#define SRC_FRAC_BITS 15						// Interpolation between two rows
+#define SRC_KP (16 * 256)						// 1/256 ppm per frame of FIFO error
+#define SRC_KI 4								// 1/256 ppm per frame per call
+#define SRC_INTEGRAL_MAX (SRC_MAX_PPM * 256)
+
+static const struct {
+	const char * name;
+	const int16_t * coefs;
+	uint32_t taps;
+} src_presets[SRC_QUALITY_COUNT] = {
+		{ "fast", src_coefs_8, 8 },
+		{ "medium", src_coefs_16, 16 },
+		{ "best", src_coefs_32, 32 },
+};
+
+
+static inline int32_t src_clamp(int32_t x, int32_t min, int32_t max)
+{
+	return (x < min) ? min : (x > max) ? max : x;
+}
+
+/**
+ * @brief Ratio in use: nominal * (1 + correction / (256 * 10^6)).
+ */
+static void src_update_step(src_t * s)
+{
+	s->step = s->nominal + (uint64_t)(((int64_t)s->nominal * s->correction) / (256LL * 1000000LL));
+}
+
+/**
+ * @brief Converts from fs_in to fs_out, history cleared, no correction.
+ */
+void src_init(src_t * s, uint32_t fs_in, uint32_t fs_out, src_quality_t quality)
+{
+	memset(s, 0, sizeof(*s));
+
+	s->nominal = ((uint64_t)fs_in << 32) / fs_out;
+	src_set_quality(s, quality);
+}
+
+/**
+ * @brief Clears the history and the drift controller. The next output is
+ * computed at once, on a window of silence: the first taps outputs fade in
+ * as the new inputs fill it.
+ */
+void src_reset(src_t * s)
+{
+	memset(s->history, 0, sizeof(s->history));
+	s->head = 0;
+	s->need = 0;
+	s->frac = 0;
+	s->integral = 0;
+	s->correction = 0;
+	src_update_step(s);
+}
+
+/**
+ * @brief Selects the filter length, the history is cleared.
+ * Not to be called while src_process() runs.
+ */
+void src_set_quality(src_t * s, src_quality_t quality)
+{
+	if (quality >= SRC_QUALITY_COUNT)
+	{
+		quality = SRC_MEDIUM;
+	}
+
+	s->quality = quality;
+	s->coefs = src_presets[quality].coefs;
+	s->taps = src_presets[quality].taps;
+	src_reset(s);
+}
+
+/**
+ * @brief Converts as many frames as possible.
+ * @param s: Converter.
+ * @param in: Input frames, stereo interleaved.
+ * @param in_frames: Number of input frames available.
+ * @param consumed: Number of input frames used, the caller drops them.
+ * @param out: Output frames, stereo interleaved.
+ * @param out_frames: Room in the output.
+ * @retval uint32_t: Number of output frames written, less than out_frames
+ * only if the input ran out.
+ */
+ISR_CODE uint32_t src_process(src_t * s, const int16_t * in, uint32_t in_frames, uint32_t * consumed,
+		int16_t * out, uint32_t out_frames)
+{
+	const uint32_t taps = s->taps;
+	uint32_t used = 0;
+	uint32_t produced = 0;
+
+	while (produced < out_frames)
+	{
+		for (; s->need > 0; s->need--, used++)
+		{
+			if (used == in_frames)
+			{
+				*consumed = used;
+				return produced;
+			}
+
+			s->history[0][s->head] = s->history[0][s->head + taps] = in[SRC_CHANNELS * used];
+			s->history[1][s->head] = s->history[1][s->head + taps] = in[SRC_CHANNELS * used + 1];
+			s->head = (s->head + 1 == taps) ? 0 : s->head + 1;
+		}
+
+		// Row of the phase and fraction towards the next row
+		const uint32_t p = s->frac >> (32 - SRC_PHASE_BITS);
+		const int32_t mu = (s->frac >> (32 - SRC_PHASE_BITS - SRC_FRAC_BITS)) & ((1 << SRC_FRAC_BITS) - 1);
+		const int16_t * a = &s->coefs[p * taps];
+		const int16_t * b = a + taps;
+		const int16_t * xl = &s->history[0][s->head];
+		const int16_t * xr = &s->history[1][s->head];
+		int64_t accl = 1 << 14, accr = 1 << 14;
+
+		for (uint32_t t = 0; t < taps; t++)
+		{
+			int32_t c = a[t] + (((b[t] - a[t]) * mu) >> SRC_FRAC_BITS);
+
+			accl = dsp_mlal(accl, c, xl[t]);
+			accr = dsp_mlal(accr, c, xr[t]);
+		}
+
+		out[SRC_CHANNELS * produced] = (int16_t)dsp_sat16((int32_t)(accl >> 15));
+		out[SRC_CHANNELS * produced + 1] = (int16_t)dsp_sat16((int32_t)(accr >> 15));
+		produced++;
+
+		uint64_t position = (uint64_t)s->frac + s->step;
+
+		s->frac = (uint32_t)position;
+		s->need = (uint32_t)(position >> 32);
+	}
+
+	*consumed = used;
+	return produced;
+}
+
+/**
+ * @brief Drift compensation, once per block after src_process(): a PI
+ * controller trims the ratio so that the input FIFO stays at its target.
+ * A fuller FIFO means the source is faster, the ratio goes up.
+ * @param s: Converter.
+ * @param fill: Frames left in the input FIFO.
+ * @param target: Level to keep, half the FIFO for the same margin both ways.
+ */
+void src_track(src_t * s, uint32_t fill, uint32_t target)
+{
+	int32_t error = (int32_t)fill - (int32_t)target;
+
+	s->integral = src_clamp(s->integral + error * SRC_KI, -SRC_INTEGRAL_MAX, SRC_INTEGRAL_MAX);
+	s->correction = src_clamp(error * SRC_KP + s->integral, -SRC_INTEGRAL_MAX, SRC_INTEGRAL_MAX);
+	src_update_step(s);
+}
+
+/**
+ * @brief Current correction of the ratio, in ppm.
+ */
+int32_t src_correction_ppm(const src_t * s)
+{
+	return s->correction / 256;
+}
+
+int src_quality_from_name(const char * name)
+{
+	for (int i = 0; i < SRC_QUALITY_COUNT; i++)
+	{
+		if (strcmp(name, src_presets[i].name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * src_quality_name(src_quality_t quality)
+{
+	return (quality < SRC_QUALITY_COUNT) ? src_presets[quality].name : "?";
+}
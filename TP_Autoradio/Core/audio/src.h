@@ -0,0 +1,60 @@
+/*
+ * src.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_SRC_H_
+#define AUDIO_SRC_H_
+
+#include <stdint.h>
+
+/**
+ * Asynchronous sample rate converter, stereo interleaved Q15.
+ * Polyphase windowed sinc read from flash (tables.c), SRC_PHASES rows per
+ * input sample, the coefficients are linearly interpolated between two rows
+ * so the ratio can be any value and can be trimmed while running.
+ * The output block is always filled from whatever input is available: the
+ * caller gets back the number of input frames consumed, and src_track()
+ * keeps the level of its input FIFO in the middle by adjusting the ratio
+ * (drift between the two clocks).
+ */
+#define SRC_CHANNELS 2
+#define SRC_MAX_TAPS 32
+#define SRC_MAX_PPM 1000		// Largest correction of the ratio by src_track()
+
+typedef enum
+{
+	SRC_FAST = 0U,		// 8 taps
+	SRC_MEDIUM,			// 16 taps
+	SRC_BEST,			// 32 taps
+	SRC_QUALITY_COUNT
+} src_quality_t;
+
+typedef struct {
+	src_quality_t quality;
+	const int16_t * coefs;		// (SRC_PHASES + 1) rows of 'taps'
+	uint32_t taps;
+	int16_t history[SRC_CHANNELS][2 * SRC_MAX_TAPS];	// Each input written twice, the window is contiguous
+	uint32_t head;				// Oldest input of the window
+	uint32_t need;				// Inputs to take before the next output
+	uint32_t frac;				// Position of the next output after the centre, Q32
+	uint64_t nominal;			// fs_in / fs_out, Q32.32
+	uint64_t step;				// Ratio in use, nominal trimmed by the correction
+	int32_t integral;			// src_track() state, frames * blocks
+	int32_t correction;			// 1/256 ppm
+} src_t;
+
+void src_init(src_t * s, uint32_t fs_in, uint32_t fs_out, src_quality_t quality);
+void src_reset(src_t * s);
+void src_set_quality(src_t * s, src_quality_t quality);
+uint32_t src_process(src_t * s, const int16_t * in, uint32_t in_frames, uint32_t * consumed,
+		int16_t * out, uint32_t out_frames);
+void src_track(src_t * s, uint32_t fill, uint32_t target);
+int32_t src_correction_ppm(const src_t * s);
+
+int src_quality_from_name(const char * name);
+const char * src_quality_name(src_quality_t quality);
+
+#endif /* AUDIO_SRC_H_ */
@@ -0,0 +1,316 @@
+/*
+ * tables.c
+ *
+ *  Generated by tools/gen_tables.py, do not edit.
+ */
+
+#include "tables.h"
+
+const int16_t sine_q15[SINE_TABLE_SIZE + 1] = {
+		     0,    201,    402,    603,    804,   1005,   1206,   1407,   1608,   1809,   2009,   2210,
+		  2411,   2611,   2811,   3012,   3212,   3412,   3612,   3812,   4011,   4211,   4410,   4609,
+		  4808,   5007,   5205,   5404,   5602,   5800,   5998,   6195,   6393,   6590,   6787,   6983,
+		  7180,   7376,   7571,   7767,   7962,   8157,   8351,   8546,   8740,   8933,   9127,   9319,
+		  9512,   9704,   9896,  10088,  10279,  10469,  10660,  10850,  11039,  11228,  11417,  11605,
+		 11793,  11980,  12167,  12354,  12540,  12725,  12910,  13095,  13279,  13463,  13646,  13828,
+		 14010,  14192,  14373,  14553,  14733,  14912,  15091,  15269,  15447,  15624,  15800,  15976,
+		 16151,  16326,  16500,  16673,  16846,  17018,  17190,  17361,  17531,  17700,  17869,  18037,
+		 18205,  18372,  18538,  18703,  18868,  19032,  19195,  19358,  19520,  19681,  19841,  20001,
+		 20160,  20318,  20475,  20632,  20788,  20943,  21097,  21251,  21403,  21555,  21706,  21856,
+		 22006,  22154,  22302,  22449,  22595,  22740,  22884,  23028,  23170,  23312,  23453,  23593,
+		 23732,  23870,  24008,  24144,  24279,  24414,  24548,  24680,  24812,  24943,  25073,  25202,
+		 25330,  25457,  25583,  25708,  25833,  25956,  26078,  26199,  26320,  26439,  26557,  26674,
+		 26791,  26906,  27020,  27133,  27246,  27357,  27467,  27576,  27684,  27791,  27897,  28002,
+		 28106,  28209,  28311,  28411,  28511,  28610,  28707,  28803,  28899,  28993,  29086,  29178,
+		 29269,  29359,  29448,  29535,  29622,  29707,  29792,  29875,  29957,  30038,  30118,  30196,
+		 30274,  30350,  30425,  30499,  30572,  30644,  30715,  30784,  30853,  30920,  30986,  31050,
+		 31114,  31177,  31238,  31298,  31357,  31415,  31471,  31527,  31581,  31634,  31686,  31737,
+		 31786,  31834,  31881,  31927,  31972,  32015,  32058,  32099,  32138,  32177,  32214,  32251,
+		 32286,  32319,  32352,  32383,  32413,  32442,  32470,  32496,  32522,  32546,  32568,  32590,
+		 32610,  32629,  32647,  32664,  32679,  32693,  32706,  32718,  32729,  32738,  32746,  32753,
+		 32758,  32762,  32766,  32767,  32767,  32767,  32766,  32762,  32758,  32753,  32746,  32738,
+		 32729,  32718,  32706,  32693,  32679,  32664,  32647,  32629,  32610,  32590,  32568,  32546,
+		 32522,  32496,  32470,  32442,  32413,  32383,  32352,  32319,  32286,  32251,  32214,  32177,
+		 32138,  32099,  32058,  32015,  31972,  31927,  31881,  31834,  31786,  31737,  31686,  31634,
+		 31581,  31527,  31471,  31415,  31357,  31298,  31238,  31177,  31114,  31050,  30986,  30920,
+		 30853,  30784,  30715,  30644,  30572,  30499,  30425,  30350,  30274,  30196,  30118,  30038,
+		 29957,  29875,  29792,  29707,  29622,  29535,  29448,  29359,  29269,  29178,  29086,  28993,
+		 28899,  28803,  28707,  28610,  28511,  28411,  28311,  28209,  28106,  28002,  27897,  27791,
+		 27684,  27576,  27467,  27357,  27246,  27133,  27020,  26906,  26791,  26674,  26557,  26439,
+		 26320,  26199,  26078,  25956,  25833,  25708,  25583,  25457,  25330,  25202,  25073,  24943,
+		 24812,  24680,  24548,  24414,  24279,  24144,  24008,  23870,  23732,  23593,  23453,  23312,
+		 23170,  23028,  22884,  22740,  22595,  22449,  22302,  22154,  22006,  21856,  21706,  21555,
+		 21403,  21251,  21097,  20943,  20788,  20632,  20475,  20318,  20160,  20001,  19841,  19681,
+		 19520,  19358,  19195,  19032,  18868,  18703,  18538,  18372,  18205,  18037,  17869,  17700,
+		 17531,  17361,  17190,  17018,  16846,  16673,  16500,  16326,  16151,  15976,  15800,  15624,
+		 15447,  15269,  15091,  14912,  14733,  14553,  14373,  14192,  14010,  13828,  13646,  13463,
+		 13279,  13095,  12910,  12725,  12540,  12354,  12167,  11980,  11793,  11605,  11417,  11228,
+		 11039,  10850,  10660,  10469,  10279,  10088,   9896,   9704,   9512,   9319,   9127,   8933,
+		  8740,   8546,   8351,   8157,   7962,   7767,   7571,   7376,   7180,   6983,   6787,   6590,
+		  6393,   6195,   5998,   5800,   5602,   5404,   5205,   5007,   4808,   4609,   4410,   4211,
+		  4011,   3812,   3612,   3412,   3212,   3012,   2811,   2611,   2411,   2210,   2009,   1809,
+		  1608,   1407,   1206,   1005,    804,    603,    402,    201,      0,   -201,   -402,   -603,
+		  -804,  -1005,  -1206,  -1407,  -1608,  -1809,  -2009,  -2210,  -2411,  -2611,  -2811,  -3012,
+		 -3212,  -3412,  -3612,  -3812,  -4011,  -4211,  -4410,  -4609,  -4808,  -5007,  -5205,  -5404,
+		 -5602,  -5800,  -5998,  -6195,  -6393,  -6590,  -6787,  -6983,  -7180,  -7376,  -7571,  -7767,
+		 -7962,  -8157,  -8351,  -8546,  -8740,  -8933,  -9127,  -9319,  -9512,  -9704,  -9896, -10088,
+		-10279, -10469, -10660, -10850, -11039, -11228, -11417, -11605, -11793, -11980, -12167, -12354,
+		-12540, -12725, -12910, -13095, -13279, -13463, -13646, -13828, -14010, -14192, -14373, -14553,
+		-14733, -14912, -15091, -15269, -15447, -15624, -15800, -15976, -16151, -16326, -16500, -16673,
+		-16846, -17018, -17190, -17361, -17531, -17700, -17869, -18037, -18205, -18372, -18538, -18703,
+		-18868, -19032, -19195, -19358, -19520, -19681, -19841, -20001, -20160, -20318, -20475, -20632,
+		-20788, -20943, -21097, -21251, -21403, -21555, -21706, -21856, -22006, -22154, -22302, -22449,
+		-22595, -22740, -22884, -23028, -23170, -23312, -23453, -23593, -23732, -23870, -24008, -24144,
+		-24279, -24414, -24548, -24680, -24812, -24943, -25073, -25202, -25330, -25457, -25583, -25708,
+		-25833, -25956, -26078, -26199, -26320, -26439, -26557, -26674, -26791, -26906, -27020, -27133,
+		-27246, -27357, -27467, -27576, -27684, -27791, -27897, -28002, -28106, -28209, -28311, -28411,
+		-28511, -28610, -28707, -28803, -28899, -28993, -29086, -29178, -29269, -29359, -29448, -29535,
+		-29622, -29707, -29792, -29875, -29957, -30038, -30118, -30196, -30274, -30350, -30425, -30499,
+		-30572, -30644, -30715, -30784, -30853, -30920, -30986, -31050, -31114, -31177, -31238, -31298,
+		-31357, -31415, -31471, -31527, -31581, -31634, -31686, -31737, -31786, -31834, -31881, -31927,
+		-31972, -32015, -32058, -32099, -32138, -32177, -32214, -32251, -32286, -32319, -32352, -32383,
+		-32413, -32442, -32470, -32496, -32522, -32546, -32568, -32590, -32610, -32629, -32647, -32664,
+		-32679, -32693, -32706, -32718, -32729, -32738, -32746, -32753, -32758, -32762, -32766, -32767,
+		-32768, -32767, -32766, -32762, -32758, -32753, -32746, -32738, -32729, -32718, -32706, -32693,
+		-32679, -32664, -32647, -32629, -32610, -32590, -32568, -32546, -32522, -32496, -32470, -32442,
+		-32413, -32383, -32352, -32319, -32286, -32251, -32214, -32177, -32138, -32099, -32058, -32015,
+		-31972, -31927, -31881, -31834, -31786, -31737, -31686, -31634, -31581, -31527, -31471, -31415,
+		-31357, -31298, -31238, -31177, -31114, -31050, -30986, -30920, -30853, -30784, -30715, -30644,
+		-30572, -30499, -30425, -30350, -30274, -30196, -30118, -30038, -29957, -29875, -29792, -29707,
+		-29622, -29535, -29448, -29359, -29269, -29178, -29086, -28993, -28899, -28803, -28707, -28610,
+		-28511, -28411, -28311, -28209, -28106, -28002, -27897, -27791, -27684, -27576, -27467, -27357,
+		-27246, -27133, -27020, -26906, -26791, -26674, -26557, -26439, -26320, -26199, -26078, -25956,
+		-25833, -25708, -25583, -25457, -25330, -25202, -25073, -24943, -24812, -24680, -24548, -24414,
+		-24279, -24144, -24008, -23870, -23732, -23593, -23453, -23312, -23170, -23028, -22884, -22740,
+		-22595, -22449, -22302, -22154, -22006, -21856, -21706, -21555, -21403, -21251, -21097, -20943,
+		-20788, -20632, -20475, -20318, -20160, -20001, -19841, -19681, -19520, -19358, -19195, -19032,
+		-18868, -18703, -18538, -18372, -18205, -18037, -17869, -17700, -17531, -17361, -17190, -17018,
+		-16846, -16673, -16500, -16326, -16151, -15976, -15800, -15624, -15447, -15269, -15091, -14912,
+		-14733, -14553, -14373, -14192, -14010, -13828, -13646, -13463, -13279, -13095, -12910, -12725,
+		-12540, -12354, -12167, -11980, -11793, -11605, -11417, -11228, -11039, -10850, -10660, -10469,
+		-10279, -10088,  -9896,  -9704,  -9512,  -9319,  -9127,  -8933,  -8740,  -8546,  -8351,  -8157,
+		 -7962,  -7767,  -7571,  -7376,  -7180,  -6983,  -6787,  -6590,  -6393,  -6195,  -5998,  -5800,
+		 -5602,  -5404,  -5205,  -5007,  -4808,  -4609,  -4410,  -4211,  -4011,  -3812,  -3612,  -3412,
+		 -3212,  -3012,  -2811,  -2611,  -2411,  -2210,  -2009,  -1809,  -1608,  -1407,  -1206,  -1005,
+		  -804,   -603,   -402,   -201,      0,
+};
+
+const uint32_t log2_q16[LOG2_TABLE_SIZE + 1] = {
+		         0,       2909,       5732,       8473,      11136,      13727,      16248,      18704,
+		     21098,      23433,      25711,      27936,      30109,      32234,      34312,      36346,
+		     38336,      40286,      42196,      44068,      45904,      47705,      49472,      51207,
+		     52911,      54584,      56229,      57845,      59434,      60997,      62534,      64047,
+		     65536,
+};
+
+const uint32_t exp2_q30[LOG2_TABLE_SIZE + 1] = {
+		1073741824, 1097253708, 1121280436, 1145833280, 1170923762, 1196563654, 1222764986, 1249540052,
+		1276901417, 1304861917, 1333434672, 1362633090, 1392470869, 1422962010, 1454120821, 1485961921,
+		1518500250, 1551751076, 1585730000, 1620452965, 1655936265, 1692196547, 1729250827, 1767116489,
+		1805811301, 1845353420, 1885761398, 1927054196, 1969251188, 2012372174, 2056437387, 2101467502,
+		2147483648,
+};
+
+const int16_t src_coefs_8[(SRC_PHASES + 1) * 8] = {
+		   547,  -3253,   7222,  23651,   7222,  -3253,    547,     85,
+		   571,  -3222,   6872,  23638,   7570,  -3278,    521,     96,
+		   592,  -3187,   6526,  23614,   7921,  -3299,    493,    107,
+		   612,  -3148,   6184,  23579,   8274,  -3315,    464,    119,
+		   630,  -3106,   5845,  23534,   8629,  -3328,    432,    131,
+		   647,  -3061,   5511,  23477,   8986,  -3335,    399,    144,
+		   661,  -3013,   5182,  23410,   9345,  -3338,    363,    157,
+		   674,  -2961,   4857,  23333,   9705,  -3336,    326,    170,
+		   685,  -2907,   4536,  23245,  10066,  -3328,    287,    184,
+		   695,  -2850,   4221,  23146,  10428,  -3316,    246,    198,
+		   703,  -2791,   3911,  23037,  10790,  -3298,    203,    213,
+		   709,  -2729,   3606,  22918,  11153,  -3275,    158,    228,
+		   714,  -2665,   3307,  22789,  11515,  -3247,    111,    243,
+		   718,  -2599,   3013,  22650,  11878,  -3212,     62,    259,
+		   720,  -2532,   2725,  22501,  12240,  -3172,     11,    275,
+		   721,  -2462,   2443,  22342,  12600,  -3126,    -41,    291,
+		   720,  -2392,   2168,  22173,  12960,  -3073,    -95,    307,
+		   718,  -2319,   1898,  21995,  13318,  -3015,   -151,    324,
+		   715,  -2246,   1635,  21808,  13675,  -2950,   -209,    341,
+		   711,  -2171,   1378,  21611,  14029,  -2879,   -268,    358,
+		   705,  -2096,   1127,  21406,  14382,  -2802,   -329,    375,
+		   699,  -2020,    884,  21192,  14731,  -2718,   -392,    392,
+		   691,  -1943,    647,  20969,  15078,  -2627,   -456,    409,
+		   683,  -1865,    416,  20739,  15421,  -2530,   -521,    426,
+		   674,  -1788,    193,  20499,  15761,  -2426,   -588,    443,
+		   663,  -1710,    -24,  20252,  16097,  -2315,   -657,    460,
+		   652,  -1631,   -233,  19998,  16429,  -2197,   -727,    477,
+		   641,  -1553,   -436,  19736,  16757,  -2072,   -797,    493,
+		   628,  -1475,   -631,  19466,  17080,  -1940,   -869,    510,
+		   615,  -1398,   -820,  19190,  17399,  -1802,   -942,    526,
+		   601,  -1320,  -1001,  18907,  17712,  -1656,  -1016,    542,
+		   587,  -1243,  -1175,  18617,  18019,  -1503,  -1091,    557,
+		   573,  -1167,  -1343,  18321,  18321,  -1343,  -1167,    573,
+		   557,  -1091,  -1503,  18019,  18617,  -1175,  -1243,    587,
+		   542,  -1016,  -1656,  17712,  18907,  -1001,  -1320,    601,
+		   526,   -942,  -1802,  17399,  19190,   -820,  -1398,    615,
+		   510,   -869,  -1940,  17080,  19466,   -631,  -1475,    628,
+		   493,   -797,  -2072,  16757,  19736,   -436,  -1553,    641,
+		   477,   -727,  -2197,  16429,  19998,   -233,  -1631,    652,
+		   460,   -657,  -2315,  16097,  20252,    -24,  -1710,    663,
+		   443,   -588,  -2426,  15761,  20499,    193,  -1788,    674,
+		   426,   -521,  -2530,  15421,  20739,    416,  -1865,    683,
+		   409,   -456,  -2627,  15078,  20969,    647,  -1943,    691,
+		   392,   -392,  -2718,  14731,  21192,    884,  -2020,    699,
+		   375,   -329,  -2802,  14382,  21406,   1127,  -2096,    705,
+		   358,   -268,  -2879,  14029,  21611,   1378,  -2171,    711,
+		   341,   -209,  -2950,  13675,  21808,   1635,  -2246,    715,
+		   324,   -151,  -3015,  13318,  21995,   1898,  -2319,    718,
+		   307,    -95,  -3073,  12960,  22173,   2168,  -2392,    720,
+		   291,    -41,  -3126,  12600,  22342,   2443,  -2462,    721,
+		   275,     11,  -3172,  12240,  22501,   2725,  -2532,    720,
+		   259,     62,  -3212,  11878,  22650,   3013,  -2599,    718,
+		   243,    111,  -3247,  11515,  22789,   3307,  -2665,    714,
+		   228,    158,  -3275,  11153,  22918,   3606,  -2729,    709,
+		   213,    203,  -3298,  10790,  23037,   3911,  -2791,    703,
+		   198,    246,  -3316,  10428,  23146,   4221,  -2850,    695,
+		   184,    287,  -3328,  10066,  23245,   4536,  -2907,    685,
+		   170,    326,  -3336,   9705,  23333,   4857,  -2961,    674,
+		   157,    363,  -3338,   9345,  23410,   5182,  -3013,    661,
+		   144,    399,  -3335,   8986,  23477,   5511,  -3061,    647,
+		   131,    432,  -3328,   8629,  23534,   5845,  -3106,    630,
+		   119,    464,  -3315,   8274,  23579,   6184,  -3148,    612,
+		   107,    493,  -3299,   7921,  23614,   6526,  -3187,    592,
+		    96,    521,  -3278,   7570,  23638,   6872,  -3222,    571,
+		    85,    547,  -3253,   7222,  23651,   7222,  -3253,    547,
+};
+
+const int16_t src_coefs_16[(SRC_PHASES + 1) * 16] = {
+		   -37,    -36,    375,  -1140,   2332,  -3704,   4816,  27539,   4816,  -3704,   2332,  -1140,    375,    -36,    -37,     15,
+		   -32,    -47,    392,  -1150,   2302,  -3566,   4376,  27530,   5262,  -3838,   2358,  -1128,    358,    -24,    -41,     16,
+		   -28,    -57,    407,  -1157,   2268,  -3424,   3944,  27505,   5714,  -3968,   2381,  -1114,    339,    -13,    -46,     17,
+		   -24,    -67,    421,  -1162,   2231,  -3280,   3518,  27464,   6172,  -4093,   2400,  -1097,    319,     -1,    -51,     18,
+		   -20,    -77,    434,  -1165,   2191,  -3133,   3100,  27406,   6635,  -4214,   2414,  -1078,    299,     12,    -56,     19,
+		   -15,    -86,    446,  -1166,   2148,  -2983,   2690,  27333,   7104,  -4331,   2425,  -1057,    277,     25,    -61,     20,
+		   -12,    -95,    457,  -1164,   2101,  -2831,   2288,  27243,   7577,  -4441,   2431,  -1034,    254,     38,    -66,     22,
+		    -8,   -104,    467,  -1161,   2052,  -2678,   1895,  27138,   8053,  -4547,   2433,  -1008,    230,     51,    -71,     23,
+		    -4,   -112,    476,  -1155,   2000,  -2523,   1510,  27017,   8534,  -4646,   2431,   -979,    205,     64,    -76,     24,
+		     0,   -119,    484,  -1148,   1946,  -2366,   1135,  26881,   9018,  -4740,   2425,   -949,    180,     78,    -81,     25,
+		     3,   -126,    490,  -1139,   1889,  -2209,    768,  26729,   9505,  -4827,   2414,   -916,    153,     92,    -86,     26,
+		     6,   -133,    496,  -1127,   1830,  -2051,    412,  26562,   9994,  -4907,   2398,   -880,    126,    107,    -91,     27,
+		     9,   -139,    500,  -1114,   1768,  -1892,     65,  26380,  10485,  -4980,   2378,   -843,     97,    121,    -96,     28,
+		    12,   -145,    504,  -1100,   1705,  -1734,   -272,  26183,  10978,  -5046,   2353,   -803,     68,    136,   -101,     30,
+		    15,   -150,    506,  -1083,   1640,  -1575,   -599,  25971,  11472,  -5105,   2323,   -761,     38,    150,   -106,     31,
+		    18,   -155,    508,  -1065,   1573,  -1417,   -915,  25745,  11966,  -5156,   2289,   -716,      7,    165,   -111,     32,
+		    20,   -159,    508,  -1045,   1505,  -1260,  -1221,  25504,  12460,  -5198,   2250,   -670,    -24,    180,   -116,     33,
+		    23,   -163,    508,  -1024,   1435,  -1103,  -1516,  25250,  12954,  -5232,   2206,   -621,    -56,    195,   -120,     34,
+		    25,   -167,    506,  -1002,   1364,   -948,  -1800,  24982,  13447,  -5258,   2157,   -570,    -89,    210,   -125,     35,
+		    27,   -170,    504,   -978,   1292,   -794,  -2073,  24701,  13939,  -5275,   2103,   -517,   -122,    225,   -130,     36,
+		    29,   -173,    501,   -953,   1219,   -642,  -2335,  24407,  14429,  -5283,   2045,   -462,   -156,    240,   -134,     36,
+		    30,   -175,    497,   -926,   1145,   -491,  -2586,  24100,  14916,  -5281,   1982,   -406,   -190,    255,   -139,     37,
+		    32,   -177,    492,   -899,   1071,   -343,  -2826,  23781,  15401,  -5270,   1914,   -347,   -224,    270,   -143,     38,
+		    34,   -178,    486,   -870,    996,   -197,  -3055,  23449,  15882,  -5250,   1841,   -287,   -259,    284,   -147,     39,
+		    35,   -179,    480,   -841,    921,    -54,  -3272,  23106,  16360,  -5219,   1763,   -225,   -294,    299,   -151,     39,
+		    36,   -180,    473,   -810,    845,     87,  -3478,  22752,  16833,  -5179,   1681,   -161,   -330,    313,   -155,     40,
+		    37,   -180,    465,   -779,    770,    225,  -3672,  22387,  17302,  -5128,   1594,    -96,   -365,    327,   -158,     40,
+		    38,   -180,    456,   -747,    694,    359,  -3855,  22011,  17765,  -5067,   1503,    -29,   -401,    341,   -161,     40,
+		    39,   -179,    447,   -714,    619,    491,  -4027,  21625,  18223,  -4995,   1407,     39,   -436,    354,   -165,     41,
+		    39,   -179,    437,   -681,    544,    619,  -4187,  21229,  18675,  -4913,   1307,    108,   -472,    367,   -167,     41,
+		    40,   -178,    427,   -647,    470,    743,  -4336,  20824,  19120,  -4819,   1202,    179,   -508,    380,   -170,     41,
+		    40,   -176,    416,   -613,    396,    864,  -4473,  20410,  19558,  -4715,   1094,    250,   -543,    392,   -172,     41,
+		    41,   -174,    404,   -578,    323,    981,  -4600,  19988,  19988,  -4600,    981,    323,   -578,    404,   -174,     41,
+		    41,   -172,    392,   -543,    250,   1094,  -4715,  19558,  20410,  -4473,    864,    396,   -613,    416,   -176,     40,
+		    41,   -170,    380,   -508,    179,   1202,  -4819,  19120,  20824,  -4336,    743,    470,   -647,    427,   -178,     40,
+		    41,   -167,    367,   -472,    108,   1307,  -4913,  18675,  21229,  -4187,    619,    544,   -681,    437,   -179,     39,
+		    41,   -165,    354,   -436,     39,   1407,  -4995,  18223,  21625,  -4027,    491,    619,   -714,    447,   -179,     39,
+		    40,   -161,    341,   -401,    -29,   1503,  -5067,  17765,  22011,  -3855,    359,    694,   -747,    456,   -180,     38,
+		    40,   -158,    327,   -365,    -96,   1594,  -5128,  17302,  22387,  -3672,    225,    770,   -779,    465,   -180,     37,
+		    40,   -155,    313,   -330,   -161,   1681,  -5179,  16833,  22752,  -3478,     87,    845,   -810,    473,   -180,     36,
+		    39,   -151,    299,   -294,   -225,   1763,  -5219,  16360,  23106,  -3272,    -54,    921,   -841,    480,   -179,     35,
+		    39,   -147,    284,   -259,   -287,   1841,  -5250,  15882,  23449,  -3055,   -197,    996,   -870,    486,   -178,     34,
+		    38,   -143,    270,   -224,   -347,   1914,  -5270,  15401,  23781,  -2826,   -343,   1071,   -899,    492,   -177,     32,
+		    37,   -139,    255,   -190,   -406,   1982,  -5281,  14916,  24100,  -2586,   -491,   1145,   -926,    497,   -175,     30,
+		    36,   -134,    240,   -156,   -462,   2045,  -5283,  14429,  24407,  -2335,   -642,   1219,   -953,    501,   -173,     29,
+		    36,   -130,    225,   -122,   -517,   2103,  -5275,  13939,  24701,  -2073,   -794,   1292,   -978,    504,   -170,     27,
+		    35,   -125,    210,    -89,   -570,   2157,  -5258,  13447,  24982,  -1800,   -948,   1364,  -1002,    506,   -167,     25,
+		    34,   -120,    195,    -56,   -621,   2206,  -5232,  12954,  25250,  -1516,  -1103,   1435,  -1024,    508,   -163,     23,
+		    33,   -116,    180,    -24,   -670,   2250,  -5198,  12460,  25504,  -1221,  -1260,   1505,  -1045,    508,   -159,     20,
+		    32,   -111,    165,      7,   -716,   2289,  -5156,  11966,  25745,   -915,  -1417,   1573,  -1065,    508,   -155,     18,
+		    31,   -106,    150,     38,   -761,   2323,  -5105,  11472,  25971,   -599,  -1575,   1640,  -1083,    506,   -150,     15,
+		    30,   -101,    136,     68,   -803,   2353,  -5046,  10978,  26183,   -272,  -1734,   1705,  -1100,    504,   -145,     12,
+		    28,    -96,    121,     97,   -843,   2378,  -4980,  10485,  26380,     65,  -1892,   1768,  -1114,    500,   -139,      9,
+		    27,    -91,    107,    126,   -880,   2398,  -4907,   9994,  26562,    412,  -2051,   1830,  -1127,    496,   -133,      6,
+		    26,    -86,     92,    153,   -916,   2414,  -4827,   9505,  26729,    768,  -2209,   1889,  -1139,    490,   -126,      3,
+		    25,    -81,     78,    180,   -949,   2425,  -4740,   9018,  26881,   1135,  -2366,   1946,  -1148,    484,   -119,      0,
+		    24,    -76,     64,    205,   -979,   2431,  -4646,   8534,  27017,   1510,  -2523,   2000,  -1155,    476,   -112,     -4,
+		    23,    -71,     51,    230,  -1008,   2433,  -4547,   8053,  27138,   1895,  -2678,   2052,  -1161,    467,   -104,     -8,
+		    22,    -66,     38,    254,  -1034,   2431,  -4441,   7577,  27243,   2288,  -2831,   2101,  -1164,    457,    -95,    -12,
+		    20,    -61,     25,    277,  -1057,   2425,  -4331,   7104,  27333,   2690,  -2983,   2148,  -1166,    446,    -86,    -15,
+		    19,    -56,     12,    299,  -1078,   2414,  -4214,   6635,  27406,   3100,  -3133,   2191,  -1165,    434,    -77,    -20,
+		    18,    -51,     -1,    319,  -1097,   2400,  -4093,   6172,  27464,   3518,  -3280,   2231,  -1162,    421,    -67,    -24,
+		    17,    -46,    -13,    339,  -1114,   2381,  -3968,   5714,  27505,   3944,  -3424,   2268,  -1157,    407,    -57,    -28,
+		    16,    -41,    -24,    358,  -1128,   2358,  -3838,   5262,  27530,   4376,  -3566,   2302,  -1150,    392,    -47,    -32,
+		    15,    -37,    -36,    375,  -1140,   2332,  -3704,   4816,  27539,   4816,  -3704,   2332,  -1140,    375,    -36,    -37,
+};
+
+const int16_t src_coefs_32[(SRC_PHASES + 1) * 32] = {
+		    -5,     13,    -25,     36,    -34,      0,     91,   -264,    541,   -925,   1400,  -1925,   2442,  -2879,   3173,  29492,   3173,  -2879,   2442,  -1925,   1400,   -925,    541,   -264,     91,      0,    -34,     36,    -25,     13,     -5,      1,
+		    -5,     13,    -24,     33,    -29,     -8,    102,   -278,    554,   -932,   1390,  -1885,   2345,  -2678,   2695,  29482,   3661,  -3079,   2535,  -1963,   1406,   -916,    526,   -250,     79,      8,    -39,     38,    -26,     13,     -5,      1,
+		    -5,     12,    -23,     31,    -24,    -16,    113,   -292,    567,   -937,   1378,  -1841,   2245,  -2475,   2227,  29453,   4157,  -3275,   2624,  -1996,   1410,   -905,    510,   -234,     67,     16,    -44,     41,    -27,     14,     -5,      1,
+		    -4,     12,    -22,     28,    -19,    -24,    124,   -304,    577,   -940,   1364,  -1794,   2143,  -2270,   1769,  29405,   4661,  -3469,   2709,  -2027,   1411,   -892,    493,   -218,     54,     25,    -48,     43,    -28,     14,     -5,      1,
+		    -4,     11,    -20,     25,    -14,    -31,    135,   -316,    587,   -941,   1347,  -1744,   2037,  -2065,   1322,  29337,   5173,  -3659,   2790,  -2053,   1409,   -877,    475,   -201,     41,     33,    -53,     45,    -29,     14,     -5,      1,
+		    -4,     11,    -19,     23,    -10,    -39,    144,   -327,    596,   -941,   1327,  -1691,   1929,  -1859,    885,  29250,   5693,  -3846,   2866,  -2076,   1405,   -861,    455,   -184,     28,     42,    -58,     48,    -30,     15,     -5,      1,
+		    -4,     10,    -18,     20,     -5,    -46,    154,   -337,    603,   -938,   1305,  -1635,   1818,  -1653,    459,  29144,   6220,  -4028,   2938,  -2095,   1398,   -842,    434,   -166,     15,     50,    -63,     50,    -31,     15,     -5,      1,
+		    -4,     10,    -17,     18,     -1,    -53,    163,   -347,    609,   -934,   1281,  -1577,   1705,  -1447,     45,  29019,   6753,  -4206,   3005,  -2110,   1387,   -822,    412,   -148,      2,     59,    -68,     52,    -32,     15,     -5,      1,
+		    -4,     10,    -16,     15,      4,    -60,    172,   -355,    613,   -928,   1255,  -1517,   1590,  -1241,   -357,  28875,   7292,  -4378,   3067,  -2121,   1374,   -799,    390,   -128,    -12,     68,    -72,     55,    -32,     15,     -5,      1,
+		    -4,      9,    -14,     13,      8,    -66,    180,   -363,    616,   -920,   1226,  -1454,   1474,  -1037,   -747,  28712,   7837,  -4545,   3123,  -2128,   1358,   -775,    366,   -109,    -26,     76,    -77,     57,    -33,     15,     -5,      1,
+		    -4,      9,    -13,     10,     13,    -73,    188,   -370,    618,   -910,   1195,  -1389,   1356,   -834,  -1124,  28531,   8387,  -4706,   3174,  -2131,   1339,   -749,    341,    -89,    -40,     85,    -82,     59,    -34,     16,     -5,      1,
+		    -3,      8,    -12,      8,     17,    -79,    195,   -376,    619,   -899,   1163,  -1322,   1237,   -633,  -1489,  28332,   8940,  -4861,   3220,  -2130,   1317,   -721,    315,    -68,    -54,     93,    -86,     61,    -34,     16,     -5,      1,
+		    -3,      8,    -11,      5,     21,    -85,    202,   -381,    619,   -886,   1128,  -1253,   1118,   -434,  -1841,  28114,   9498,  -5008,   3260,  -2124,   1293,   -692,    288,    -48,    -68,    102,    -90,     62,    -35,     16,     -5,      1,
+		    -3,      7,     -9,      3,     25,    -90,    208,   -386,    617,   -872,   1091,  -1183,    997,   -237,  -2180,  27879,  10059,  -5149,   3293,  -2114,   1265,   -661,    260,    -26,    -83,    110,    -95,     64,    -36,     16,     -5,      1,
+		    -3,      7,     -8,      1,     29,    -96,    214,   -390,    614,   -856,   1053,  -1111,    876,    -43,  -2506,  27626,  10622,  -5282,   3321,  -2100,   1235,   -628,    231,     -5,    -97,    119,    -99,     66,    -36,     16,     -5,      1,
+		    -3,      6,     -7,     -2,     33,   -101,    219,   -392,    610,   -838,   1013,  -1037,    755,    148,  -2818,  27357,  11188,  -5408,   3343,  -2081,   1202,   -593,    202,     17,   -111,    127,   -103,     67,    -36,     16,     -5,      1,
+		    -3,      6,     -6,     -4,     36,   -105,    224,   -394,    605,   -819,    972,   -963,    634,    336,  -3116,  27070,  11754,  -5525,   3358,  -2058,   1166,   -557,    172,     39,   -125,    135,   -107,     69,    -37,     16,     -5,      1,
+		    -2,      5,     -5,     -6,     40,   -110,    228,   -396,    599,   -799,    929,   -887,    514,    520,  -3401,  26767,  12322,  -5633,   3367,  -2030,   1127,   -519,    141,     61,   -140,    143,   -110,     70,    -37,     16,     -5,      1,
+		    -2,      5,     -4,     -8,     43,   -114,    231,   -396,    591,   -777,    885,   -811,    394,    700,  -3672,  26448,  12890,  -5732,   3369,  -1999,   1086,   -480,    109,     84,   -154,    150,   -114,     71,    -37,     15,     -5,      1,
+		    -2,      4,     -3,    -11,     46,   -118,    235,   -396,    583,   -754,    839,   -734,    274,    876,  -3928,  26113,  13458,  -5822,   3364,  -1962,   1042,   -439,     77,    106,   -168,    158,   -117,     72,    -37,     15,     -5,      1,
+		    -2,      4,     -1,    -13,     49,   -122,    237,   -394,    573,   -730,    793,   -656,    156,   1047,  -4171,  25762,  14024,  -5902,   3353,  -1922,    995,   -397,     44,    129,   -182,    165,   -120,     73,    -37,     15,     -4,      1,
+		    -2,      3,      0,    -14,     52,   -125,    239,   -392,    562,   -704,    745,   -578,     39,   1214,  -4399,  25397,  14589,  -5971,   3335,  -1877,    946,   -354,     11,    152,   -195,    172,   -123,     74,    -37,     15,     -4,      1,
+		    -2,      3,      1,    -16,     55,   -128,    241,   -390,    551,   -678,    696,   -500,    -77,   1376,  -4614,  25017,  15152,  -6031,   3310,  -1828,    894,   -310,    -22,    174,   -209,    179,   -126,     75,    -37,     15,     -4,      1,
+		    -2,      2,      2,    -18,     58,   -130,    242,   -386,    538,   -650,    647,   -422,   -191,   1532,  -4814,  24623,  15712,  -6079,   3278,  -1775,    840,   -264,    -56,    197,   -222,    186,   -129,     75,    -37,     14,     -4,      0,
+		    -1,      2,      3,    -20,     60,   -133,    243,   -382,    525,   -622,    597,   -343,   -304,   1683,  -4999,  24215,  16269,  -6117,   3239,  -1717,    784,   -218,    -91,    219,   -235,    192,   -131,     76,    -36,     14,     -4,      0,
+		    -1,      1,      4,    -22,     62,   -135,    243,   -377,    510,   -592,    546,   -265,   -414,   1829,  -5171,  23794,  16821,  -6142,   3193,  -1655,    726,   -170,   -125,    241,   -247,    198,   -133,     76,    -36,     13,     -3,      0,
+		    -1,      1,      5,    -23,     64,   -137,    243,   -372,    495,   -562,    495,   -187,   -522,   1968,  -5329,  23361,  17369,  -6157,   3140,  -1590,    665,   -122,   -160,    264,   -260,    204,   -135,     76,    -36,     13,     -3,      0,
+		    -1,      1,      6,    -25,     66,   -138,    242,   -366,    479,   -531,    443,   -110,   -628,   2102,  -5472,  22915,  17912,  -6159,   3080,  -1520,    602,    -72,   -194,    285,   -272,    209,   -137,     76,    -35,     13,     -3,      0,
+		    -1,      0,      6,    -26,     68,   -139,    240,   -359,    463,   -499,    391,    -34,   -731,   2229,  -5602,  22458,  18448,  -6149,   3013,  -1446,    538,    -22,   -229,    307,   -283,    214,   -138,     76,    -34,     12,     -3,      0,
+		    -1,      0,      7,    -27,     70,   -140,    239,   -351,    445,   -467,    339,     42,   -832,   2350,  -5717,  21990,  18978,  -6126,   2938,  -1369,    472,     28,   -264,    328,   -294,    219,   -139,     75,    -34,     11,     -2,      0,
+		    -1,     -1,      8,    -29,     71,   -141,    236,   -343,    427,   -434,    287,    117,   -929,   2465,  -5819,  21511,  19501,  -6091,   2857,  -1288,    404,     79,   -298,    349,   -305,    223,   -140,     75,    -33,     11,     -2,      0,
+		     0,     -1,      9,    -30,     72,   -141,    234,   -334,    408,   -401,    235,    190,  -1024,   2573,  -5907,  21022,  20017,  -6043,   2770,  -1203,    334,    131,   -333,    369,   -315,    227,   -141,     74,    -32,     10,     -2,      0,
+		     0,     -1,      9,    -31,     73,   -141,    231,   -325,    389,   -367,    183,    263,  -1115,   2675,  -5982,  20524,  20524,  -5982,   2675,  -1115,    263,    183,   -367,    389,   -325,    231,   -141,     73,    -31,      9,     -1,      0,
+		     0,     -2,     10,    -32,     74,   -141,    227,   -315,    369,   -333,    131,    334,  -1203,   2770,  -6043,  20017,  21022,  -5907,   2573,  -1024,    190,    235,   -401,    408,   -334,    234,   -141,     72,    -30,      9,     -1,      0,
+		     0,     -2,     11,    -33,     75,   -140,    223,   -305,    349,   -298,     79,    404,  -1288,   2857,  -6091,  19501,  21511,  -5819,   2465,   -929,    117,    287,   -434,    427,   -343,    236,   -141,     71,    -29,      8,     -1,     -1,
+		     0,     -2,     11,    -34,     75,   -139,    219,   -294,    328,   -264,     28,    472,  -1369,   2938,  -6126,  18978,  21990,  -5717,   2350,   -832,     42,    339,   -467,    445,   -351,    239,   -140,     70,    -27,      7,      0,     -1,
+		     0,     -3,     12,    -34,     76,   -138,    214,   -283,    307,   -229,    -22,    538,  -1446,   3013,  -6149,  18448,  22458,  -5602,   2229,   -731,    -34,    391,   -499,    463,   -359,    240,   -139,     68,    -26,      6,      0,     -1,
+		     0,     -3,     13,    -35,     76,   -137,    209,   -272,    285,   -194,    -72,    602,  -1520,   3080,  -6159,  17912,  22915,  -5472,   2102,   -628,   -110,    443,   -531,    479,   -366,    242,   -138,     66,    -25,      6,      1,     -1,
+		     0,     -3,     13,    -36,     76,   -135,    204,   -260,    264,   -160,   -122,    665,  -1590,   3140,  -6157,  17369,  23361,  -5329,   1968,   -522,   -187,    495,   -562,    495,   -372,    243,   -137,     64,    -23,      5,      1,     -1,
+		     0,     -3,     13,    -36,     76,   -133,    198,   -247,    241,   -125,   -170,    726,  -1655,   3193,  -6142,  16821,  23794,  -5171,   1829,   -414,   -265,    546,   -592,    510,   -377,    243,   -135,     62,    -22,      4,      1,     -1,
+		     0,     -4,     14,    -36,     76,   -131,    192,   -235,    219,    -91,   -218,    784,  -1717,   3239,  -6117,  16269,  24215,  -4999,   1683,   -304,   -343,    597,   -622,    525,   -382,    243,   -133,     60,    -20,      3,      2,     -1,
+		     0,     -4,     14,    -37,     75,   -129,    186,   -222,    197,    -56,   -264,    840,  -1775,   3278,  -6079,  15712,  24623,  -4814,   1532,   -191,   -422,    647,   -650,    538,   -386,    242,   -130,     58,    -18,      2,      2,     -2,
+		     1,     -4,     15,    -37,     75,   -126,    179,   -209,    174,    -22,   -310,    894,  -1828,   3310,  -6031,  15152,  25017,  -4614,   1376,    -77,   -500,    696,   -678,    551,   -390,    241,   -128,     55,    -16,      1,      3,     -2,
+		     1,     -4,     15,    -37,     74,   -123,    172,   -195,    152,     11,   -354,    946,  -1877,   3335,  -5971,  14589,  25397,  -4399,   1214,     39,   -578,    745,   -704,    562,   -392,    239,   -125,     52,    -14,      0,      3,     -2,
+		     1,     -4,     15,    -37,     73,   -120,    165,   -182,    129,     44,   -397,    995,  -1922,   3353,  -5902,  14024,  25762,  -4171,   1047,    156,   -656,    793,   -730,    573,   -394,    237,   -122,     49,    -13,     -1,      4,     -2,
+		     1,     -5,     15,    -37,     72,   -117,    158,   -168,    106,     77,   -439,   1042,  -1962,   3364,  -5822,  13458,  26113,  -3928,    876,    274,   -734,    839,   -754,    583,   -396,    235,   -118,     46,    -11,     -3,      4,     -2,
+		     1,     -5,     15,    -37,     71,   -114,    150,   -154,     84,    109,   -480,   1086,  -1999,   3369,  -5732,  12890,  26448,  -3672,    700,    394,   -811,    885,   -777,    591,   -396,    231,   -114,     43,     -8,     -4,      5,     -2,
+		     1,     -5,     16,    -37,     70,   -110,    143,   -140,     61,    141,   -519,   1127,  -2030,   3367,  -5633,  12322,  26767,  -3401,    520,    514,   -887,    929,   -799,    599,   -396,    228,   -110,     40,     -6,     -5,      5,     -2,
+		     1,     -5,     16,    -37,     69,   -107,    135,   -125,     39,    172,   -557,   1166,  -2058,   3358,  -5525,  11754,  27070,  -3116,    336,    634,   -963,    972,   -819,    605,   -394,    224,   -105,     36,     -4,     -6,      6,     -3,
+		     1,     -5,     16,    -36,     67,   -103,    127,   -111,     17,    202,   -593,   1202,  -2081,   3343,  -5408,  11188,  27357,  -2818,    148,    755,  -1037,   1013,   -838,    610,   -392,    219,   -101,     33,     -2,     -7,      6,     -3,
+		     1,     -5,     16,    -36,     66,    -99,    119,    -97,     -5,    231,   -628,   1235,  -2100,   3321,  -5282,  10622,  27626,  -2506,    -43,    876,  -1111,   1053,   -856,    614,   -390,    214,    -96,     29,      1,     -8,      7,     -3,
+		     1,     -5,     16,    -36,     64,    -95,    110,    -83,    -26,    260,   -661,   1265,  -2114,   3293,  -5149,  10059,  27879,  -2180,   -237,    997,  -1183,   1091,   -872,    617,   -386,    208,    -90,     25,      3,     -9,      7,     -3,
+		     1,     -5,     16,    -35,     62,    -90,    102,    -68,    -48,    288,   -692,   1293,  -2124,   3260,  -5008,   9498,  28114,  -1841,   -434,   1118,  -1253,   1128,   -886,    619,   -381,    202,    -85,     21,      5,    -11,      8,     -3,
+		     1,     -5,     16,    -34,     61,    -86,     93,    -54,    -68,    315,   -721,   1317,  -2130,   3220,  -4861,   8940,  28332,  -1489,   -633,   1237,  -1322,   1163,   -899,    619,   -376,    195,    -79,     17,      8,    -12,      8,     -3,
+		     1,     -5,     16,    -34,     59,    -82,     85,    -40,    -89,    341,   -749,   1339,  -2131,   3174,  -4706,   8387,  28531,  -1124,   -834,   1356,  -1389,   1195,   -910,    618,   -370,    188,    -73,     13,     10,    -13,      9,     -4,
+		     1,     -5,     15,    -33,     57,    -77,     76,    -26,   -109,    366,   -775,   1358,  -2128,   3123,  -4545,   7837,  28712,   -747,  -1037,   1474,  -1454,   1226,   -920,    616,   -363,    180,    -66,      8,     13,    -14,      9,     -4,
+		     1,     -5,     15,    -32,     55,    -72,     68,    -12,   -128,    390,   -799,   1374,  -2121,   3067,  -4378,   7292,  28875,   -357,  -1241,   1590,  -1517,   1255,   -928,    613,   -355,    172,    -60,      4,     15,    -16,     10,     -4,
+		     1,     -5,     15,    -32,     52,    -68,     59,      2,   -148,    412,   -822,   1387,  -2110,   3005,  -4206,   6753,  29019,     45,  -1447,   1705,  -1577,   1281,   -934,    609,   -347,    163,    -53,     -1,     18,    -17,     10,     -4,
+		     1,     -5,     15,    -31,     50,    -63,     50,     15,   -166,    434,   -842,   1398,  -2095,   2938,  -4028,   6220,  29144,    459,  -1653,   1818,  -1635,   1305,   -938,    603,   -337,    154,    -46,     -5,     20,    -18,     10,     -4,
+		     1,     -5,     15,    -30,     48,    -58,     42,     28,   -184,    455,   -861,   1405,  -2076,   2866,  -3846,   5693,  29250,    885,  -1859,   1929,  -1691,   1327,   -941,    596,   -327,    144,    -39,    -10,     23,    -19,     11,     -4,
+		     1,     -5,     14,    -29,     45,    -53,     33,     41,   -201,    475,   -877,   1409,  -2053,   2790,  -3659,   5173,  29337,   1322,  -2065,   2037,  -1744,   1347,   -941,    587,   -316,    135,    -31,    -14,     25,    -20,     11,     -4,
+		     1,     -5,     14,    -28,     43,    -48,     25,     54,   -218,    493,   -892,   1411,  -2027,   2709,  -3469,   4661,  29405,   1769,  -2270,   2143,  -1794,   1364,   -940,    577,   -304,    124,    -24,    -19,     28,    -22,     12,     -4,
+		     1,     -5,     14,    -27,     41,    -44,     16,     67,   -234,    510,   -905,   1410,  -1996,   2624,  -3275,   4157,  29453,   2227,  -2475,   2245,  -1841,   1378,   -937,    567,   -292,    113,    -16,    -24,     31,    -23,     12,     -5,
+		     1,     -5,     13,    -26,     38,    -39,      8,     79,   -250,    526,   -916,   1406,  -1963,   2535,  -3079,   3661,  29482,   2695,  -2678,   2345,  -1885,   1390,   -932,    554,   -278,    102,     -8,    -29,     33,    -24,     13,     -5,
+		     1,     -5,     13,    -25,     36,    -34,      0,     91,   -264,    541,   -925,   1400,  -1925,   2442,  -2879,   3173,  29492,   3173,  -2879,   2442,  -1925,   1400,   -925,    541,   -264,     91,      0,    -34,     36,    -25,     13,     -5,
+};
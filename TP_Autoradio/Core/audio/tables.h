@@ -0,0 +1,33 @@
+/*
+ * tables.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef AUDIO_TABLES_H_
+#define AUDIO_TABLES_H_
+
+#include <stdint.h>
+
+/**
+ * Constant tables kept in flash, generated by tools/gen_tables.py.
+ * Keep the sizes below in sync with the script.
+ */
+#define SINE_TABLE_BITS 10
+#define SINE_TABLE_SIZE (1 << SINE_TABLE_BITS)	// Points per period
+
+#define LOG2_TABLE_BITS 5
+#define LOG2_TABLE_SIZE (1 << LOG2_TABLE_BITS)	// Segments per octave
+
+#define SRC_PHASE_BITS 6
+#define SRC_PHASES (1 << SRC_PHASE_BITS)		// Polyphase rows, plus one for the interpolation
+
+extern const int16_t sine_q15[SINE_TABLE_SIZE + 1];	// sin(2*pi*i/SIZE), last point = first one
+extern const uint32_t log2_q16[LOG2_TABLE_SIZE + 1];	// log2(1 + i/SIZE) in Q16
+extern const uint32_t exp2_q30[LOG2_TABLE_SIZE + 1];	// 2^(i/SIZE) in Q30
+extern const int16_t src_coefs_8[(SRC_PHASES + 1) * 8];	// Resampler rows, Q15, oldest tap first
+extern const int16_t src_coefs_16[(SRC_PHASES + 1) * 16];
+extern const int16_t src_coefs_32[(SRC_PHASES + 1) * 32];
+
+#endif /* AUDIO_TABLES_H_ */
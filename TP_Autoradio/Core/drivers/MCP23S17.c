@@ -4,152 +4,357 @@
 #include <stdlib.h>
 #include "spi.h"
 
-#define LOGS 0
+#include "../utils/log.h"
 
-typedef struct {
-	SPI_HandleTypeDef* hspi;
-	uint8_t GPA;	// LED array in GPIOA
-	uint8_t GPB;	// LED array in GPIOB
-} h_MCP23S17_t;
+static SPI_HandleTypeDef * MCP23S17_hspi;	// Shared by every expander
+
+h_MCP23S17_t hMCP23S17[MCP23S17_DEV_COUNT] = {
+#define MCP23S17_DEV_INIT(id, addr, label) { .name = label, .address = addr },
+		MCP23S17_DEVICES(MCP23S17_DEV_INIT)
+#undef MCP23S17_DEV_INIT
+};
+
+
+// Per attempt, a batch is at most 4 bytes per expander at 1.25 Mbit/s
+#define MCP23S17_TIMEOUT_MS 10
 
-h_MCP23S17_t hMCP23S17;
+#define MCP23S17_FRAME_MAX 4			// Control byte, register, GPA, GPB
 
+typedef struct {
+	uint8_t length;
+	uint8_t data[MCP23S17_FRAME_MAX];
+} MCP23S17_frame_t;
+
+typedef struct {
+	const MCP23S17_frame_t * frames;
+	uint32_t count;
+} MCP23S17_batch_t;
 
-// Function to write to a register of MCP23S17 with error handling
-void MCP23S17_WriteRegister(uint8_t reg, uint8_t data)
+typedef struct {
+	uint8_t address;
+	uint8_t reg;
+	uint8_t * data;
+} MCP23S17_read_t;
+
+/**
+ * @brief One attempt of a batch: each frame in its own chip select, the
+ * expanders latching on its rising edge, back to back.
+ */
+static drv_status_t MCP23S17_Attempt_Write(void * ctx)
 {
-	uint8_t control_byte = MCP23S17_CONTROL_BYTE(MCP23S17_CONTROL_ADDR, VU_WRITE); // Address = 0b000
+	const MCP23S17_batch_t * b = ctx;
+	HAL_StatusTypeDef status = HAL_OK;
+
+	for (uint32_t i = 0; i < b->count && status == HAL_OK; i++)
+	{
+		// Assert chip select
+		HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_RESET);
+
+		status = HAL_SPI_Transmit(MCP23S17_hspi, (uint8_t *)b->frames[i].data, b->frames[i].length, MCP23S17_TIMEOUT_MS);
+
+		// Deassert chip select
+		HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET);
+	}
 
-	uint8_t buffer[2] = {reg, data};
+	LOG_DBG(LOG_MOD_MCP23S17, "SPI3 batch of %lu frames status: %d", b->count, status);
+
+	return drv_from_hal(status);
+}
+
+static drv_status_t MCP23S17_Attempt_Read(void * ctx)
+{
+	const MCP23S17_read_t * r = ctx;
+	uint8_t tx[3] = { MCP23S17_CONTROL_BYTE(r->address, VU_READ), r->reg, 0 };
+	uint8_t rx[3];
 	HAL_StatusTypeDef status;
 
-	// Assert chip select
 	HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_RESET);
+	status = HAL_SPI_TransmitReceive(MCP23S17_hspi, tx, rx, sizeof(tx), MCP23S17_TIMEOUT_MS);
+	HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET);
 
-	// Transmit control byte
-	status = HAL_SPI_Transmit(hMCP23S17.hspi, &control_byte, 1, HAL_MAX_DELAY);
-	if (status != HAL_OK) {
-		HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET); // Deassert chip select
-		printf("Error: Failed to transmit control byte (HAL_SPI_Transmit returned %d)\r\n", status);
-		Error_Handler(); // Handle the error
-		return; // Prevent further execution
-	}
+	*r->data = rx[2];
+
+	return drv_from_hal(status);
+}
+
+/**
+ * @brief Bus reinitialization between two retries.
+ */
+static void MCP23S17_Recover(void)
+{
+	HAL_SPI_Abort(MCP23S17_hspi);
+	HAL_SPI_DeInit(MCP23S17_hspi);
+	HAL_SPI_Init(MCP23S17_hspi);
+}
+
+/**
+ * @brief Sends frames in a single submission, with the retry and degraded
+ * policy of drv_transfer(): a batch is retried as a whole, its writes
+ * being idempotent.
+ */
+static drv_status_t MCP23S17_Submit(const MCP23S17_frame_t * frames, uint32_t count)
+{
+	MCP23S17_batch_t b = { frames, count };
+	drv_status_t status;
 
-#if (LOGS)
-	printf("SPI3 control transmission status: %d\r\n", status);
-#endif
-
-	// Transmit register address and data
-	status = HAL_SPI_Transmit(hMCP23S17.hspi, buffer, 2, HAL_MAX_DELAY);
-	if (status != HAL_OK) {
-		HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET); // Deassert chip select
-		printf("Error: Failed to transmit register data (HAL_SPI_Transmit returned %d)\r\n", status);
-		Error_Handler(); // Handle the error
-		return; // Prevent further execution
+	if (count == 0)
+	{
+		return DRV_OK;
 	}
 
-#if (LOGS)
-	printf("SPI3 data Ox%X transmission to register 0x%X status: %d\r\n", data, reg, status);
-#endif
+	status = drv_transfer(DRV_PERIPH_MCP23S17, MCP23S17_Attempt_Write, &b);
+	if (status != DRV_OK && status != DRV_DEGRADED)
+	{
+		LOG_ERR(LOG_MOD_MCP23S17, "Failed to write %lu frames (%s)", count, drv_status_name(status));
+	}
 
-	// Deassert chip select
-	HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET);
+	return status;
 }
 
-void MCP23S17_Update_LEDs()
+/**
+ * @brief Both output latches of an expander in one frame: OLATB follows
+ * OLATA in sequential mode (IOCON.SEQOP = 0, BANK = 0).
+ */
+static void MCP23S17_Latch_Frame(const h_MCP23S17_t * dev, MCP23S17_frame_t * frame)
 {
-	MCP23S17_WriteRegister(MCP23S17_OLATA, hMCP23S17.GPA);
-	MCP23S17_WriteRegister(MCP23S17_OLATB, hMCP23S17.GPB);
+	frame->length = 4;
+	frame->data[0] = MCP23S17_CONTROL_BYTE(dev->address, VU_WRITE);
+	frame->data[1] = MCP23S17_OLATA;
+	frame->data[2] = dev->GPA;
+	frame->data[3] = dev->GPB;
 }
 
-void MCP23S17_Init(void)
+/**
+ * @brief Writes a register of an expander.
+ * @retval drv_status_t: DRV_OK, or why the write has not been done.
+ */
+drv_status_t MCP23S17_WriteRegister(h_MCP23S17_t * dev, uint8_t reg, uint8_t data)
 {
-	hMCP23S17.hspi = &hspi3;
+	MCP23S17_frame_t frame = { 3, { MCP23S17_CONTROL_BYTE(dev->address, VU_WRITE), reg, data } };
 
-	HAL_SPI_Init(hMCP23S17.hspi);
+	return MCP23S17_Submit(&frame, 1);
+}
 
-	// nRESET to base state
-	HAL_GPIO_WritePin(VU_nRESET_GPIO_Port, VU_nRESET_Pin, GPIO_PIN_SET);
+/**
+ * @brief Reads a register at a hardware address, declared or not (probe).
+ * @param data: 0xFF or 0x00 if nothing answers, depending on MISO.
+ */
+drv_status_t MCP23S17_ReadRegister(uint8_t address, uint8_t reg, uint8_t * data)
+{
+	MCP23S17_read_t r = { address, reg, data };
 
-	// nCS to reset state
-	HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET);
+	return drv_transfer(DRV_PERIPH_MCP23S17, MCP23S17_Attempt_Read, &r);
+}
 
-	// Set all GPIOA and GPIOB pins as outputs
-	MCP23S17_WriteRegister(MCP23S17_IODIRA, MCP23S17_ALL_ON); // GPA as output
-	MCP23S17_WriteRegister(MCP23S17_IODIRB, MCP23S17_ALL_ON); // GPB as output
+/**
+ * @brief Writes the latches of one expander if they changed.
+ */
+drv_status_t MCP23S17_Update_LEDs(h_MCP23S17_t * dev)
+{
+	MCP23S17_frame_t frame;
+	drv_status_t status;
 
-	hMCP23S17.GPA = 0xFF;	// All LEDs on GPIOA OFF
-	hMCP23S17.GPB = 0xFF;	// All LEDs on GPIOB OFF
+	if (!dev->present)
+	{
+		return DRV_INVALID;
+	}
+	if (!dev->dirty)
+	{
+		return DRV_OK;
+	}
+
+	MCP23S17_Latch_Frame(dev, &frame);
+	status = MCP23S17_Submit(&frame, 1);
+	if (status == DRV_OK)
+	{
+		dev->dirty = 0;
+	}
 
-	MCP23S17_Update_LEDs();
+	return status;
 }
 
-void MCP23S17_Set_LED_id(uint8_t led)
+/**
+ * @brief Writes the latches of every expander which changed, one frame
+ * each, in a single submission.
+ */
+drv_status_t MCP23S17_Flush(void)
 {
-	if (led > 7)
+	MCP23S17_frame_t frames[MCP23S17_DEV_COUNT];
+	uint32_t count = 0;
+	drv_status_t status;
+
+	for (int i = 0; i < MCP23S17_DEV_COUNT; i++)
 	{
-		hMCP23S17.GPB = ~(1 << led%8);
-		hMCP23S17.GPA = 0xFF; // All LEDs on GPIOA OFF
+		if (hMCP23S17[i].present && hMCP23S17[i].dirty)
+		{
+			MCP23S17_Latch_Frame(&hMCP23S17[i], &frames[count++]);
+		}
 	}
-	else
+
+	status = MCP23S17_Submit(frames, count);
+	if (status == DRV_OK)
 	{
-		hMCP23S17.GPA = ~(1 << led);
-		hMCP23S17.GPB = 0xFF; // All LEDs on GPIOB OFF
+		for (int i = 0; i < MCP23S17_DEV_COUNT; i++)
+		{
+			hMCP23S17[i].dirty = 0;
+		}
 	}
 
-	MCP23S17_Update_LEDs();
+	return status;
 }
 
-void MCP23S17_Toggle_LED_id(uint8_t led)
+/**
+ * @brief Enables the hardware addressing on every expander at once, then
+ * sets up the declared ones.
+ * @retval drv_status_t: DRV_OK, DRV_INVALID if one of them does not answer
+ * with HAEN set, or the first bus error.
+ */
+drv_status_t MCP23S17_Init(void)
 {
-	if (led > 7)
+	MCP23S17_hspi = &hspi3;
+	drv_register(DRV_PERIPH_MCP23S17, MCP23S17_Recover);
+
+	HAL_SPI_Init(MCP23S17_hspi);
+
+	// nRESET to base state
+	HAL_GPIO_WritePin(VU_nRESET_GPIO_Port, VU_nRESET_Pin, GPIO_PIN_SET);
+
+	// nCS to reset state
+	HAL_GPIO_WritePin(VU_nCS_GPIO_Port, VU_nCS_Pin, GPIO_PIN_SET);
+
+	// HAEN cleared after reset: every expander takes address 0b000. Also
+	// sent to 0b100, which those with A2 high may answer to (silicon erratum)
+	const MCP23S17_frame_t haen[2] = {
+			{ 3, { MCP23S17_CONTROL_BYTE(0b000, VU_WRITE), MCP23S17_IOCON, MCP23S17_IOCON_HAEN } },
+			{ 3, { MCP23S17_CONTROL_BYTE(0b100, VU_WRITE), MCP23S17_IOCON, MCP23S17_IOCON_HAEN } },
+	};
+	drv_status_t result = MCP23S17_Submit(haen, 2);
+
+	// Left out of the flushes only if it answers without HAEN, a bus error is retried later
+	for (int i = 0; i < MCP23S17_DEV_COUNT; i++)
 	{
-		hMCP23S17.GPB = (hMCP23S17.GPB & ~(1 << led%8)) | (~hMCP23S17.GPB & (1 << led%8));
+		hMCP23S17[i].present = 1;
 	}
-	else
+
+	for (int i = 0; i < MCP23S17_DEV_COUNT && result != DRV_DEGRADED; i++)
 	{
-		hMCP23S17.GPA = (hMCP23S17.GPA & ~(1 << led)) | (~hMCP23S17.GPA & (1 << led));
+		h_MCP23S17_t * dev = &hMCP23S17[i];
+		uint8_t iocon = 0;
+		drv_status_t status = MCP23S17_ReadRegister(dev->address, MCP23S17_IOCON, &iocon);
+
+		if (status == DRV_OK && iocon != MCP23S17_IOCON_HAEN)
+		{
+			dev->present = 0;
+			// A missing expander does not keep the others dark
+			LOG_ERR(LOG_MOD_MCP23S17, "Expander %s at address %d missing, IOCON 0x%02X", dev->name, dev->address, iocon);
+			status = DRV_INVALID;
+		}
+
+		// Set all GPIOA and GPIOB pins as outputs
+		if (status == DRV_OK)
+		{
+			status = MCP23S17_WriteRegister(dev, MCP23S17_IODIRA, MCP23S17_ALL_ON); // GPA as output
+		}
+		if (status == DRV_OK)
+		{
+			status = MCP23S17_WriteRegister(dev, MCP23S17_IODIRB, MCP23S17_ALL_ON); // GPB as output
+		}
+		if (result == DRV_OK)
+		{
+			result = status;
+		}
+
+		dev->GPA = dev->GPB = 0;
+		MCP23S17_Stage_LEDs(dev, 0xFFFF);	// All LEDs OFF
 	}
 
-	MCP23S17_Update_LEDs();
+	const drv_status_t flushed = MCP23S17_Flush();
+
+	return (result != DRV_OK) ? result : flushed;
 }
 
-void MCP23S17_Set_LEDs(uint16_t leds)
+/**
+ * @brief Sets the latches without writing them, see MCP23S17_Flush().
+ */
+void MCP23S17_Stage_LEDs(h_MCP23S17_t * dev, uint16_t leds)
 {
-	hMCP23S17.GPB = (0xFF00 & leds) >> 8;
-	hMCP23S17.GPA = 0xFF & leds;
+	const uint8_t GPB = (0xFF00 & leds) >> 8;
+	const uint8_t GPA = 0xFF & leds;
 
-	MCP23S17_Update_LEDs();
+	if (GPA != dev->GPA || GPB != dev->GPB)
+	{
+		dev->GPA = GPA;
+		dev->GPB = GPB;
+		dev->dirty = 1;
+	}
 }
 
 /*
  * @param level in percentage
  */
-void MCP23S17_level_R(int level)
+void MCP23S17_Stage_level_R(h_MCP23S17_t * dev, int level)
 {
 	if (level > 100) level = 100;
 	if (level <= 0) level = 0;
 
-	if (level <= 100)
-	{
-		hMCP23S17.GPA = 0xFF & (0x00FF << (int)(8*level/100));
-
-		MCP23S17_Update_LEDs();
-	}
+	MCP23S17_Stage_LEDs(dev, (dev->GPB << 8) | (0xFF & (0x00FF << (int)(8*level/100))));
 }
 
 /*
  * @param level in percentage
  */
-void MCP23S17_level_L(int level)
+void MCP23S17_Stage_level_L(h_MCP23S17_t * dev, int level)
 {
 	if (level > 100) level = 100;
 	if (level <= 0) level = 0;
 
-	if (level <= 100)
-	{
-		hMCP23S17.GPB = 0xFF & (0x00FF << (int)(8*level/100));
+	MCP23S17_Stage_LEDs(dev, ((0xFF & (0x00FF << (int)(8*level/100))) << 8) | dev->GPA);
+}
 
-		MCP23S17_Update_LEDs();
+drv_status_t MCP23S17_Set_LED_id(h_MCP23S17_t * dev, uint8_t led)
+{
+	if (led > 7)
+	{
+		MCP23S17_Stage_LEDs(dev, (~(1 << led%8) << 8) | 0xFF);	// All LEDs on GPIOA OFF
+	}
+	else
+	{
+		MCP23S17_Stage_LEDs(dev, 0xFF00 | (0xFF & ~(1 << led)));	// All LEDs on GPIOB OFF
 	}
+
+	return MCP23S17_Update_LEDs(dev);
+}
+
+drv_status_t MCP23S17_Toggle_LED_id(h_MCP23S17_t * dev, uint8_t led)
+{
+	MCP23S17_Stage_LEDs(dev, ((dev->GPB << 8) | dev->GPA) ^ (1 << (led % 16)));
+
+	return MCP23S17_Update_LEDs(dev);
+}
+
+drv_status_t MCP23S17_Set_LEDs(h_MCP23S17_t * dev, uint16_t leds)
+{
+	MCP23S17_Stage_LEDs(dev, leds);
+
+	return MCP23S17_Update_LEDs(dev);
+}
+
+/*
+ * @param level in percentage
+ */
+drv_status_t MCP23S17_level_R(h_MCP23S17_t * dev, int level)
+{
+	MCP23S17_Stage_level_R(dev, level);
+
+	return MCP23S17_Update_LEDs(dev);
+}
+
+/*
+ * @param level in percentage
+ */
+drv_status_t MCP23S17_level_L(h_MCP23S17_t * dev, int level)
+{
+	MCP23S17_Stage_level_L(dev, level);
+
+	return MCP23S17_Update_LEDs(dev);
 }
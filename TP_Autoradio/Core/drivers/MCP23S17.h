@@ -10,18 +10,54 @@
 
 #include <stdint.h>
 
-#define MCP23S17_CONTROL_ADDR 0b000
+#include "drv_status.h"
+
 #define MCP23S17_IODIRA  0x00
 #define MCP23S17_IODIRB  0x01
+#define MCP23S17_IOCON   0x0A
 #define MCP23S17_OLATA   0x14
 #define MCP23S17_OLATB 	 0x15
 
+#define MCP23S17_IOCON_HAEN (1 << 3)	// A2..A0 pins compared to the control byte
+
 #define MCP23S17_ALL_ON	 0x00
 #define MCP23S17_ALL_OFF 0xFF
 
-// Builds the VU-Metre control byte
-#define MCP23S17_CONTROL_BYTE(adress, RW)\
-		((0b0100 << 4) | (adress & 0b111 << 1) | RW)
+// Builds the control byte of the expander at a hardware address (A2..A0)
+#define MCP23S17_CONTROL_BYTE(address, RW)\
+		((0b0100 << 4) | (((address) & 0b111) << 1) | (RW))
+
+#define MCP23S17_MAX_DEVICES 8			// One per hardware address
+
+/**
+ * Expanders sharing SPI3, VU_nCS and VU_nRESET, told apart by their A2..A0
+ * pins once IOCON.HAEN is set. X(id, address, name)
+ * Each one is driven as 16 outputs (GPA, GPB); for a button matrix or a
+ * front panel, add it here and set its directions after MCP23S17_Init().
+ */
+#define MCP23S17_DEVICES(X) \
+	X(VU,	0b000,	"vu")
+
+typedef enum
+{
+#define MCP23S17_DEV_ENUM(id, address, name) MCP23S17_DEV_##id,
+	MCP23S17_DEVICES(MCP23S17_DEV_ENUM)
+#undef MCP23S17_DEV_ENUM
+	MCP23S17_DEV_COUNT
+} MCP23S17_dev_t;
+
+typedef struct {
+	const char * name;
+	uint8_t address;	// A2..A0
+	uint8_t present;	// Answered with HAEN set at init
+	uint8_t dirty;		// Latches changed since the last write
+	uint8_t GPA;		// LED array in GPIOA
+	uint8_t GPB;		// LED array in GPIOB
+} h_MCP23S17_t;
+
+extern h_MCP23S17_t hMCP23S17[MCP23S17_DEV_COUNT];
+
+#define MCP23S17_VU (&hMCP23S17[MCP23S17_DEV_VU])
 
 /**
   * @brief  MCP23S17 READ and WRITE enumeration
@@ -33,13 +69,18 @@ typedef enum
 } MCP23S17_Mode;
 
 
-void MCP23S17_WriteRegister(uint8_t reg, uint8_t data);
-void MCP23S17_Init(void);
-void MCP23S17_Set_LED_id(uint8_t led);
-void MCP23S17_Toggle_LED_id(uint8_t led);
-void MCP23S17_Set_LEDs(uint16_t leds);
-void MCP23S17_Update_LEDs(void);
-void MCP23S17_level_R(int level);
-void MCP23S17_level_L(int level);
+drv_status_t MCP23S17_WriteRegister(h_MCP23S17_t * dev, uint8_t reg, uint8_t data);
+drv_status_t MCP23S17_ReadRegister(uint8_t address, uint8_t reg, uint8_t * data);
+drv_status_t MCP23S17_Init(void);
+void MCP23S17_Stage_LEDs(h_MCP23S17_t * dev, uint16_t leds);
+void MCP23S17_Stage_level_R(h_MCP23S17_t * dev, int level);
+void MCP23S17_Stage_level_L(h_MCP23S17_t * dev, int level);
+drv_status_t MCP23S17_Update_LEDs(h_MCP23S17_t * dev);
+drv_status_t MCP23S17_Flush(void);
+drv_status_t MCP23S17_Set_LED_id(h_MCP23S17_t * dev, uint8_t led);
+drv_status_t MCP23S17_Toggle_LED_id(h_MCP23S17_t * dev, uint8_t led);
+drv_status_t MCP23S17_Set_LEDs(h_MCP23S17_t * dev, uint16_t leds);
+drv_status_t MCP23S17_level_R(h_MCP23S17_t * dev, int level);
+drv_status_t MCP23S17_level_L(h_MCP23S17_t * dev, int level);
 
 #endif /* DRIVERS_MCP23S17_H_ */
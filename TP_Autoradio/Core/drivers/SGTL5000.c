@@ -10,26 +10,78 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define LOGS 0
-#define DEBUG 0
+#include "../utils/log.h"
+#include "../utils/watchdog.h"
+
+#include <string.h>
+
+// Register cache: every register written, so that a read-modify-write needs no I2C read
+#define SGTL5000_CACHE_SIZE ((SGTL5000_DAP_COEF_WR_A2_LSB >> 1) + 1)
+
+#define SGTL5000_SSS_ROUTE_MASK 0x00F0	// DAP_SELECT (7:6), DAC_SELECT (5:4)
+#define SGTL5000_DAP_EN 0x0001
+
+// Blocks switched by SGTL5000_Power(), VAG and REFTOP stay up for a fast wake
+#define SGTL5000_DIG_OUTPUT 0x0031		// DAC_POWERUP, DAP_POWERUP, I2S_IN_POWERUP
+#define SGTL5000_DIG_INPUT 0x0042		// ADC_POWERUP, I2S_OUT_POWERUP
+#define SGTL5000_ANA_OUTPUT 0x001D		// HEADPHONE, DAC, CAPLESS_HEADPHONE, LINEOUT
+#define SGTL5000_ANA_INPUT 0x0002		// ADC_POWERUP
 
 typedef struct {
 	I2C_HandleTypeDef * hi2c;
 	uint16_t chip_id;
+	uint16_t cache[SGTL5000_CACHE_SIZE];
+	uint32_t cached[(SGTL5000_CACHE_SIZE + 31) / 32];	// Valid entries
+	sgtl5000_route_t route;
 } h_SGTL5000_t;
 
 h_SGTL5000_t hSGTL5000;
 
+static const struct {
+	const char * name;
+	uint16_t sss;		// DAP_SELECT, DAC_SELECT: 0 ADC, 1 I2S_IN, 3 DAP
+	uint8_t dap;
+} SGTL5000_routes[SGTL5000_ROUTE_COUNT] = {
+		{ "i2s-dac", 0x0010, 0 },
+		{ "i2s-dap-dac", 0x0070, 1 },
+		{ "adc-dap-dac", 0x0030, 1 },
+		{ "adc-dac", 0x0000, 0 },
+};
+
+
+// Per attempt, a register access is 5 bytes at 100 kHz
+#define SGTL5000_TIMEOUT_MS 10
+
+typedef struct {
+	uint16_t address;
+	uint8_t * data;
+	uint16_t length;
+} SGTL5000_access_t;
+
+static drv_status_t SGTL5000_Attempt_Read(void * ctx)
+{
+	SGTL5000_access_t * a = ctx;
+
+	return drv_from_hal(HAL_I2C_Mem_Read(hSGTL5000.hi2c, SGTL5000_CODEC,
+			a->address, SGTL5000_MEM_SIZE, a->data, a->length, SGTL5000_TIMEOUT_MS));
+}
+
+static drv_status_t SGTL5000_Attempt_Write(void * ctx)
+{
+	SGTL5000_access_t * a = ctx;
+
+	return drv_from_hal(HAL_I2C_Mem_Write(hSGTL5000.hi2c, SGTL5000_CODEC,
+			a->address, SGTL5000_MEM_SIZE, a->data, a->length, SGTL5000_TIMEOUT_MS));
+}
 
 /**
- * @brief Error handler for SGTL5000 operations.
- * @param message: Error message to display.
+ * @brief Bus reinitialization between two retries (a slave holding SDA is
+ * not released by this).
  */
-void SGTL5000_ErrorHandler(const char* message)
+static void SGTL5000_Recover(void)
 {
-	printf("SGTL5000 Error: %s\r\n", message);
-	Error_Handler();
-	NVIC_SystemReset();
+	HAL_I2C_DeInit(hSGTL5000.hi2c);
+	HAL_I2C_Init(hSGTL5000.hi2c);
 }
 
 /**
@@ -37,79 +89,92 @@ void SGTL5000_ErrorHandler(const char* message)
  * @param address: Register address to read from.
  * @param pData: Pointer to data buffer for storing the read data.
  * @param length: Number of bytes to read.
+ * @retval drv_status_t: DRV_OK, or why the read has not been done.
  */
-void SGTL5000_i2c_ReadRegister(uint16_t address, uint8_t* pData, uint16_t length)
+drv_status_t SGTL5000_i2c_ReadRegister(uint16_t address, uint8_t* pData, uint16_t length)
 {
-	HAL_StatusTypeDef status = HAL_I2C_Mem_Read(hSGTL5000.hi2c, SGTL5000_CODEC,
-			address, SGTL5000_MEM_SIZE, pData, length, HAL_MAX_DELAY);
+	SGTL5000_access_t a = { address, pData, length };
 
-	if (status != HAL_OK) {
-		printf("Error: Failed to read from address 0x%04X\r\n", address);
-		SGTL5000_ErrorHandler("ReadRegister failed");
+	watchdog_checkin(WATCHDOG_CODEC);
+	drv_status_t status = drv_transfer(DRV_PERIPH_SGTL5000, SGTL5000_Attempt_Read, &a);
+	watchdog_pause(WATCHDOG_CODEC);
+
+	if (status != DRV_OK && status != DRV_DEGRADED) {
+		LOG_ERR(LOG_MOD_SGTL5000, "Failed to read from address 0x%04X (%s)", address, drv_status_name(status));
 	}
+
+	return status;
 }
 
 /**
- * @brief Writes data to a register of SGTL5000 with error management.
+ * @brief Writes data to a register of SGTL5000 with error management, the
+ * cache is only updated if the write succeeded.
  * @param address: Register address to write to.
  * @param value: Data value to write to the register.
+ * @retval drv_status_t: DRV_OK, or why the write has not been done.
  */
-void SGTL5000_i2c_WriteRegister(uint16_t address, uint16_t value)
+drv_status_t SGTL5000_i2c_WriteRegister(uint16_t address, uint16_t value)
 {
 	uint8_t data[2] = { (uint8_t)(value >> 8), (uint8_t)(value & 0xFF) };
-	HAL_StatusTypeDef status = HAL_I2C_Mem_Write(hSGTL5000.hi2c, SGTL5000_CODEC,
-			address, SGTL5000_MEM_SIZE, data, 2, HAL_MAX_DELAY);
+	SGTL5000_access_t a = { address, data, 2 };
+
+	watchdog_checkin(WATCHDOG_CODEC);
+	drv_status_t status = drv_transfer(DRV_PERIPH_SGTL5000, SGTL5000_Attempt_Write, &a);
+	watchdog_pause(WATCHDOG_CODEC);
 
-	// Handle all possible I2C errors
 	switch (status) {
-	case HAL_OK:
+	case DRV_OK:
 		// Write successful
-#if LOGS
-		printf("Successfully wrote 0x%04X to address 0x%04X\r\n", value, address);
-#endif
+		if (address >> 1 < SGTL5000_CACHE_SIZE)
+		{
+			hSGTL5000.cache[address >> 1] = value;
+			hSGTL5000.cached[(address >> 1) / 32] |= 1U << ((address >> 1) % 32);
+		}
+		LOG_DBG(LOG_MOD_SGTL5000, "Successfully wrote 0x%04X to address 0x%04X", value, address);
 		break;
 
-	case HAL_ERROR:
-		// General HAL error
-		printf("Error: HAL_ERROR while writing 0x%04X to address 0x%04X\r\n", value, address);
-		SGTL5000_ErrorHandler("General HAL_ERROR during WriteRegister");
-		break;
-
-	case HAL_BUSY:
-		// HAL busy error
-		printf("Error: HAL_BUSY, I2C bus is busy while writing 0x%04X to 0x%04X\r\n", value, address);
-		SGTL5000_ErrorHandler("I2C bus busy during WriteRegister");
-		break;
-
-	case HAL_TIMEOUT:
-		// Timeout error
-		printf("Error: HAL_TIMEOUT while writing 0x%04X to address 0x%04X\r\n", value, address);
-		SGTL5000_ErrorHandler("Timeout during WriteRegister");
+	case DRV_DEGRADED:
+		// Not attempted, counted by the driver layer
 		break;
 
 	default:
-		// Unexpected error code
-		printf("Error: Unknown error (status code: %d) while writing 0x%04X to address 0x%04X\r\n", status, value, address);
-		SGTL5000_ErrorHandler("Unknown error during WriteRegister");
+		LOG_ERR(LOG_MOD_SGTL5000, "%s while writing 0x%04X to address 0x%04X", drv_status_name(status), value, address);
 		break;
 	}
+
+	return status;
 }
 
 /**
  * @brief Initializes the SGTL5000 codec.
+ * @retval drv_status_t: DRV_OK, DRV_INVALID if the chip id is not the
+ * expected one (nothing written then), DRV_ERROR if a write failed.
  */
-void SGTL5000_Init(void)
+drv_status_t SGTL5000_Init(void)
 {
 	hSGTL5000.hi2c = &hi2c2;
+	drv_register(DRV_PERIPH_SGTL5000, SGTL5000_Recover);
 
 	uint8_t chip_id_data[2];
-	SGTL5000_i2c_ReadRegister(SGTL5000_CHIP_ID, chip_id_data, SGTL5000_MEM_SIZE);
+	drv_status_t status = SGTL5000_i2c_ReadRegister(SGTL5000_CHIP_ID, chip_id_data, SGTL5000_MEM_SIZE);
+
+	if (status != DRV_OK)
+	{
+		return status;
+	}
 	hSGTL5000.chip_id = (chip_id_data[0] << 8) | chip_id_data[1];
 
 	if (hSGTL5000.chip_id != 0xA011) { // Example CHIP_ID, replace with actual expected ID
-		SGTL5000_ErrorHandler("Invalid CHIP_ID detected");
+		LOG_ERR(LOG_MOD_SGTL5000, "Invalid CHIP_ID detected: 0x%04X", hSGTL5000.chip_id);
+		return DRV_INVALID;
 	}
 
+	// Every write below is attempted, the failures are counted
+	drv_health_t health;
+
+	drv_get_health(DRV_PERIPH_SGTL5000, &health);
+	const uint32_t failures = health.failures + health.skipped;
+
 	uint16_t mask;
 
 	/* Chip Powerup and Supply Configurations */
@@ -130,9 +195,7 @@ void SGTL5000_Init(void)
 	mask = (1 << 12) | (1 << 13);
 	//mask = 0b0111001011111111;
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_ANA_POWER, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_ANA_POWER set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_ANA_POWER set as: 0x%04X", mask);
 
 	// NOTE: The next Write calls is needed only if both VDDA and
 	// VDDIO power supplies are less than 3.1V.
@@ -149,9 +212,7 @@ void SGTL5000_Init(void)
 	// VDDA and VDDIO = 3.3V so it IS necessary
 	mask = (1 << 5) | (1 << 6);
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_LINREG_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_LINREG_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_LINREG_CTRL set as: 0x%04X", mask);
 
 	//---- Reference Voltage and Bias Current Configuration----
 	// NOTE: The value written in the next 2 Write calls is dependent
@@ -162,9 +223,7 @@ void SGTL5000_Init(void)
 	// Write CHIP_REF_CTRL 0x004E
 	mask = 0x01FF;	// VAG_VAL = 1.575V, BIAS_CTRL = -50%, SMALL_POP = 1
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_REF_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_REF_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_REF_CTRL set as: 0x%04X", mask);
 
 	// Set LINEOUT reference voltage to VDDIO/2 (1.65 V) (bits 5:0)
 	// and bias current (bits 11:8) to the recommended value of 0.36 mA
@@ -173,9 +232,7 @@ void SGTL5000_Init(void)
 	//	mask = 0x0322;	// LO_VAGCNTRL = 1.65V, OUT_CURRENT = 0.36mA (?)
 	mask = 0x031E;
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_LINE_OUT_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_LINE_OUT_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_LINE_OUT_CTRL set as: 0x%04X", mask);
 
 	//------------Other Analog Block Configurations--------------
 	// Configure slow ramp up rate to minimize pop (bit 0)
@@ -188,18 +245,14 @@ void SGTL5000_Init(void)
 	// Write CHIP_SHORT_CTRL 0x1106
 	mask = 0x1106;	// MODE_CM = 2, MODE_LR = 1, LVLADJC = 200mA, LVLADJL = 75mA, LVLADJR = 50mA
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_SHORT_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_SHORT_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_SHORT_CTRL set as: 0x%04X", mask);
 
 	// Enable Zero-cross detect if needed for HP_OUT (bit 5) and ADC (bit 1)
 	// Write CHIP_ANA_CTRL 0x0133
 	mask = 0x0004;	// Unmute all + SELECT_ADC = LINEIN
 	//	mask = 0x0000;	// Unmute all + SELECT_ADC = MIC
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_ANA_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_ANA_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_ANA_CTRL set as: 0x%04X", mask);
 
 	//------------Power up Inputs/Outputs/Digital Blocks---------
 	// Power up LINEOUT, HP, ADC, DAC
@@ -208,18 +261,14 @@ void SGTL5000_Init(void)
 	// VAG_POWERUP, VCOAMP_POWERUP = 0, LINREG_D_POWERUP, PLL_POWERUP = 0, VDDC_CHRGPMP_POWERUP, STARTUP_POWERUP = 0, LINREG_SIMPLE_POWERUP,
 	// DAC_MONO = stereo
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_ANA_POWER, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_ANA_POWER set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_ANA_POWER set as: 0x%04X", mask);
 	// Power up desired digital blocks
 	// I2S_IN (bit 0), I2S_OUT (bit 1), DAP (bit 4), DAC (bit 5),
 	// ADC (bit 6) are powered on
 	// Write CHIP_DIG_POWER 0x0073
 	mask = 0x0073;	// I2S_IN_POWERUP, I2S_OUT_POWERUP, DAP_POWERUP, DAC_POWERUP, ADC_POWERUP
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_DIG_POWER, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_DIG_POWER set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_DIG_POWER set as: 0x%04X", mask);
 
 	//----------------Set LINEOUT Volume Level-------------------
 	// Set the LINEOUT volume level based on voltage reference (VAG)
@@ -231,9 +280,7 @@ void SGTL5000_Init(void)
 	// Write CHIP_LINE_OUT_VOL 0x0505
 	mask = 0x1111;	// TODO recalculer
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_LINE_OUT_VOL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_LINE_OUT_VOL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_LINE_OUT_VOL set as: 0x%04X", mask);
 
 	/* System MCLK and Sample Clock */
 
@@ -243,46 +290,38 @@ void SGTL5000_Init(void)
 	// Modify CHIP_CLK_CTRL->MCLK_FREQ 0x0000 // bits 1:0
 	mask = 0x0004;	// SYS_FS = 48kHz
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_CLK_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_CLK_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_CLK_CTRL set as: 0x%04X", mask);
 	// Configure the I2S clocks in master mode
 	// NOTE: I2S LRCLK is same as the system sample clock
 	// Modify CHIP_I2S_CTRL->MS 0x0001 // bit 7
 	// Non, on reste en slave!
 	mask = 0x0130;	// DLEN = 16 bits
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_I2S_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_I2S_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_I2S_CTRL set as: 0x%04X", mask);
 
 	/* PLL Configuration */
 	// Pas utilisé
 
 	/* Input/Output Routing */
-	// Laissons tout par défaut pour l'instant
-	//	mask = 0x0000;	// ADC -> DAC
-	//	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_SSS_CTRL, mask);
+	// ADC -> I2S_OUT (MCU), I2S_IN -> DAC: the default, written so that it is cached
+	mask = 0x0010;
+	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_SSS_CTRL, mask);
+	SGTL5000_i2c_WriteRegister(SGTL5000_DAP_CONTROL, 0x0000);
+	hSGTL5000.route = SGTL5000_ROUTE_I2S_DAC;
 
 	/* Le reste */
 	mask = 0x0000;	// Unmute
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_ADCDAC_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_ADCDAC_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_ADCDAC_CTRL set as: 0x%04X", mask);
 
 	mask = 0x3C3C;
 	//	mask = 0x4747;
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_DAC_VOL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_DAC_VOL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_DAC_VOL set as: 0x%04X", mask);
 
 	mask = 0x0251;	// BIAS_RESISTOR = 2, BIAS_VOLT = 5, GAIN = 1
 	SGTL5000_i2c_WriteRegister(SGTL5000_CHIP_MIC_CTRL, mask);
-#if (DEBUG)
-	printf("SGTL5000_CHIP_MIC_CTRL set as: 0x%04X\r\n", mask);
-#endif
+LOG_DBG(LOG_MOD_SGTL5000, "SGTL5000_CHIP_MIC_CTRL set as: 0x%04X", mask);
 
 	//	for (int i = 0 ; register_map[i] != SGTL5000_DAP_COEF_WR_A2_LSB ; i++)
 	//	{
@@ -291,7 +330,186 @@ void SGTL5000_Init(void)
 	//		printf("%02d: [0x%04x] = 0x%04x\r\n", i, register_map[i], reg);
 	//	}
 
-#if (LOGS)
-	printf("SGTL5000 initialized successfully, CHIP_ID: 0x%04X\r\n", hSGTL5000.chip_id);
-#endif
+	drv_get_health(DRV_PERIPH_SGTL5000, &health);
+	if (health.failures + health.skipped != failures)
+	{
+		LOG_ERR(LOG_MOD_SGTL5000, "SGTL5000 initialization incomplete, %lu writes failed", health.failures + health.skipped - failures);
+		return DRV_ERROR;
+	}
+
+	LOG_INFO(LOG_MOD_SGTL5000, "SGTL5000 initialized successfully, CHIP_ID: 0x%04X", hSGTL5000.chip_id);
+
+	return DRV_OK;
+}
+
+/**
+ * @brief Selects the ADC input (CHIP_ANA_CTRL SELECT_ADC, bit 2), the other bits are kept.
+ * @param mic: 1 for the microphone (MIC_CTRL settings), 0 for LINEIN.
+ */
+drv_status_t SGTL5000_Select_ADC(int mic)
+{
+	drv_status_t status = SGTL5000_Modify(SGTL5000_CHIP_ANA_CTRL, 1 << 2, mic ? 0 : (1 << 2));
+
+	LOG_INFO(LOG_MOD_SGTL5000, "ADC input: %s", mic ? "MIC" : "LINEIN");
+
+	return status;
+}
+
+/**
+ * @brief Source of the I2S output, i.e. the SAI input (CHIP_SSS_CTRL I2S_SELECT, bits 1:0).
+ * @param loopback: 1 to send the I2S input back (digital loopback for the
+ * latency measurement), 0 for the ADC.
+ */
+drv_status_t SGTL5000_Set_Loopback(int loopback)
+{
+	drv_status_t status = SGTL5000_Modify(SGTL5000_CHIP_SSS_CTRL, 0x0003, loopback ? 0x0001 : 0x0000);
+
+	LOG_INFO(LOG_MOD_SGTL5000, "I2S output: %s", loopback ? "I2S_IN (loopback)" : "ADC");
+
+	return status;
+}
+
+/**
+ * @brief Read-modify-write of some bits of a register. The current value
+ * comes from the cache (read once over I2C otherwise), nothing is written
+ * if it does not change (once cached).
+ * @param address: Register address.
+ * @param mask: Bits to change.
+ * @param value: New value of these bits.
+ * @retval drv_status_t: DRV_OK, or why the register has not been changed.
+ */
+drv_status_t SGTL5000_Modify(uint16_t address, uint16_t mask, uint16_t value)
+{
+	const uint32_t index = address >> 1;
+	const int cached = (index < SGTL5000_CACHE_SIZE) && (hSGTL5000.cached[index / 32] & (1U << (index % 32)));
+	uint16_t reg;
+
+	if (cached)
+	{
+		reg = hSGTL5000.cache[index];
+	}
+	else
+	{
+		uint8_t data[2];
+		drv_status_t status = SGTL5000_i2c_ReadRegister(address, data, SGTL5000_MEM_SIZE);
+
+		if (status != DRV_OK)
+		{
+			return status;
+		}
+		reg = (data[0] << 8) | data[1];
+	}
+
+	uint16_t next = (reg & ~mask) | (value & mask);
+
+	if (next != reg || !cached)
+	{
+		return SGTL5000_i2c_WriteRegister(address, next);
+	}
+
+	return DRV_OK;
+}
+
+/**
+ * @brief Selects a routing profile. The DAP is enabled before it is
+ * connected and disabled after, so that the DAC never takes a stopped DAP.
+ * @retval drv_status_t: DRV_OK, or the first failure (the profile is
+ * not changed, the DAP may stay enabled).
+ */
+drv_status_t SGTL5000_Set_Route(sgtl5000_route_t route)
+{
+	drv_status_t status = DRV_OK;
+
+	if (route >= SGTL5000_ROUTE_COUNT)
+	{
+		return DRV_INVALID;
+	}
+
+	if (SGTL5000_routes[route].dap)
+	{
+		status = SGTL5000_Modify(SGTL5000_DAP_CONTROL, SGTL5000_DAP_EN, SGTL5000_DAP_EN);
+	}
+	if (status == DRV_OK)
+	{
+		status = SGTL5000_Modify(SGTL5000_CHIP_SSS_CTRL, SGTL5000_SSS_ROUTE_MASK, SGTL5000_routes[route].sss);
+	}
+	if (status != DRV_OK)
+	{
+		return status;
+	}
+
+	hSGTL5000.route = route;
+	if (!SGTL5000_routes[route].dap)
+	{
+		status = SGTL5000_Modify(SGTL5000_DAP_CONTROL, SGTL5000_DAP_EN, 0);
+	}
+
+	LOG_INFO(LOG_MOD_SGTL5000, "Routing: %s", SGTL5000_routes[route].name);
+
+	return status;
+}
+
+sgtl5000_route_t SGTL5000_Get_Route(void)
+{
+	return hSGTL5000.route;
+}
+
+/**
+ * @retval int: 1 if the DAC is fed from the MCU (I2S input), 0 if the MCU is bypassed.
+ */
+int SGTL5000_Route_Uses_I2S(sgtl5000_route_t route)
+{
+	return (route == SGTL5000_ROUTE_I2S_DAC || route == SGTL5000_ROUTE_I2S_DAP_DAC);
+}
+
+int SGTL5000_Route_From_Name(const char * name)
+{
+	for (int i = 0; i < SGTL5000_ROUTE_COUNT; i++)
+	{
+		if (strcmp(name, SGTL5000_routes[i].name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * SGTL5000_Route_Name(sgtl5000_route_t route)
+{
+	return (route < SGTL5000_ROUTE_COUNT) ? SGTL5000_routes[route].name : "?";
+}
+
+/**
+ * @brief Powers the output (DAC, DAP, headphone and line out) and the input
+ * (ADC) blocks up or down, the references stay up so that the outputs come
+ * back without a pop nor a long ramp. The analog blocks are powered down
+ * after the digital ones and up before them.
+ * @param output: 1 to power the output path up, 0 to power it down.
+ * @param input: Same for the input path.
+ * @retval drv_status_t: DRV_OK, or the first failure.
+ */
+drv_status_t SGTL5000_Power(int output, int input)
+{
+	const uint16_t dig = (output ? SGTL5000_DIG_OUTPUT : 0) | (input ? SGTL5000_DIG_INPUT : 0);
+	const uint16_t ana = (output ? SGTL5000_ANA_OUTPUT : 0) | (input ? SGTL5000_ANA_INPUT : 0);
+
+	drv_status_t status = DRV_OK;
+
+	if (output || input)
+	{
+		status = SGTL5000_Modify(SGTL5000_CHIP_ANA_POWER, SGTL5000_ANA_OUTPUT | SGTL5000_ANA_INPUT, ana);
+	}
+	if (status == DRV_OK)
+	{
+		status = SGTL5000_Modify(SGTL5000_CHIP_DIG_POWER, SGTL5000_DIG_OUTPUT | SGTL5000_DIG_INPUT, dig);
+	}
+	if (status == DRV_OK)
+	{
+		status = SGTL5000_Modify(SGTL5000_CHIP_ANA_POWER, SGTL5000_ANA_OUTPUT | SGTL5000_ANA_INPUT, ana);
+	}
+
+	LOG_INFO(LOG_MOD_SGTL5000, "Power: output %s, input %s", output ? "on" : "off", input ? "on" : "off");
+
+	return status;
 }
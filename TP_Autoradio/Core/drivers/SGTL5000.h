@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 
+#include "drv_status.h"
+
 #define SGTL5000_MEM_SIZE 2	// Size in bytes of addresses
 
 #define SGTL5000_CODEC 0x14	// SGTL5000 I2C Address
@@ -83,10 +85,32 @@ typedef enum sgtl5000_registers_enum
 	SGTL5000_DAP_COEF_WR_A2_LSB = 0x013A
 } sgtl5000_registers_t;
 
+/**
+ * Routing profiles (CHIP_SSS_CTRL DAC_SELECT and DAP_SELECT, DAP_CONTROL DAP_EN).
+ * The I2S output to the MCU stays on the ADC. The ADC profiles do not use
+ * the I2S input: the audio does not go through the MCU.
+ */
+typedef enum
+{
+	SGTL5000_ROUTE_I2S_DAC = 0U,	// MCU processing (default)
+	SGTL5000_ROUTE_I2S_DAP_DAC,		// MCU then codec DAP
+	SGTL5000_ROUTE_ADC_DAP_DAC,		// Codec only, with the DAP
+	SGTL5000_ROUTE_ADC_DAC,			// Direct bypass
+	SGTL5000_ROUTE_COUNT
+} sgtl5000_route_t;
+
 // Function prototypes
-void SGTL5000_Init(void);
-void SGTL5000_ReadRegister(uint16_t address, uint8_t* pData, uint16_t length);
-void SGTL5000_WriteRegister(uint16_t address, uint16_t value);
-void SGTL5000_ErrorHandler(const char* message);
+drv_status_t SGTL5000_Init(void);
+drv_status_t SGTL5000_i2c_ReadRegister(uint16_t address, uint8_t* pData, uint16_t length);
+drv_status_t SGTL5000_i2c_WriteRegister(uint16_t address, uint16_t value);
+drv_status_t SGTL5000_Select_ADC(int mic);
+drv_status_t SGTL5000_Set_Loopback(int loopback);
+drv_status_t SGTL5000_Modify(uint16_t address, uint16_t mask, uint16_t value);
+drv_status_t SGTL5000_Set_Route(sgtl5000_route_t route);
+sgtl5000_route_t SGTL5000_Get_Route(void);
+int SGTL5000_Route_Uses_I2S(sgtl5000_route_t route);
+int SGTL5000_Route_From_Name(const char * name);
+const char * SGTL5000_Route_Name(sgtl5000_route_t route);
+drv_status_t SGTL5000_Power(int output, int input);
 
 #endif /* DRIVERS_SGTL5000_H_ */
@@ -0,0 +1,235 @@
+/*
+ * drv_status.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "drv_status.h"
+
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "../utils/log.h"
+
+typedef struct {
+	const char * name;
+	log_module_t log;
+	drv_recover_t recover;
+	drv_health_t health;
+} drv_entry_t;
+
+static drv_entry_t drv_table[DRV_PERIPH_COUNT] = {
+		{ .name = "mcp23s17", .log = LOG_MOD_MCP23S17 },
+		{ .name = "sgtl5000", .log = LOG_MOD_SGTL5000 },
+};
+
+static const char * const drv_status_names[DRV_STATUS_COUNT] = {
+		"ok", "error", "busy", "timeout", "degraded", "invalid"
+};
+
+
+static uint32_t drv_now(void)
+{
+	return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+/**
+ * @brief Backoff: the other tasks run meanwhile, busy wait before the scheduler.
+ */
+static void drv_delay(uint32_t ms)
+{
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		vTaskDelay(ms / portTICK_PERIOD_MS);
+	}
+	else
+	{
+		HAL_Delay(ms);
+	}
+}
+
+/**
+ * @brief Declares how to reinitialize the bus of a peripheral.
+ * @param recover: NULL if there is nothing to do.
+ */
+void drv_register(drv_periph_t periph, drv_recover_t recover)
+{
+	if (periph < DRV_PERIPH_COUNT)
+	{
+		drv_table[periph].recover = recover;
+	}
+}
+
+/**
+ * @brief Runs a bus transfer with the retry, backoff and degraded policy,
+ * from a task or before the scheduler (not from an ISR: the backoff blocks).
+ * @param periph: Peripheral, for its counters and state.
+ * @param attempt: One transfer, returns its status.
+ * @param ctx: Given to attempt.
+ * @retval drv_status_t: DRV_OK, the status of the last attempt, or
+ * DRV_DEGRADED if it was not attempted.
+ */
+drv_status_t drv_transfer(drv_periph_t periph, drv_attempt_t attempt, void * ctx)
+{
+	drv_entry_t * d = &drv_table[periph];
+	drv_health_t * h = &d->health;
+	drv_status_t status = DRV_ERROR;
+	uint32_t tries = DRV_RETRIES + 1;
+
+	h->transfers++;
+
+	if (h->degraded)
+	{
+		if (drv_now() - h->probe_tick < DRV_PROBE_MS)
+		{
+			h->skipped++;
+			h->last = DRV_DEGRADED;
+			return DRV_DEGRADED;
+		}
+
+		// Probe: a single attempt on a fresh bus
+		h->probe_tick = drv_now();
+		tries = 1;
+		if (d->recover != NULL)
+		{
+			d->recover();
+			h->recoveries++;
+		}
+	}
+
+	for (uint32_t i = 0; i < tries; i++)
+	{
+		if (i > 0)
+		{
+			h->retries++;
+			if (i == DRV_RETRIES && d->recover != NULL)
+			{
+				d->recover();
+				h->recoveries++;
+			}
+			drv_delay(DRV_BACKOFF_MS << (i - 1));
+		}
+
+		if (h->inject > 0)
+		{
+			h->inject--;
+			status = DRV_ERROR;
+		}
+		else
+		{
+			status = attempt(ctx);
+		}
+
+		if (status == DRV_OK)
+		{
+			break;
+		}
+		h->errors[status]++;
+	}
+
+	h->last = status;
+
+	if (status == DRV_OK)
+	{
+		if (h->degraded)
+		{
+			h->degraded = 0;
+			LOG_WARN(d->log, "%s: back from degraded mode", d->name);
+		}
+		h->consecutive = 0;
+		return DRV_OK;
+	}
+
+	h->failures++;
+	if (!h->degraded && ++h->consecutive >= DRV_DEGRADE_AFTER)
+	{
+		h->degraded = 1;
+		h->degradations++;
+		h->probe_tick = drv_now();
+		LOG_ERR(d->log, "%s: degraded after %d failed calls", d->name, DRV_DEGRADE_AFTER);
+	}
+
+	return status;
+}
+
+/**
+ * @param hal_status: HAL_StatusTypeDef.
+ */
+drv_status_t drv_from_hal(int hal_status)
+{
+	switch (hal_status)
+	{
+	case HAL_OK:
+		return DRV_OK;
+	case HAL_BUSY:
+		return DRV_BUSY;
+	case HAL_TIMEOUT:
+		return DRV_TIMEOUT;
+	default:
+		return DRV_ERROR;
+	}
+}
+
+int drv_is_degraded(drv_periph_t periph)
+{
+	return (periph < DRV_PERIPH_COUNT) && drv_table[periph].health.degraded;
+}
+
+void drv_get_health(drv_periph_t periph, drv_health_t * health)
+{
+	taskENTER_CRITICAL();
+	*health = drv_table[periph].health;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Clears the counters, the degraded state is kept.
+ */
+void drv_reset_health(drv_periph_t periph)
+{
+	drv_health_t * h = &drv_table[periph].health;
+
+	taskENTER_CRITICAL();
+	const uint8_t degraded = h->degraded;
+	const uint32_t probe_tick = h->probe_tick;
+
+	memset(h, 0, sizeof(*h));
+	h->degraded = degraded;
+	h->probe_tick = probe_tick;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Fault injection: the next attempts fail with DRV_ERROR without
+ * touching the bus, to exercise the retries and the degraded mode.
+ */
+void drv_inject(drv_periph_t periph, uint32_t attempts)
+{
+	drv_table[periph].health.inject = attempts;
+}
+
+int drv_periph_from_name(const char * name)
+{
+	for (int i = 0; i < DRV_PERIPH_COUNT; i++)
+	{
+		if (strcmp(name, drv_table[i].name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const char * drv_periph_name(drv_periph_t periph)
+{
+	return (periph < DRV_PERIPH_COUNT) ? drv_table[periph].name : "?";
+}
+
+const char * drv_status_name(drv_status_t status)
+{
+	return (status < DRV_STATUS_COUNT) ? drv_status_names[status] : "?";
+}
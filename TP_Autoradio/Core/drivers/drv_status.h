@@ -0,0 +1,76 @@
+/*
+ * drv_status.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef DRIVERS_DRV_STATUS_H_
+#define DRIVERS_DRV_STATUS_H_
+
+#include <stdint.h>
+
+/**
+ * Common status of the driver calls, and the policy applied to each bus
+ * transfer instead of stopping the MCU:
+ * - a failed attempt is retried DRV_RETRIES times, after DRV_BACKOFF_MS,
+ *   then twice as long; the bus is reinitialized before the last retry;
+ * - after DRV_DEGRADE_AFTER failed calls in a row the peripheral is
+ *   degraded: its calls return DRV_DEGRADED at once, without touching the
+ *   bus, and one attempt is made every DRV_PROBE_MS to bring it back.
+ * A dead LED expander then costs nothing to the audio, which does not
+ * depend on it. Counters are kept per peripheral.
+ */
+#define DRV_RETRIES 2
+#define DRV_BACKOFF_MS 1
+#define DRV_DEGRADE_AFTER 3
+#define DRV_PROBE_MS 2000
+
+typedef enum
+{
+	DRV_OK = 0U,
+	DRV_ERROR,				// Bus error (NACK, mode fault...)
+	DRV_BUSY,
+	DRV_TIMEOUT,
+	DRV_DEGRADED,			// Not attempted, the peripheral is degraded
+	DRV_INVALID,			// Unexpected answer (chip id) or parameter
+	DRV_STATUS_COUNT
+} drv_status_t;
+
+typedef enum
+{
+	DRV_PERIPH_MCP23S17 = 0U,
+	DRV_PERIPH_SGTL5000,
+	DRV_PERIPH_COUNT
+} drv_periph_t;
+
+typedef struct {
+	uint32_t transfers;					// Calls
+	uint32_t errors[DRV_STATUS_COUNT];	// Failed attempts, by status
+	uint32_t retries;
+	uint32_t failures;					// Calls failed after every retry
+	uint32_t recoveries;				// Bus reinitializations
+	uint32_t skipped;					// Calls refused while degraded
+	uint32_t degradations;
+	uint32_t inject;					// Attempts still to fail (test)
+	uint32_t probe_tick;				// Last attempt while degraded
+	uint8_t consecutive;				// Failed calls in a row
+	uint8_t degraded;
+	uint8_t last;						// drv_status_t of the last call
+} drv_health_t;
+
+typedef drv_status_t (* drv_attempt_t)(void * ctx);	// One bus transfer
+typedef void (* drv_recover_t)(void);				// Bus reinitialization
+
+void drv_register(drv_periph_t periph, drv_recover_t recover);
+drv_status_t drv_transfer(drv_periph_t periph, drv_attempt_t attempt, void * ctx);
+drv_status_t drv_from_hal(int hal_status);
+int drv_is_degraded(drv_periph_t periph);
+void drv_get_health(drv_periph_t periph, drv_health_t * health);
+void drv_reset_health(drv_periph_t periph);
+void drv_inject(drv_periph_t periph, uint32_t attempts);
+int drv_periph_from_name(const char * name);
+const char * drv_periph_name(drv_periph_t periph);
+const char * drv_status_name(drv_status_t status);
+
+#endif /* DRIVERS_DRV_STATUS_H_ */
@@ -7,9 +7,20 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "functions.h"
 
+#include "main.h"
+#include "cmsis_os.h"
+
 #include "../drivers/MCP23S17.h"
+#include "../drivers/SGTL5000.h"
+#include "../audio/audio.h"
+#include "../utils/log.h"
+#include "../utils/bench.h"
+#include "../utils/power.h"
+#include "../utils/sched.h"
+#include "../utils/watchdog.h"
 
 
 int fonction(int argc, char ** argv)
@@ -71,7 +82,7 @@ int GPIOExpander_toggle_LED(int argc, char ** argv)
 	{
 		for (int i = 1; i < argc; i++)
 		{
-			MCP23S17_Toggle_LED_id(atoi(argv[i]));
+			MCP23S17_Toggle_LED_id(MCP23S17_VU, atoi(argv[i]));
 		}
 	}
 
@@ -82,7 +93,1105 @@ int GPIOExpander_set_LED(int argc, char ** argv)
 {
 	if (argc > 1)
 	{
-		MCP23S17_Set_LED_id(atoi(argv[1]));
+		MCP23S17_Set_LED_id(MCP23S17_VU, atoi(argv[1]));
+	}
+
+	return 0;
+}
+
+int Logger_set_level(int argc, char ** argv)
+{
+	if (argc >= 3)
+	{
+		if (log_set_level(argv[1], atoi(argv[2])) != 0)
+		{
+			printf("Module '%s' ou niveau '%s' inconnu\r\n", argv[1], argv[2]);
+			return -1;
+		}
+	}
+
+	log_print_levels();
+	printf("Records perdus: %lu\r\n", log_dropped());
+
+	return 0;
+}
+
+int RTOS_memory_report(int argc, char ** argv)
+{
+	app_tasks_report();
+
+	return 0;
+}
+
+int Bench_placement(int argc, char ** argv)
+{
+	bench_placement((argc > 1) ? atoi(argv[1]) : 0);
+
+	return 0;
+}
+
+int Generator_set(int argc, char ** argv)
+{
+	siggen_t * gen = &audio_generator;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "off") == 0)
+		{
+			audio_set_source(AUDIO_SOURCE_LINE_IN);
+		}
+		else
+		{
+			int wave = siggen_wave_from_name(argv[1]);
+
+			if (wave < 0)
+			{
+				printf("Onde '%s' inconnue (sine, tri, square, saw, white, pink)\r\n", argv[1]);
+				return -1;
+			}
+
+			siggen_set_wave(gen, wave);
+			if (argc > 2)
+			{
+				siggen_set_frequency(gen, strtof(argv[2], NULL));
+			}
+			if (argc > 3)
+			{
+				int percent = atoi(argv[3]);
+				if (percent < 0) percent = 0;
+				if (percent > 100) percent = 100;
+				siggen_set_amplitude(gen, (int16_t)(percent * 32767 / 100));
+			}
+			siggen_set_band_limited(gen, (argc > 4) && (strcmp(argv[4], "bl") == 0));
+			audio_set_source(AUDIO_SOURCE_GENERATOR);
+		}
+	}
+
+	if (audio_get_source() != AUDIO_SOURCE_LINE_IN)
+	{
+		uint32_t mhz = (uint32_t)(siggen_frequency(gen) * 1000.0f);
+
+		printf("Generateur: %s %lu.%03lu Hz, %d %%%s%s\r\n", siggen_wave_name(gen->wave),
+				mhz / 1000, mhz % 1000, gen->amplitude * 100 / 32767,
+				gen->band_limited ? ", band-limited" : "",
+				(audio_get_source() == AUDIO_SOURCE_RESAMPLED) ? ", a 44.1 kHz (S)" : "");
+	}
+	else
+	{
+		printf("Generateur: off (entree ligne)\r\n");
+	}
+
+	return 0;
+}
+
+int Equalizer_set(int argc, char ** argv)
+{
+	biquad_t * eq = &audio_eq;
+	int status = 0;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "off") == 0)
+		{
+			status = audio_eq_set_stages(0);
+		}
+		else if (strcmp(argv[1], "form") == 0 && argc > 2)
+		{
+			int type = biquad_type_from_name(argv[2]);
+
+			if (type < 0)
+			{
+				printf("Forme '%s' inconnue (df1, tdf2, q15)\r\n", argv[2]);
+				return -1;
+			}
+			status = audio_eq_set_type(type);
+		}
+		else if (strcmp(argv[1], "bench") == 0)
+		{
+			bench_biquad((argc > 2) ? atoi(argv[2]) : 0);
+			return 0;
+		}
+		else
+		{
+			// q <shape> <f0> [Q] [gain dB] [stage]
+			int shape = biquad_shape_from_name(argv[1]);
+			biquad_coefs_t coefs;
+
+			if (shape < 0 || argc < 3)
+			{
+				printf("Usage: q <lp|hp|bp|notch|peak|ls|hs> <f0> [Q] [dB] [etage]\r\n");
+				return -1;
+			}
+
+			float q = (argc > 3) ? strtof(argv[3], NULL) : 0.707f;
+			float gain = (argc > 4) ? strtof(argv[4], NULL) : 0.0f;
+			int stage = (argc > 5) ? atoi(argv[5]) : 0;
+
+			if (biquad_design(&coefs, shape, AUDIO_SAMPLE_RATE, strtof(argv[2], NULL), q, gain) != 0
+					|| audio_eq_set_stage(stage, &coefs) != 0)
+			{
+				printf("Parametres hors limites\r\n");
+				return -1;
+			}
+		}
+
+		// Applied by the audio task between two blocks
+		if (status != 0 || audio_params_sync() != 0)
+		{
+			printf("EQ inchange, audio arrete ?\r\n");
+			return -1;
+		}
+	}
+
+	printf("EQ: %s, %lu etage(s)\r\n", biquad_type_name(eq->type), eq->stages);
+	for (uint32_t s = 0; s < eq->stages; s++)
+	{
+		const biquad_coefs_t * c = &eq->coefs[s];
+
+		printf("  %lu: b = %ld %ld %ld, a = %ld %ld (Q30)\r\n", s, c->b0, c->b1, c->b2, c->a1, c->a2);
+	}
+
+	return 0;
+}
+
+int RC_filter_set(int argc, char ** argv)
+{
+	rc_filter_t * rc = &audio_rc;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "bench") == 0)
+		{
+			bench_rc_filter((argc > 2) ? atoi(argv[2]) : 0);
+			return 0;
+		}
+
+		int mode = rc_filter_mode_from_name(argv[1]);
+
+		if (mode < 0)
+		{
+			printf("Usage: F <lp|hp|off> [Hz] | F bench [n]\r\n");
+			return -1;
+		}
+		if (audio_rc_set(mode, (argc > 2) ? (uint32_t)atoi(argv[2]) : rc->cutoff) != 0)
+		{
+			printf("Frequence de coupure hors limites (1 - %lu Hz)\r\n", rc->sample_rate / 2);
+			return -1;
+		}
+		if (audio_params_sync() != 0)
+		{
+			printf("Filtre RC inchange, audio arrete ?\r\n");
+			return -1;
+		}
+	}
+
+	printf("Filtre RC: %s, fc = %lu Hz\r\n", rc_filter_mode_name(rc->mode), rc->cutoff);
+
+	return 0;
+}
+
+int Echo_set(int argc, char ** argv)
+{
+	delay_t * dl = &audio_delay;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "bench") == 0)
+		{
+			bench_delay((argc > 2) ? atoi(argv[2]) : 0);
+			return 0;
+		}
+
+		if (strcmp(argv[1], "off") == 0)
+		{
+			delay_enable(dl, 0);
+		}
+		else
+		{
+			// e <ms> [feedback %] [wet %]
+			if (delay_set_time(dl, strtof(argv[1], NULL)) != 0)
+			{
+				printf("Retard hors limites (max %lu ms)\r\n", (dl->mask - 1) * 1000 / dl->sample_rate);
+				return -1;
+			}
+			if (argc > 2)
+			{
+				int16_t feedback = (int16_t)(atoi(argv[2]) * 32767 / 100);
+				int16_t wet = (argc > 3) ? (int16_t)(atoi(argv[3]) * 32767 / 100) : (int16_t)dl->wet;
+
+				// Applied by the audio task between two blocks
+				if (audio_delay_set_mix(feedback, wet, (int16_t)dl->dry) != 0 || audio_params_sync() != 0)
+				{
+					printf("Echo inchange, audio arrete ?\r\n");
+					return -1;
+				}
+			}
+			delay_enable(dl, 1);
+		}
+	}
+
+	uint32_t us = (uint32_t)(delay_get_time(dl) * 1000.0f);
+
+	printf("Echo: %s, %lu.%03lu ms, feedback %ld %%, wet %ld %% (ligne %lu trames)\r\n",
+			dl->enabled ? "on" : "off", us / 1000, us % 1000,
+			dl->feedback * 100 / 32767, dl->wet * 100 / 32767, dl->mask + 1);
+
+	return 0;
+}
+
+int Reverb_set(int argc, char ** argv)
+{
+	reverb_t * rv = &audio_reverb;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "bench") == 0)
+		{
+			int enabled = rv->enabled;
+
+			// The bench borrows the lines of the audio reverb
+			reverb_enable(rv, 0);
+			bench_reverb(rv, (argc > 2) ? atoi(argv[2]) : 0);
+			reverb_enable(rv, enabled);
+			return 0;
+		}
+
+		if (strcmp(argv[1], "off") == 0)
+		{
+			reverb_enable(rv, 0);
+		}
+		else if (strcmp(argv[1], "combs") == 0)
+		{
+			if (argc < 3 || reverb_set_active_combs(rv, (uint32_t)atoi(argv[2])) != 0)
+			{
+				printf("Nombre de combs entre 1 et %d\r\n", REVERB_MAX_COMBS);
+				return -1;
+			}
+		}
+		else
+		{
+			// R <room %> [damping %] [wet %]
+			int room = atoi(argv[1]);
+			int damping = (argc > 2) ? atoi(argv[2]) : rv->damping;
+			int wet = (argc > 3) ? atoi(argv[3]) : rv->wet;
+
+			if (audio_reverb_set_params(room, damping, wet) != 0 || audio_params_sync() != 0)
+			{
+				printf("Reverb inchangee, audio arrete ?\r\n");
+				return -1;
+			}
+			reverb_enable(rv, 1);
+		}
+	}
+
+	printf("Reverb: %s, room %u %%, damping %u %%, wet %u %%, %lu/%d combs (%lu octets)\r\n",
+			rv->enabled ? "on" : "off", rv->room, rv->damping, rv->wet,
+			rv->active_combs, REVERB_MAX_COMBS, reverb_memory(REVERB_MAX_COMBS));
+
+	return 0;
+}
+
+int Compressor_set(int argc, char ** argv)
+{
+	dynamics_t * dyn = &audio_dynamics;
+
+	if (argc > 1 && strcmp(argv[1], "off") == 0)
+	{
+		dynamics_enable(dyn, 0);
+	}
+	else if (argc > 1)
+	{
+		dynamics_params_t params;
+
+		dynamics_get_params(dyn, &params);
+
+		if (strcmp(argv[1], "gain") == 0)
+		{
+			params.makeup = (argc > 2) ? strtof(argv[2], NULL) : 0.0f;
+		}
+		else if (strcmp(argv[1], "limit") == 0)
+		{
+			// C limit [dB]: peak limiter, one block of look-ahead and instantaneous attack
+			params.threshold = (argc > 2) ? strtof(argv[2], NULL) : -1.0f;
+			params.ratio = DYN_RATIO_MAX + 1.0f;
+			params.knee = 0.0f;
+			params.attack_ms = 0.0f;
+			params.lookahead_ms = 1000.0f * ((audio_block_frames < DYN_LOOKAHEAD_LENGTH) ?
+					audio_block_frames : DYN_LOOKAHEAD_LENGTH - 1) / AUDIO_SAMPLE_RATE;
+			if (audio_block_frames >= DYN_LOOKAHEAD_LENGTH)
+			{
+				printf("Look-ahead limite a %d trames (blocs de %lu): depassements possibles\r\n",
+						DYN_LOOKAHEAD_LENGTH - 1, audio_block_frames);
+			}
+		}
+		else
+		{
+			// C <threshold dB> [ratio] [attack ms] [release ms] [knee dB] [look-ahead ms]
+			params.threshold = strtof(argv[1], NULL);
+			if (argc > 2) params.ratio = strtof(argv[2], NULL);
+			if (argc > 3) params.attack_ms = strtof(argv[3], NULL);
+			if (argc > 4) params.release_ms = strtof(argv[4], NULL);
+			if (argc > 5) params.knee = strtof(argv[5], NULL);
+			if (argc > 6) params.lookahead_ms = strtof(argv[6], NULL);
+		}
+
+		if (params.lookahead_ms < 0.0f || params.lookahead_ms > dynamics_max_lookahead(dyn))
+		{
+			printf("Look-ahead hors limites (max %lu us)\r\n",
+					(uint32_t)(DYN_LOOKAHEAD_LENGTH - 1) * 1000000U / dyn->sample_rate);
+			return -1;
+		}
+		// Applied by the audio task between two blocks, enabled once in place
+		if (audio_dynamics_set(&params) != 0 || audio_params_sync() != 0)
+		{
+			printf("Compresseur inchange, audio arrete ?\r\n");
+			return -1;
+		}
+		if (strcmp(argv[1], "gain") != 0)
+		{
+			dynamics_enable(dyn, 1);
+		}
+	}
+
+	// Displayed in tenths (no float printf)
+	int32_t ratio = (dyn->slope >= 32768) ? -1 : (int32_t)(dyn->ratio * 10.0f);
+	int32_t lookahead = (int32_t)(dynamics_get_lookahead(dyn) * 10.0f);
+
+	printf("Compresseur: %s, seuil %ld dB, ratio ", dyn->enabled ? "on" : "off", dyn->threshold / 256);
+	if (ratio < 0) printf("inf");
+	else printf("%ld.%ld", ratio / 10, ratio % 10);
+	printf(", attack %lu ms, release %lu ms, knee %ld dB, look-ahead %ld.%ld ms, gain +%ld dB\r\n",
+			(uint32_t)dyn->attack_ms, (uint32_t)dyn->release_ms, dyn->knee / 256,
+			lookahead / 10, lookahead % 10, dyn->makeup / 256);
+	printf("Niveau L %ld dB, R %ld dB, reduction %ld dB\r\n", dyn->detector.db[0] / 256,
+			dyn->detector.db[1] / 256, dyn->reduction / 256);
+
+	return 0;
+}
+
+int Loudness_set(int argc, char ** argv)
+{
+	static int adc_mic = 0;
+	loudness_t * ld = &audio_loudness;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "mic") == 0)
+		{
+			if (audio_get_source() == AUDIO_SOURCE_LINE_IN)
+			{
+				printf("Source line-in: le micro serait joue, choisir le generateur (g)\r\n");
+				return -1;
+			}
+			if (SGTL5000_Select_ADC(1) != DRV_OK)
+			{
+				printf("Codec injoignable (voir E)\r\n");
+				return -1;
+			}
+			adc_mic = 1;
+		}
+		else if (strcmp(argv[1], "line") == 0)
+		{
+			loudness_enable(ld, 0);
+			if (SGTL5000_Select_ADC(0) != DRV_OK)
+			{
+				printf("Codec injoignable (voir E)\r\n");
+				return -1;
+			}
+			adc_mic = 0;
+		}
+		else if (strcmp(argv[1], "on") == 0)
+		{
+			if (!adc_mic)
+			{
+				printf("L'ADC doit etre sur le micro: n mic\r\n");
+				return -1;
+			}
+			loudness_enable(ld, 1);
+			sched_signal(SCHED_EVT_LOUDNESS);
+		}
+		else if (strcmp(argv[1], "off") == 0)
+		{
+			loudness_enable(ld, 0);
+		}
+		else if (strcmp(argv[1], "ref") == 0 && argc > 2)
+		{
+			loudness_set_reference(ld, strtof(argv[2], NULL));
+		}
+	}
+
+	printf("Loudness: %s, ADC %s, reference %ld dB, bruit %ld dB, micro %ld dB\r\n",
+			ld->enabled ? "on" : "off", adc_mic ? "micro" : "line-in",
+			ld->reference / 256, ld->noise / 256, ld->mic / 256);
+	printf("Gain +%ld.%ld dB, graves +%ld.%ld dB, aigus +%ld.%ld dB\r\n",
+			ld->gain_db / 256, (ld->gain_db % 256) * 10 / 256, ld->bass_db / 256, (ld->bass_db % 256) * 10 / 256,
+			ld->treble_db / 256, (ld->treble_db % 256) * 10 / 256);
+
+	return 0;
+}
+
+int Display_set(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "bench") == 0)
+		{
+			bench_fft((argc > 2) ? atoi(argv[2]) : 0);
+			return 0;
+		}
+
+		spectrum_enable(&audio_spectrum, strcmp(argv[1], "spectre") == 0);
+		sched_signal(SCHED_EVT_DISPLAY);
+	}
+
+	printf("Affichage: %s", audio_spectrum.enabled ? "spectre" : "VU-metre");
+	if (audio_spectrum.enabled)
+	{
+		printf(", %d bandes, FFT %d points, %d ms", SPECTRUM_BANDS, SPECTRUM_FFT_SIZE, SPECTRUM_PERIOD_MS);
+	}
+	printf("\r\n");
+
+	return 0;
+}
+
+int Resampler_set(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "bench") == 0)
+		{
+			bench_src((argc > 2) ? atoi(argv[2]) : 0);
+			return 0;
+		}
+
+		if (strcmp(argv[1], "on") == 0)
+		{
+			audio_set_source(AUDIO_SOURCE_RESAMPLED);
+		}
+		else if (strcmp(argv[1], "off") == 0)
+		{
+			if (audio_get_source() == AUDIO_SOURCE_RESAMPLED)
+			{
+				audio_set_source(AUDIO_SOURCE_GENERATOR);
+			}
+		}
+		else if (strcmp(argv[1], "drift") == 0)
+		{
+			// S drift <ppm>: offset of the simulated 44.1 kHz clock
+			int ppm = (argc > 2) ? atoi(argv[2]) : 0;
+
+			if (ppm < -SRC_MAX_PPM || ppm > SRC_MAX_PPM)
+			{
+				printf("Derive entre %d et %d ppm\r\n", -SRC_MAX_PPM, SRC_MAX_PPM);
+				return -1;
+			}
+			audio_set_src_drift(ppm);
+		}
+		else
+		{
+			int quality = src_quality_from_name(argv[1]);
+
+			if (quality < 0)
+			{
+				printf("Qualite '%s' inconnue (fast, medium, best)\r\n", argv[1]);
+				return -1;
+			}
+			audio_set_src_quality((src_quality_t)quality);
+		}
+	}
+
+	printf("Convertisseur: %s, %lu -> %lu Hz, %s (%lu coefs), derive %ld ppm, correction %ld ppm, FIFO %lu/%d\r\n",
+			(audio_get_source() == AUDIO_SOURCE_RESAMPLED) ? "on" : "off",
+			AUDIO_SRC_RATE, AUDIO_SAMPLE_RATE, src_quality_name(audio_src.quality), audio_src.taps,
+			audio_get_src_drift(), src_correction_ppm(&audio_src), audio_get_src_fill(), AUDIO_SRC_FIFO_FRAMES);
+
+	return 0;
+}
+
+int Mixer_set(int argc, char ** argv)
+{
+	mixer_t * mx = &audio_mixer;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "duck") == 0)
+		{
+			// x duck <dB>: gain of the others during a chime
+			mixer_set_ducking(mx, (argc > 2) ? strtof(argv[2], NULL) : -12.0f);
+		}
+		else if (strcmp(argv[1], "chime") == 0 && (argc < 3 || argv[2][0] != 'o'))
+		{
+			// x chime [Hz] [ms]
+			chime_play(&audio_chime, (argc > 2) ? strtof(argv[2], NULL) : 880.0f,
+					(argc > 3) ? (uint32_t)atoi(argv[3]) : 600U);
+		}
+		else
+		{
+			// x <source> on|off|<gain %>
+			int source = mixer_find(mx, argv[1]);
+
+			if (source < 0 || argc < 3)
+			{
+				printf("Usage: x <source> on|off|gain%%, x chime [Hz] [ms], x duck dB\r\n");
+				return -1;
+			}
+
+			if (strcmp(argv[2], "on") == 0 || strcmp(argv[2], "off") == 0)
+			{
+				mixer_enable(mx, source, strcmp(argv[2], "on") == 0);
+			}
+			else
+			{
+				int percent = atoi(argv[2]);
+				if (percent < 0) percent = 0;
+				if (percent > 100) percent = 100;
+				mixer_set_gain(mx, source, (int16_t)(percent * 32767 / 100));
+			}
+		}
+	}
+
+	printf("Mixeur: ducking %d %%, bus a -%d dB, soft clip\r\n", mx->duck_gain * 100 / 32768, MIXER_HEADROOM_DB);
+	for (uint32_t i = 0; i < mx->count; i++)
+	{
+		const mixer_source_t * src = &mx->sources[i];
+
+		printf("  %-8s %-3s %3d %%%s%s\r\n", src->name, src->enabled ? "on" : "off",
+				src->gain * 100 / 32767, src->ducks ? ", ducking" : "", src->active ? ", actif" : "");
+	}
+
+	return 0;
+}
+
+int Graph_set(int argc, char ** argv)
+{
+	graph_t * g = &audio_graph;
+
+	if (argc > 1)
+	{
+		int node = (argc > 2) ? graph_find(g, argv[2]) : -1;
+		int status = 0;
+
+		if (strcmp(argv[1], "reset") == 0)
+		{
+			profiling_zone_reset(&g->zone);
+			for (int i = 0; i < g->count; i++)
+			{
+				profiling_zone_reset(&g->nodes[i].zone);
+			}
+		}
+		else if (node < 0)
+		{
+			printf("Usage: G bypass|on|del <etage>, G add <etage> <apres>, G reset\r\n");
+			return -1;
+		}
+		else if (strcmp(argv[1], "bypass") == 0 || strcmp(argv[1], "on") == 0)
+		{
+			graph_bypass(g, node, argv[1][0] == 'b');
+		}
+		else if (strcmp(argv[1], "del") == 0)
+		{
+			status = audio_graph_commit(graph_remove(g, node));
+		}
+		else if (strcmp(argv[1], "add") == 0)
+		{
+			// G add <stage> <after>: inserted after a linked stage
+			int after = (argc > 3) ? graph_find(g, argv[3]) : -1;
+
+			status = audio_graph_commit(graph_insert(g, node, after));
+		}
+
+		if (status != 0)
+		{
+			printf("Graphe inchange (%d)\r\n", status);
+			return -1;
+		}
+	}
+
+	const graph_schedule_t * sc = &g->schedule[g->active];
+
+	printf("Graphe: %u etages, %u blocs, %lu cycles/bloc (max %lu)\r\n", sc->count, sc->buffers,
+			profiling_zone_avg(&g->zone), g->zone.max);
+	printf("%-10s %-8s %8s %8s\r\n", "Etage", "Blocs", "moy", "max");
+	for (uint32_t s = 0; s < sc->count; s++)
+	{
+		const graph_step_t * step = &sc->steps[s];
+		const graph_node_t * n = &g->nodes[step->node];
+
+		printf("%-10s %u->%u%-4s %8lu %8lu%s\r\n", n->stage->name, step->in, step->out,
+				(step->in == step->out) ? "" : " cp", profiling_zone_avg(&n->zone), n->zone.max,
+				n->bypass ? "  bypass" : "");
+	}
+	for (int i = 0; i < g->count; i++)
+	{
+		if (!g->nodes[i].linked)
+		{
+			printf("%-10s hors graphe\r\n", g->nodes[i].stage->name);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Deadlines of the audio task: u [silence|repeat|reset|stress <us>]
+ */
+int Underrun_set(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "silence") == 0)
+		{
+			audio_set_fill(AUDIO_FILL_SILENCE);
+		}
+		else if (strcmp(argv[1], "repeat") == 0)
+		{
+			audio_set_fill(AUDIO_FILL_REPEAT);
+		}
+		else if (strcmp(argv[1], "reset") == 0)
+		{
+			audio_reset_stats();
+		}
+		else if (strcmp(argv[1], "stress") == 0)
+		{
+			// u stress <us>: busy time added to each block
+			int us = (argc > 2) ? atoi(argv[2]) : 0;
+
+			audio_set_stress((us > 0) ? (uint32_t)us * (SystemCoreClock / 1000000U) : 0);
+		}
+		else
+		{
+			printf("Usage: u [silence|repeat|reset|stress <us>]\r\n");
+			return -1;
+		}
+	}
+
+	const audio_stats_t * st = &audio_stats;
+	const uint32_t deadline = (uint32_t)(((uint64_t)SystemCoreClock * audio_block_frames) / AUDIO_SAMPLE_RATE);
+
+	printf("Blocs: %lu, en retard: %lu, underruns: %lu, overruns: %lu\r\n",
+			st->blocks, st->late, st->underruns, st->overruns);
+	printf("Erreurs SAI: TX %lu, RX %lu, redemarrages: %lu, resync: %lu\r\n",
+			st->sai_errors[0], st->sai_errors[1], st->restarts, st->resyncs);
+	printf("Bloc max: %lu cycles / %lu (%lu %%), remplissage: %s\r\n", st->max_cycles, deadline,
+			100U * st->max_cycles / deadline, (audio_get_fill() == AUDIO_FILL_SILENCE) ? "silence" : "repeat");
+
+	return 0;
+}
+
+/**
+ * @brief Round trip latency: L [impulse|mls] [codec|cable|sim <frames>]
+ * codec: I2S loopback in the SGTL5000 (digital path only), cable: line out
+ * to line in (converters included), sim: loop simulated in the audio task.
+ */
+int Latency_measure(int argc, char ** argv)
+{
+	latency_signal_t signal = LATENCY_MLS;
+	int32_t simulated = LATENCY_NONE;
+	int codec = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "impulse") == 0)
+		{
+			signal = LATENCY_IMPULSE;
+		}
+		else if (strcmp(argv[i], "mls") == 0)
+		{
+			signal = LATENCY_MLS;
+		}
+		else if (strcmp(argv[i], "codec") == 0)
+		{
+			codec = 1;
+		}
+		else if (strcmp(argv[i], "cable") == 0)
+		{
+			codec = 0;
+		}
+		else if (strcmp(argv[i], "sim") == 0 && i + 1 < argc)
+		{
+			simulated = atoi(argv[++i]);
+			codec = 0;
+			if (simulated < 0)
+			{
+				simulated = 0;
+			}
+		}
+		else
+		{
+			printf("Usage: L [impulse|mls] [codec|cable|sim <trames>]\r\n");
+			return -1;
+		}
+	}
+
+	if (codec)
+	{
+		SGTL5000_Set_Loopback(1);
+	}
+
+	int32_t frames = audio_measure_latency(signal, simulated);
+
+	if (codec)
+	{
+		SGTL5000_Set_Loopback(0);
+	}
+
+	const uint32_t buffering = 2 * audio_block_frames;	// Written one half, played two halves later
+
+	printf("Mesure %s, boucle %s, pic %ld / fond %ld\r\n", (signal == LATENCY_MLS) ? "MLS" : "impulsion",
+			(simulated != LATENCY_NONE) ? "simulee" : codec ? "codec (I2S)" : "cable", audio_latency.peak, audio_latency.floor);
+	if (frames == LATENCY_NONE)
+	{
+		printf("Marqueur non trouve (boucle absente, bruit, ou plus de %lu trames)\r\n",
+				LATENCY_CAPTURE_FRAMES - ((signal == LATENCY_MLS) ? LATENCY_MLS_LENGTH : 0));
+		return -1;
+	}
+
+	printf("Aller-retour: %ld trames (%lu us)\r\n", frames, (uint32_t)frames * 1000000U / AUDIO_SAMPLE_RATE);
+	printf("  tampons DMA: %lu trames (SAI_BUFFER_LENGTH %lu)\r\n", buffering, SAI_BUFFER_LENGTH);
+	printf("  boucle/convertisseurs: %ld trames\r\n", frames - (int32_t)buffering);
+
+	// The buffering part scales with the block size (see k), the rest does not
+	printf("%-8s %-18s %8s %8s\r\n", "Bloc", "SAI_BUFFER_LENGTH", "trames", "us");
+	for (uint32_t block = AUDIO_MIN_BLOCK_FRAMES; block <= AUDIO_MAX_BLOCK_FRAMES; block *= 2)
+	{
+		int32_t total = frames - (int32_t)buffering + (int32_t)(2 * block);
+
+		printf("%-8lu %-18lu %8ld %8lu%s\r\n", block, 2 * AUDIO_CHANNELS * block, total,
+				(uint32_t)total * 1000000U / AUDIO_SAMPLE_RATE, (block == audio_block_frames) ? "  <-" : "");
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Block size: k [<frames>|sweep]
+ * sweep: every supported size for half a second, CPU load and latency of
+ * each, then back to the current one.
+ */
+int Block_set(int argc, char ** argv)
+{
+	const uint32_t current = audio_block_frames;
+
+	if (argc > 1 && strcmp(argv[1], "sweep") == 0)
+	{
+		printf("%-8s %10s %8s %8s %10s\r\n", "Bloc", "Latence us", "CPU moy", "CPU max", "Underruns");
+		for (uint32_t block = AUDIO_MIN_BLOCK_FRAMES; block <= AUDIO_MAX_BLOCK_FRAMES; block *= 2)
+		{
+			if (audio_set_block_frames(block) != 0)
+			{
+				printf("%-8lu echec\r\n", block);
+				continue;
+			}
+			osDelay(500);
+
+			const uint32_t deadline = (uint32_t)(((uint64_t)SystemCoreClock * block) / AUDIO_SAMPLE_RATE);
+
+			printf("%-8lu %10lu %7lu%% %7lu%% %10lu\r\n", block, 2 * block * 1000000U / AUDIO_SAMPLE_RATE,
+					100U * profiling_zone_avg(&audio_graph.zone) / deadline, 100U * audio_stats.max_cycles / deadline,
+					audio_stats.underruns);
+		}
+		audio_set_block_frames(current);
+		return 0;
+	}
+
+	if (argc > 1)
+	{
+		int status = audio_set_block_frames((uint32_t)atoi(argv[1]));
+
+		if (status == -1)
+		{
+			printf("Puissance de 2 entre %u et %u trames\r\n", AUDIO_MIN_BLOCK_FRAMES, AUDIO_MAX_BLOCK_FRAMES);
+			return -1;
+		}
+		if (status != 0)
+		{
+			printf("Redemarrage SAI en echec\r\n");
+			return -1;
+		}
+	}
+
+	printf("Bloc: %lu trames (SAI_BUFFER_LENGTH %lu), latence tampons %lu us\r\n", audio_block_frames,
+			SAI_BUFFER_LENGTH, 2 * audio_block_frames * 1000000U / AUDIO_SAMPLE_RATE);
+
+	return 0;
+}
+
+/**
+ * @brief Codec routing: o [i2s-dac|i2s-dap-dac|adc-dap-dac|adc-dac|auto]
+ * The ADC profiles bypass the MCU, its audio task then sleeps.
+ * auto: adc-dac if the MCU has nothing to do, i2s-dac otherwise.
+ */
+int Routing_set(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		int route;
+
+		if (strcmp(argv[1], "auto") == 0)
+		{
+			route = audio_mcu_idle() ? SGTL5000_ROUTE_ADC_DAC : SGTL5000_ROUTE_I2S_DAC;
+		}
+		else if ((route = SGTL5000_Route_From_Name(argv[1])) < 0)
+		{
+			printf("Profil '%s' inconnu (i2s-dac, i2s-dap-dac, adc-dap-dac, adc-dac, auto)\r\n", argv[1]);
+			return -1;
+		}
+
+		// The MCU output is running before the DAC takes it, and after it has left it
+		drv_status_t status;
+
+		if (SGTL5000_Route_Uses_I2S(route))
+		{
+			audio_set_bypass(0);
+			status = SGTL5000_Set_Route(route);
+		}
+		else if ((status = SGTL5000_Set_Route(route)) == DRV_OK)
+		{
+			audio_set_bypass(1);
+		}
+
+		if (status != DRV_OK)
+		{
+			printf("Routage non applique: %s (voir E)\r\n", drv_status_name(status));
+		}
+	}
+
+	printf("Routage: %s, MCU %s, traitement MCU %s\r\n", SGTL5000_Route_Name(SGTL5000_Get_Route()),
+			audio_get_bypass() ? "contourne" : "actif", audio_mcu_idle() ? "inutile" : "en cours");
+
+	return 0;
+}
+
+/**
+ * @brief Power manager: W mute, W on, W auto on|off, W silence <s>, W reset.
+ * Prints the time spent in each state, the wake up latency and the idle sleeps.
+ * Any key wakes the unit up from mute.
+ */
+int Power_set(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "mute") == 0)
+		{
+			power_request(POWER_MUTED);
+			printf("Veille: une touche pour reveiller\r\n");
+			return 0;
+		}
+		else if (strcmp(argv[1], "on") == 0)
+		{
+			power_request(POWER_ACTIVE);
+		}
+		else if (strcmp(argv[1], "auto") == 0 && argc > 2)
+		{
+			power_set_auto(strcmp(argv[2], "on") == 0, 0);
+		}
+		else if (strcmp(argv[1], "silence") == 0 && argc > 2 && atoi(argv[2]) > 0)
+		{
+			power_set_auto(1, (uint32_t)atoi(argv[2]) * 1000U);
+		}
+		else if (strcmp(argv[1], "reset") == 0)
+		{
+			power_reset_stats();
+		}
+		else
+		{
+			printf("Usage: W [mute|on|auto on|off|silence <s>|reset]\r\n");
+			return -1;
+		}
+	}
+
+	power_stats_t stats;
+	uint32_t silence_ms;
+	const int automatic = power_get_auto(&silence_ms);
+	uint64_t total = 0;
+
+	power_get_stats(&stats);
+	for (int i = 0; i < POWER_STATE_COUNT; i++)
+	{
+		total += stats.ticks[i];
+	}
+
+	printf("Etat: %s, silence auto %s (%lu s sous %d dBFS)\r\n", power_state_name(power_get_state()),
+			automatic ? "on" : "off", silence_ms / 1000U, POWER_SILENCE_DB);
+	for (int i = 0; i < POWER_STATE_COUNT; i++)
+	{
+		printf("  %-8s %8lu s %3lu %%\r\n", power_state_name((power_state_t)i),
+				(uint32_t)(stats.ticks[i] * portTICK_PERIOD_MS / 1000U),
+				total ? (uint32_t)(stats.ticks[i] * 100U / total) : 0);
+	}
+	printf("Transitions: %lu, reveil: %lu us (max %lu us, budget %d us)\r\n",
+			stats.transitions, stats.wake_last_us, stats.wake_max_us, POWER_WAKE_BUDGET_US);
+	printf("Sommeils idle: %lu, %lu ticks en moyenne\r\n", stats.sleeps,
+			stats.sleeps ? (uint32_t)(stats.sleep_ticks / stats.sleeps) : 0);
+
+	return 0;
+}
+
+/**
+ * @brief Scheduling statistics: T prints the context switches and the CPU
+ * share of each task since the last T reset.
+ */
+int Task_stats(int argc, char ** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "reset") == 0)
+	{
+		sched_reset_stats();
+		printf("Statistiques remises a zero\r\n");
+		return 0;
+	}
+
+	sched_report();
+
+	return 0;
+}
+
+/**
+ * @brief Driver health: E prints the counters of each peripheral, E inject
+ * makes its next bus attempts fail to exercise the retries and the
+ * degraded mode.
+ */
+int Errors(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "reset") == 0)
+		{
+			for (int i = 0; i < DRV_PERIPH_COUNT; i++)
+			{
+				drv_reset_health((drv_periph_t)i);
+			}
+		}
+		else if (strcmp(argv[1], "inject") == 0 && argc > 3)
+		{
+			const int periph = drv_periph_from_name(argv[2]);
+
+			if (periph < 0)
+			{
+				printf("Peripherique '%s' inconnu (mcp23s17, sgtl5000)\r\n", argv[2]);
+				return -1;
+			}
+			drv_inject((drv_periph_t)periph, (uint32_t)atoi(argv[3]));
+		}
+		else
+		{
+			printf("Usage: E [reset|inject <peripherique> <essais>]\r\n");
+			return -1;
+		}
+	}
+
+	printf("Peripherique  appels  echecs  reprises  reinit  ignores  degrade  dernier\r\n");
+	for (int i = 0; i < DRV_PERIPH_COUNT; i++)
+	{
+		drv_health_t h;
+
+		drv_get_health((drv_periph_t)i, &h);
+		printf("%-12s %7lu %7lu %9lu %7lu %8lu %4s (%lu) %s\r\n", drv_periph_name((drv_periph_t)i),
+				h.transfers, h.failures, h.retries, h.recoveries, h.skipped,
+				h.degraded ? "oui" : "non", h.degradations, drv_status_name((drv_status_t)h.last));
+		printf("  essais rates: erreur %lu, occupe %lu, timeout %lu, a injecter %lu\r\n",
+				h.errors[DRV_ERROR], h.errors[DRV_BUSY], h.errors[DRV_TIMEOUT], h.inject);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Watchdog: d prints the cause of the last reset, the late task if
+ * it was the watchdog, and the state of each supervised task. d hang stops
+ * the shell task for good, to check the reset and its report.
+ */
+int Watchdog_report(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "hang") == 0)
+		{
+			watchdog_client_info_t shell;
+
+			watchdog_get_client(WATCHDOG_SHELL, &shell);
+			printf("Shell bloque, reset attendu sous %lu ms\r\n", shell.deadline_ms + WATCHDOG_PERIOD_MS + WATCHDOG_TIMEOUT_MS);
+			vTaskSuspend(NULL);
+			return 0;
+		}
+		printf("Usage: d [hang]\r\n");
+		return -1;
+	}
+
+	watchdog_report_t report;
+
+	watchdog_get_report(&report);
+	printf("Dernier reset: %s (RCC_CSR 0x%08lX), demarrages: %lu, resets watchdog: %lu\r\n",
+			watchdog_reset_name((watchdog_reset_t)report.cause), report.csr, report.boots, report.watchdog_resets);
+	if (report.cause == WATCHDOG_RESET_IWDG)
+	{
+		if (report.client < WATCHDOG_COUNT)
+		{
+			printf("Tache en cause: %s, %lu ms sans nouvelles, a %lu s de fonctionnement\r\n",
+					watchdog_client_name((watchdog_client_t)report.client), report.late_ms, report.uptime_ms / 1000U);
+		}
+		else
+		{
+			printf("Aucune tache en retard: interruptions masquees ou faute\r\n");
+		}
+	}
+
+	printf("IWDG %d ms, verification toutes les %d ms\r\n", WATCHDOG_TIMEOUT_MS, WATCHDOG_PERIOD_MS);
+	for (int i = 0; i < WATCHDOG_COUNT; i++)
+	{
+		watchdog_client_info_t info;
+
+		watchdog_get_client((watchdog_client_t)i, &info);
+		if (info.armed)
+		{
+			printf("  %-6s delai %5lu ms, vue il y a %5lu ms, pire %5lu ms\r\n", watchdog_client_name((watchdog_client_t)i),
+					info.deadline_ms, info.age_ms, info.worst_ms);
+		}
+		else
+		{
+			printf("  %-6s delai %5lu ms, en pause, pire %5lu ms\r\n", watchdog_client_name((watchdog_client_t)i),
+					info.deadline_ms, info.worst_ms);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief GPIO expanders on SPI3: M lists the declared ones and their
+ * latches, M scan reads IOCON at each hardware address.
+ */
+int Expanders(int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "scan") != 0)
+		{
+			printf("Usage: M [scan]\r\n");
+			return -1;
+		}
+
+		for (uint8_t address = 0; address < MCP23S17_MAX_DEVICES; address++)
+		{
+			uint8_t iocon = 0;
+			drv_status_t status = MCP23S17_ReadRegister(address, MCP23S17_IOCON, &iocon);
+
+			if (status != DRV_OK)
+			{
+				printf("  %d: %s\r\n", address, drv_status_name(status));
+				return -1;
+			}
+			printf("  %d: IOCON 0x%02X%s\r\n", address, iocon,
+					(iocon == MCP23S17_IOCON_HAEN) ? " (expandeur)" : "");
+		}
+		return 0;
+	}
+
+	for (int i = 0; i < MCP23S17_DEV_COUNT; i++)
+	{
+		const h_MCP23S17_t * dev = &hMCP23S17[i];
+
+		printf("%-6s adresse %d, %s, GPA 0x%02X GPB 0x%02X%s\r\n", dev->name, dev->address,
+				dev->present ? "present" : "absent", dev->GPA, dev->GPB, dev->dirty ? " (a ecrire)" : "");
 	}
 
 	return 0;
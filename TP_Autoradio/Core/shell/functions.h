@@ -13,5 +13,28 @@ int calcul(int argc, char ** argv);
 int addition(int argc, char ** argv);
 int GPIOExpander_toggle_LED(int argc, char ** argv);
 int GPIOExpander_set_LED(int argc, char ** argv);
+int Logger_set_level(int argc, char ** argv);
+int RTOS_memory_report(int argc, char ** argv);
+int Bench_placement(int argc, char ** argv);
+int Generator_set(int argc, char ** argv);
+int Equalizer_set(int argc, char ** argv);
+int RC_filter_set(int argc, char ** argv);
+int Echo_set(int argc, char ** argv);
+int Reverb_set(int argc, char ** argv);
+int Compressor_set(int argc, char ** argv);
+int Loudness_set(int argc, char ** argv);
+int Display_set(int argc, char ** argv);
+int Resampler_set(int argc, char ** argv);
+int Mixer_set(int argc, char ** argv);
+int Graph_set(int argc, char ** argv);
+int Underrun_set(int argc, char ** argv);
+int Latency_measure(int argc, char ** argv);
+int Block_set(int argc, char ** argv);
+int Routing_set(int argc, char ** argv);
+int Power_set(int argc, char ** argv);
+int Task_stats(int argc, char ** argv);
+int Errors(int argc, char ** argv);
+int Watchdog_report(int argc, char ** argv);
+int Expanders(int argc, char ** argv);
 
 #endif /* SHELL_FUNCTIONS_H_ */
@@ -10,6 +10,8 @@
 #include "gpio.h"
 
 #include "shell.h"
+#include "../utils/sections.h"
+#include "../utils/watchdog.h"
 
 
 typedef struct{
@@ -19,16 +21,19 @@ typedef struct{
 } shell_func_t;
 
 static int shell_func_list_size = 0;
-static shell_func_t shell_func_list[SHELL_FUNC_LIST_MAX_SIZE];
-static char print_buffer[BUFFER_SIZE];
-static SemaphoreHandle_t sem_uart_read = NULL;
+static shell_func_t shell_func_list[SHELL_FUNC_LIST_MAX_SIZE] RAM2_BSS;
+static char print_buffer[BUFFER_SIZE] RAM2_BSS;
+static TaskHandle_t shell_task = NULL;	// Woken by a direct notification on each character
 
 
 void shell_uart_receive_irq_cb(void)
 {
 	BaseType_t pxHigherPriorityTaskWoken = pdFALSE;
 
-	xSemaphoreGiveFromISR(sem_uart_read, &pxHigherPriorityTaskWoken);
+	if (shell_task != NULL)
+	{
+		vTaskNotifyGiveFromISR(shell_task, &pxHigherPriorityTaskWoken);
+	}
 
 	portYIELD_FROM_ISR(pxHigherPriorityTaskWoken);
 }
@@ -38,8 +43,13 @@ static char uart_read() {
 
 	HAL_UART_Receive_IT(&UART_DEVICE, (uint8_t*)(&c), 1);
 	// il faut mettre la tâche shell dans l'état bloqué, jusqu'à l'interruption de réception de caractère
-	// prendre un sémaphore vide par exemple
-	xSemaphoreTake(sem_uart_read, portMAX_DELAY);
+	// notification directe, plus légère qu'un sémaphore
+	// attente bornée : la tâche reste surveillée par le watchdog tant que personne ne tape
+	while (ulTaskNotifyTake(pdTRUE, WATCHDOG_IDLE_MS / portTICK_PERIOD_MS) == 0)
+	{
+		watchdog_checkin(WATCHDOG_SHELL);
+	}
+	watchdog_checkin(WATCHDOG_SHELL);
 
 	return c;
 }
@@ -66,12 +76,7 @@ void shell_init() {
 	size = snprintf (print_buffer, BUFFER_SIZE, "\r\n\r\n===== Monsieur Shell v0.2 =====\r\n");
 	uart_write(print_buffer, size);
 
-	sem_uart_read = xSemaphoreCreateBinary();
-	if (sem_uart_read == NULL)
-	{
-		printf("Error semaphore shell\r\n");
-		while(1);
-	}
+	shell_task = xTaskGetCurrentTaskHandle();
 
 	shell_add('h', sh_help, "Help");
 }
@@ -126,7 +131,7 @@ int shell_run() {
 	int reading = 0;
 	int pos = 0;
 
-	static char cmd_buffer[BUFFER_SIZE];
+	static char cmd_buffer[BUFFER_SIZE] RAM2_BSS;
 
 	while (1) {
 		uart_write(prompt, 2);
@@ -0,0 +1,546 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiling.h"
+#include "scratch.h"
+#include "sections.h"
+#include "watchdog.h"
+
+#include "../audio/biquad.h"
+#include "../audio/delay.h"
+#include "../audio/fft.h"
+#include "../audio/rc_filter.h"
+#include "../audio/reverb.h"
+#include "../audio/siggen.h"
+#include "../audio/src.h"
+
+#define BENCH_FRAMES 256	// Stereo frames per block
+#define BENCH_TAPS 16
+
+/**
+ * Same block processing (16 taps FIR, stereo, Q15) instantiated twice:
+ *  - _ram2  : code in .fast_code, state and coefficients in SRAM2
+ *  - _flash : code in flash, state in SRAM1, coefficients in flash
+ * The input/output block is in SRAM1 like the SAI DMA buffers.
+ */
+#define BENCH_FIR_DEFINE(suffix, code_attr)											\
+	static code_attr void bench_fir_##suffix(int16_t * block, int frames)			\
+	{																				\
+		for (int n = 0; n < frames; n++)											\
+		{																			\
+			for (int ch = 0; ch < 2; ch++)											\
+			{																		\
+				int16_t * hist = bench_state_##suffix[ch];							\
+				int32_t acc = 0;													\
+																					\
+				for (int k = BENCH_TAPS - 1; k > 0; k--)							\
+				{																	\
+					hist[k] = hist[k - 1];											\
+					acc += (int32_t)bench_coefs_##suffix[k] * hist[k];				\
+				}																	\
+				hist[0] = block[2*n + ch];											\
+				acc += (int32_t)bench_coefs_##suffix[0] * hist[0];					\
+				block[2*n + ch] = (int16_t)(acc >> 15);								\
+			}																		\
+		}																			\
+	}
+
+#define BENCH_COEFS_INIT { \
+		1024, 1536, 2048, 2560, 3072, 3584, 4096, 4608, \
+		4608, 4096, 3584, 3072, 2560, 2048, 1536, 1024 }
+
+static int16_t bench_state_ram2[2][BENCH_TAPS] RAM2_BSS;
+static int16_t bench_coefs_ram2[BENCH_TAPS] RAM2_DATA = BENCH_COEFS_INIT;
+BENCH_FIR_DEFINE(ram2, FAST_CODE)
+
+static int16_t bench_state_flash[2][BENCH_TAPS];
+static const int16_t bench_coefs_flash[BENCH_TAPS] = BENCH_COEFS_INIT;
+BENCH_FIR_DEFINE(flash, __attribute__((noinline)))
+
+static biquad_t bench_bq RAM2_BSS;
+static rc_filter_t bench_rc RAM2_BSS;
+
+#define BENCH_DELAY_LENGTH 512	// Frames
+static delay_t bench_delay_ram, bench_delay_ram2;
+static int16_t bench_line_ram2[DELAY_CHANNELS * BENCH_DELAY_LENGTH] RAM2_BSS;
+static siggen_t bench_gen;
+static reverb_t bench_rv RAM2_BSS;
+
+#define BENCH_SRC_IN 1024		// Frames at 44.1 kHz
+#define BENCH_SRC_OUT 1024		// Frames at 48 kHz, warm-up then 20 periods of 1 kHz
+#define BENCH_SRC_SKIP 64
+#define BENCH_SRC_FIT 960
+static src_t bench_conv RAM2_BSS;
+
+/**
+ * SRAM1 buffers, overlaid in the shell scratch: each bench only uses one
+ * member of the union, and the shell runs one bench at a time.
+ */
+typedef union {
+	struct {
+		int16_t block[2*BENCH_FRAMES];
+		float expected[BENCH_FRAMES];					// Reference of the biquad accuracy
+		int16_t line_ram[DELAY_CHANNELS * BENCH_DELAY_LENGTH];
+	} blocks;
+	int32_t fft[FFT_MAX_SIZE];
+	struct {
+		int16_t in[2*BENCH_SRC_IN];
+		int16_t out[2*BENCH_SRC_OUT];
+	} src;
+} bench_scratch_t;
+
+_Static_assert(sizeof(bench_scratch_t) <= SCRATCH_SIZE, "bench buffers larger than the scratch");
+
+#define BENCH_SCRATCH ((bench_scratch_t *)scratch_get())
+#define bench_block (BENCH_SCRATCH->blocks.block)
+#define bench_line_ram (BENCH_SCRATCH->blocks.line_ram)
+#define bench_fft_buffer (BENCH_SCRATCH->fft)
+#define bench_src_in (BENCH_SCRATCH->src.in)
+#define bench_src_out (BENCH_SCRATCH->src.out)
+
+
+/**
+ * @brief Prints tenths as [-]u.t right aligned in width characters (no float printf).
+ */
+static void bench_print_tenths(int width, int32_t tenths)
+{
+	char text[16];
+
+	snprintf(text, sizeof(text), "%s%ld.%ld", (tenths < 0) ? "-" : "", labs(tenths) / 10, labs(tenths) % 10);
+	printf("%*s", width, text);
+}
+
+static void bench_run(void (* process)(int16_t *, int), int iterations, bench_result_t * r)
+{
+	uint64_t total = 0;
+
+	r->min = UINT32_MAX;
+	r->max = 0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		// Run by the shell task: a long bench is not a hung shell
+		watchdog_checkin(WATCHDOG_SHELL);
+		for (int n = 0; n < 2*BENCH_FRAMES; n++)
+		{
+			bench_block[n] = (int16_t)(n * 97);
+		}
+
+		uint32_t start = profiling_now();
+		process(bench_block, BENCH_FRAMES);
+		uint32_t cycles = profiling_now() - start;
+
+		total += cycles;
+		if (cycles < r->min) r->min = cycles;
+		if (cycles > r->max) r->max = cycles;
+	}
+
+	r->avg = (uint32_t)(total / iterations);
+}
+
+/**
+ * @brief Compares the block processing time with and without the RAM2 placement.
+ * To be run while the SAI DMA is active to see the bus contention.
+ * @param iterations: Number of blocks processed by each variant.
+ */
+void bench_placement(int iterations)
+{
+	bench_result_t flash, ram2;
+
+	if (iterations <= 0) iterations = 100;
+
+	bench_run(bench_fir_flash, iterations, &flash);
+	bench_run(bench_fir_ram2, iterations, &ram2);
+
+	printf("Bloc de %d trames stereo, FIR %d coefs, %d iterations\r\n", BENCH_FRAMES, BENCH_TAPS, iterations);
+	printf("%-12s %8s %8s %8s %10s\r\n", "Placement", "min", "moy", "max", "cyc/ech");
+	printf("%-12s %8lu %8lu %8lu %10lu\r\n", "FLASH/RAM", flash.min, flash.avg, flash.max, flash.avg / (2*BENCH_FRAMES));
+	printf("%-12s %8lu %8lu %8lu %10lu\r\n", "RAM2", ram2.min, ram2.avg, ram2.max, ram2.avg / (2*BENCH_FRAMES));
+}
+
+static void bench_biquad_block(int16_t * block, int frames)
+{
+	biquad_process(&bench_bq, block, frames);
+}
+
+/**
+ * @brief Compares the left channel of the cascade with a double precision
+ * reference using the same (quantized) coefficients, on white noise at -12 dBFS.
+ * @retval int32_t: Signal to error ratio in tenths of dB.
+ */
+static int32_t bench_biquad_accuracy(void)
+{
+	static double ref[BIQUAD_MAX_STAGES][4];	// x1, x2, y1, y2
+	float * expected = BENCH_SCRATCH->blocks.expected;
+	double signal = 0.0, error = 0.0;
+
+	memset(ref, 0, sizeof(ref));
+	siggen_init(&bench_gen, 48000);
+	siggen_set_wave(&bench_gen, SIGGEN_WHITE);
+	siggen_set_amplitude(&bench_gen, 8192);
+	biquad_reset(&bench_bq);
+
+	for (int block = 0; block < 8; block++)
+	{
+		siggen_fill(&bench_gen, bench_block, BENCH_FRAMES);
+
+		for (int n = 0; n < BENCH_FRAMES; n++)
+		{
+			double x = bench_block[2*n] / 32768.0;
+
+			for (uint32_t s = 0; s < bench_bq.stages; s++)
+			{
+				const biquad_coefs_t * c = &bench_bq.coefs[s];
+				double y = (c->b0 * x + c->b1 * ref[s][0] + c->b2 * ref[s][1]
+						+ c->a1 * ref[s][2] + c->a2 * ref[s][3]) / (double)(1 << BIQUAD_COEF_SHIFT);
+
+				ref[s][1] = ref[s][0];
+				ref[s][0] = x;
+				ref[s][3] = ref[s][2];
+				ref[s][2] = y;
+				x = y;
+			}
+			expected[n] = (float)x;
+		}
+
+		biquad_process(&bench_bq, bench_block, BENCH_FRAMES);
+
+		for (int n = 0; n < BENCH_FRAMES; n++)
+		{
+			double e = bench_block[2*n] / 32768.0 - expected[n];
+
+			signal += (double)expected[n] * expected[n];
+			error += e * e;
+		}
+	}
+
+	return (error > 0.0) ? (int32_t)(100.0 * log10(signal / error)) : 9999;
+}
+
+/**
+ * @brief Cost and accuracy of each biquad type, 4 stages (HP 40 Hz, peak
+ * 1 kHz +6 dB, high shelf 6 kHz -6 dB, LP 12 kHz) on a stereo block.
+ * @param iterations: Number of blocks processed by each type.
+ */
+void bench_biquad(int iterations)
+{
+	biquad_coefs_t c;
+	bench_result_t r;
+
+	if (iterations <= 0) iterations = 100;
+
+	biquad_init(&bench_bq, BIQUAD_DF1_Q31);
+	biquad_design(&c, BIQUAD_HIGHPASS, 48000.0f, 40.0f, 0.707f, 0.0f);
+	biquad_set_stage(&bench_bq, 0, &c);
+	biquad_design(&c, BIQUAD_PEAK, 48000.0f, 1000.0f, 1.0f, 6.0f);
+	biquad_set_stage(&bench_bq, 1, &c);
+	biquad_design(&c, BIQUAD_HIGHSHELF, 48000.0f, 6000.0f, 0.707f, -6.0f);
+	biquad_set_stage(&bench_bq, 2, &c);
+	biquad_design(&c, BIQUAD_LOWPASS, 48000.0f, 12000.0f, 0.707f, 0.0f);
+	biquad_set_stage(&bench_bq, 3, &c);
+
+	printf("Bloc de %d trames stereo, %lu biquads, %d iterations\r\n", BENCH_FRAMES, bench_bq.stages, iterations);
+	printf("%-12s %8s %8s %8s %10s %10s\r\n", "Type", "min", "moy", "max", "cyc/ech", "SNR (dB)");
+
+	for (int type = 0; type < BIQUAD_TYPE_COUNT; type++)
+	{
+		biquad_set_type(&bench_bq, type);
+		bench_run(bench_biquad_block, iterations, &r);
+
+		int32_t snr = bench_biquad_accuracy();
+
+		printf("%-12s %8lu %8lu %8lu %10lu ", biquad_type_name(type),
+				r.min, r.avg, r.max, r.avg / (2*BENCH_FRAMES));
+		bench_print_tenths(9, snr);
+		printf("\r\n");
+	}
+}
+
+static void bench_rc_block(int16_t * block, int frames)
+{
+	rc_filter_process(&bench_rc, block, frames);
+}
+
+/**
+ * @brief Gain of the RC filter on a -6 dBFS sine, after the transient.
+ * @retval int32_t: Gain in tenths of dB.
+ */
+static int32_t bench_rc_gain(rc_mode_t mode, uint32_t cutoff, float frequency)
+{
+	double in = 0.0, out = 0.0;
+
+	rc_filter_init(&bench_rc, 48000);
+	rc_filter_set_mode(&bench_rc, mode);
+	rc_filter_set_cutoff(&bench_rc, cutoff);
+	siggen_init(&bench_gen, 48000);
+	siggen_set_frequency(&bench_gen, frequency);
+
+	for (int block = 0; block < 32; block++)
+	{
+		siggen_fill(&bench_gen, bench_block, BENCH_FRAMES);
+		for (int n = 0; n < BENCH_FRAMES && block >= 16; n++) in += (double)bench_block[2*n] * bench_block[2*n];
+
+		rc_filter_process(&bench_rc, bench_block, BENCH_FRAMES);
+		for (int n = 0; n < BENCH_FRAMES && block >= 16; n++) out += (double)bench_block[2*n] * bench_block[2*n];
+	}
+
+	return (int32_t)lrint(100.0 * log10(out / in));
+}
+
+/**
+ * @brief Cost per sample of the RC filter and magnitude response against the
+ * analog RC (1 kHz cutoff, measured at fc/4, fc and 4 fc).
+ * @param iterations: Number of blocks processed.
+ */
+void bench_rc_filter(int iterations)
+{
+	static const float ratios[] = { 0.25f, 1.0f, 4.0f };
+	bench_result_t r;
+
+	if (iterations <= 0) iterations = 100;
+
+	rc_filter_init(&bench_rc, 48000);
+	rc_filter_set_mode(&bench_rc, RC_LOWPASS);
+	bench_run(bench_rc_block, iterations, &r);
+
+	printf("Filtre RC, bloc de %d trames stereo, %d iterations\r\n", BENCH_FRAMES, iterations);
+	printf("%8s %8s %8s %10s\r\n", "min", "moy", "max", "cyc/ech");
+	printf("%8lu %8lu %8lu %10lu\r\n", r.min, r.avg, r.max, r.avg / (2*BENCH_FRAMES));
+
+	printf("fc = 1000 Hz %10s %10s\r\n", "mesure", "RC analog.");
+	for (rc_mode_t mode = RC_LOWPASS; mode <= RC_HIGHPASS; mode++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			double w = (mode == RC_LOWPASS) ? ratios[i] : 1.0 / ratios[i];
+			int32_t analog = (int32_t)lrint(-100.0 * log10(1.0 + w * w));
+			int32_t measured = bench_rc_gain(mode, 1000, 1000.0f * ratios[i]);
+
+			printf("%s %5lu Hz ", rc_filter_mode_name(mode), (uint32_t)(1000.0f * ratios[i]));
+			bench_print_tenths(9, measured);
+			printf(" ");
+			bench_print_tenths(9, analog);
+			printf(" dB\r\n");
+		}
+	}
+}
+
+static void bench_delay_ram_block(int16_t * block, int frames)
+{
+	delay_process(&bench_delay_ram, block, frames);
+}
+
+static void bench_delay_ram2_block(int16_t * block, int frames)
+{
+	delay_process(&bench_delay_ram2, block, frames);
+}
+
+/**
+ * @brief Cost of the echo per block, line in SRAM1 (shared with the DMA) or in SRAM2,
+ * with a delay gliding on every block (worst case: fractional read).
+ * @param iterations: Number of blocks processed.
+ */
+void bench_delay(int iterations)
+{
+	struct {
+		const char * name;
+		delay_t * dl;
+		int16_t * line;
+		void (* process)(int16_t *, int);
+	} variants[] = {
+			{ "RAM", &bench_delay_ram, bench_line_ram, bench_delay_ram_block },
+			{ "RAM2", &bench_delay_ram2, bench_line_ram2, bench_delay_ram2_block },
+	};
+	bench_result_t r;
+
+	if (iterations <= 0) iterations = 100;
+
+	printf("Echo, bloc de %d trames stereo a 48 kHz, %d iterations\r\n", BENCH_FRAMES, iterations);
+	printf("%-12s %8s %8s %8s %10s %8s\r\n", "Ligne", "min", "moy", "max", "cyc/ech", "CPU %");
+
+	for (int i = 0; i < 2; i++)
+	{
+		delay_init(variants[i].dl, variants[i].line, BENCH_DELAY_LENGTH, 48000);
+		delay_set_time(variants[i].dl, 5.3f);
+		delay_enable(variants[i].dl, 1);
+		delay_set_time(variants[i].dl, 7.7f);
+		bench_run(variants[i].process, iterations, &r);
+
+		// Share of the block period (BENCH_FRAMES / 48 kHz) spent in the effect, in tenths of %
+		uint32_t load = (uint32_t)((uint64_t)r.avg * 48000U * 1000U / ((uint64_t)SystemCoreClock * BENCH_FRAMES));
+
+		printf("%-12s %8lu %8lu %8lu %10lu %6lu.%lu\r\n", variants[i].name, r.min, r.avg, r.max,
+				r.avg / (2*BENCH_FRAMES), load / 10, load % 10);
+	}
+}
+
+static void bench_reverb_block(int16_t * block, int frames)
+{
+	reverb_process(&bench_rv, block, frames);
+}
+
+/**
+ * @brief Cost and memory of the reverb for each number of active combs.
+ * The bench has no room for its own lines: it borrows the ones of an effect
+ * which must stay disabled meanwhile (the audio task does not touch them then).
+ * @param shared: Disabled effect lending its pool.
+ * @param iterations: Number of blocks processed per row.
+ */
+void bench_reverb(reverb_t * shared, int iterations)
+{
+	bench_result_t r;
+
+	if (iterations <= 0) iterations = 100;
+
+	reverb_init(&bench_rv, shared->combs[0].line);
+	reverb_set_params(&bench_rv, 80, 50, 30);
+	reverb_enable(&bench_rv, 1);
+
+	printf("Reverb, bloc de %d trames stereo a 48 kHz, %d iterations\r\n", BENCH_FRAMES, iterations);
+	printf("%-12s %8s %8s %8s %10s %8s %8s\r\n", "Combs", "min", "moy", "max", "cyc/ech", "CPU %", "octets");
+
+	for (uint32_t combs = 1; combs <= REVERB_MAX_COMBS; combs++)
+	{
+		reverb_set_active_combs(&bench_rv, combs);
+		bench_run(bench_reverb_block, iterations, &r);
+
+		uint32_t load = (uint32_t)((uint64_t)r.avg * 48000U * 1000U / ((uint64_t)SystemCoreClock * BENCH_FRAMES));
+
+		printf("%-12lu %8lu %8lu %8lu %10lu %6lu.%lu %8lu\r\n", combs, r.min, r.avg, r.max,
+				r.avg / (2*BENCH_FRAMES), load / 10, load % 10, reverb_memory(combs));
+	}
+
+	// The borrowed lines are left dirty, the owner clears them when enabled again
+	reverb_enable(&bench_rv, 0);
+}
+
+/**
+ * @brief Cycles of the real FFT for every supported size, on a sine.
+ * @param iterations: Number of transforms per size.
+ */
+void bench_fft(int iterations)
+{
+	if (iterations <= 0) iterations = 100;
+
+	printf("FFT reelle radix-4, Q15, %d iterations\r\n", iterations);
+	printf("%-12s %8s %8s %8s %10s %8s\r\n", "Taille", "min", "moy", "max", "cyc/point", "us");
+
+	for (uint32_t n = 8; n <= FFT_MAX_SIZE; n *= 2)
+	{
+		bench_result_t r = { UINT32_MAX, 0, 0 };
+		uint64_t total = 0;
+
+		if (!fft_valid_size(n))
+		{
+			continue;
+		}
+
+		for (int i = 0; i < iterations; i++)
+		{
+			watchdog_checkin(WATCHDOG_SHELL);
+			for (uint32_t k = 0; k < n; k++)
+			{
+				bench_fft_buffer[k] = (int32_t)(16384.0f * sinf(6.2831853f * 3.3f * (float)k / (float)n));
+			}
+
+			uint32_t start = profiling_now();
+			fft_real_q15(bench_fft_buffer, n);
+			uint32_t cycles = profiling_now() - start;
+
+			total += cycles;
+			if (cycles < r.min) r.min = cycles;
+			if (cycles > r.max) r.max = cycles;
+		}
+		r.avg = (uint32_t)(total / iterations);
+
+		printf("%-12lu %8lu %8lu %8lu %10lu %8lu\r\n", n, r.min, r.avg, r.max,
+				r.avg / n, (uint32_t)((uint64_t)r.avg * 1000000U / SystemCoreClock));
+	}
+}
+
+/**
+ * @brief Resampler 44.1 -> 48 kHz for every quality preset: cycles per output
+ * frame and THD+N of a 1 kHz sine at -6 dBFS. The sine at the expected
+ * frequency is fitted by least squares over 20 periods, what is left is
+ * distortion and noise.
+ * @param iterations: Number of conversions of the test signal per preset.
+ */
+void bench_src(int iterations)
+{
+	if (iterations <= 0) iterations = 20;
+
+	for (int n = 0; n < BENCH_SRC_IN; n++)
+	{
+		int16_t v = (int16_t)(16384.0f * sinf(6.2831853f * 1000.0f * (float)n / 44100.0f));
+
+		bench_src_in[2*n] = v;
+		bench_src_in[2*n + 1] = v;
+	}
+
+	printf("Conversion 44.1 -> 48 kHz, %d trames, %d iterations\r\n", BENCH_SRC_OUT, iterations);
+	printf("%-12s %8s %8s %8s %10s %8s %10s\r\n", "Qualite", "min", "moy", "max", "cyc/trame", "CPU %", "THD+N dB");
+
+	for (int q = 0; q < SRC_QUALITY_COUNT; q++)
+	{
+		bench_result_t r = { UINT32_MAX, 0, 0 };
+		uint64_t total = 0;
+		uint32_t produced = 0, consumed;
+
+		src_init(&bench_conv, 44100, 48000, (src_quality_t)q);
+		for (int i = 0; i < iterations; i++)
+		{
+			watchdog_checkin(WATCHDOG_SHELL);
+			src_reset(&bench_conv);
+
+			uint32_t start = profiling_now();
+			produced = src_process(&bench_conv, bench_src_in, BENCH_SRC_IN, &consumed, bench_src_out, BENCH_SRC_OUT);
+			uint32_t cycles = profiling_now() - start;
+
+			total += cycles;
+			if (cycles < r.min) r.min = cycles;
+			if (cycles > r.max) r.max = cycles;
+		}
+		r.avg = (uint32_t)(total / iterations);
+
+		// Least squares fit of a cos + b sin, then residual over signal
+		float c = 0.0f, s = 0.0f, residual = 0.0f, signal = 0.0f;
+
+		for (int n = 0; n < BENCH_SRC_FIT; n++)
+		{
+			float x = bench_src_out[2*(BENCH_SRC_SKIP + n)];
+			float w = 6.2831853f * 1000.0f * (float)n / 48000.0f;
+
+			c += x * cosf(w);
+			s += x * sinf(w);
+		}
+		c *= 2.0f / BENCH_SRC_FIT;
+		s *= 2.0f / BENCH_SRC_FIT;
+		for (int n = 0; n < BENCH_SRC_FIT; n++)
+		{
+			float w = 6.2831853f * 1000.0f * (float)n / 48000.0f;
+			float fit = c * cosf(w) + s * sinf(w);
+			float e = bench_src_out[2*(BENCH_SRC_SKIP + n)] - fit;
+
+			residual += e * e;
+			signal += fit * fit;
+		}
+
+		uint32_t per_frame = r.avg / produced;
+		uint32_t load = (uint32_t)((uint64_t)r.avg * 48000U * 1000U / ((uint64_t)SystemCoreClock * produced));
+		int32_t thdn = (int32_t)(100.0f * log10f(residual / signal));	// 10 log10, in 1/10 dB
+
+		printf("%-12s %8lu %8lu %8lu %10lu %6lu.%lu %7ld.%ld\r\n", src_quality_name((src_quality_t)q),
+				r.min, r.avg, r.max, per_frame, load / 10, load % 10, thdn / 10, -thdn % 10);
+	}
+}
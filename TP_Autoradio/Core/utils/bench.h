@@ -0,0 +1,29 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_BENCH_H_
+#define UTILS_BENCH_H_
+
+#include <stdint.h>
+
+#include "../audio/reverb.h"
+
+typedef struct {
+	uint32_t min;	// Cycles
+	uint32_t max;
+	uint32_t avg;
+} bench_result_t;
+
+void bench_placement(int iterations);
+void bench_biquad(int iterations);
+void bench_rc_filter(int iterations);
+void bench_delay(int iterations);
+void bench_reverb(reverb_t * shared, int iterations);
+void bench_fft(int iterations);
+void bench_src(int iterations);
+
+#endif /* UTILS_BENCH_H_ */
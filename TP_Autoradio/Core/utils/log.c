@@ -0,0 +1,228 @@
+/*
+ * log.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os.h"
+
+#include "profiling.h"
+#include "sections.h"
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+#if (LOG_RING_SIZE & LOG_RING_MASK)
+#error "LOG_RING_SIZE must be a power of two"
+#endif
+
+typedef struct {
+	volatile uint32_t seq;	// Index + 1 of the record once published
+	uint32_t timestamp;		// Profiling clock (CPU cycles)
+	const char * fmt;		// Format string address, acts as the format ID
+	uint8_t module;
+	uint8_t level;
+	uint8_t nargs;
+	uint32_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+typedef struct {
+	volatile uint32_t head;	// Next index to reserve (producers)
+	volatile uint32_t tail;	// Next index to read (consumer)
+	volatile uint32_t dropped;
+	log_record_t records[LOG_RING_SIZE];
+} log_ring_t;
+
+static const char * const log_module_names[LOG_MOD_COUNT] = {
+		"main", "mcp23s17", "sgtl5000", "sai", "shell", "audio", "power", "watchdog"
+};
+
+static const char * const log_level_names[] = {
+		"none", "error", "warn", "info", "debug"
+};
+
+volatile uint8_t log_levels[LOG_MOD_COUNT];
+static TaskHandle_t log_task = NULL;	// Notified on each record, see task_log()
+
+static log_ring_t log_ring;				// SRAM1, SRAM2 is kept for the DSP state and code
+
+
+/**
+ * @brief Sets every module to the default level and empties the ring.
+ */
+void log_init(void)
+{
+	for (int i = 0; i < LOG_MOD_COUNT; i++)
+	{
+		log_levels[i] = LOG_LEVEL_WARN;
+	}
+
+	memset(&log_ring, 0, sizeof(log_ring));
+}
+
+/**
+ * @brief Stores a record in the ring without formatting it.
+ * Multi-producer and lock-free (LDREX/STREX), so it can be called from any
+ * task or ISR (up to configMAX_SYSCALL_INTERRUPT_PRIORITY, the log task is
+ * notified). When the ring is full the record is dropped and counted.
+ * @param module: Module emitting the record.
+ * @param level: Level of the record.
+ * @param fmt: printf format string, must live in flash.
+ * @param nargs: Number of 32-bit arguments that follow.
+ */
+ISR_CODE void log_write(log_module_t module, log_level_t level, const char * fmt, uint32_t nargs, ...)
+{
+	uint32_t head;
+	va_list ap;
+
+	// Reserve a slot
+	do {
+		head = __atomic_load_n(&log_ring.head, __ATOMIC_RELAXED);
+		if (head - __atomic_load_n(&log_ring.tail, __ATOMIC_ACQUIRE) >= LOG_RING_SIZE)
+		{
+			__atomic_fetch_add(&log_ring.dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(&log_ring.head, &head, head + 1,
+			1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	log_record_t * record = &log_ring.records[head & LOG_RING_MASK];
+
+	record->timestamp = profiling_now();
+	record->fmt = fmt;
+	record->module = module;
+	record->level = level;
+	record->nargs = (nargs > LOG_MAX_ARGS) ? LOG_MAX_ARGS : nargs;
+
+	va_start(ap, nargs);
+	for (uint32_t i = 0; i < record->nargs; i++)
+	{
+		record->args[i] = va_arg(ap, uint32_t);
+	}
+	va_end(ap);
+
+	// Publish
+	__atomic_store_n(&record->seq, head + 1, __ATOMIC_RELEASE);
+
+	// Wake the consumer, several records before it runs count once
+	if (log_task != NULL)
+	{
+		if (xPortIsInsideInterrupt())
+		{
+			BaseType_t woken = pdFALSE;
+
+			vTaskNotifyGiveFromISR(log_task, &woken);
+			portYIELD_FROM_ISR(woken);
+		}
+		else
+		{
+			xTaskNotifyGive(log_task);
+		}
+	}
+}
+
+/**
+ * @brief Formats and prints every published record (single consumer).
+ * @retval int: Number of records printed.
+ */
+int log_drain(void)
+{
+	int count = 0;
+	uint32_t tail = log_ring.tail;
+
+	for (;;)
+	{
+		log_record_t * record = &log_ring.records[tail & LOG_RING_MASK];
+
+		if (__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != tail + 1)
+		{
+			break;	// Empty, or the next producer has not published yet
+		}
+
+		log_record_t copy = *record;
+		__atomic_store_n(&log_ring.tail, ++tail, __ATOMIC_RELEASE);
+
+		printf("[%10lu] %s %s: ", copy.timestamp,
+				log_module_names[copy.module], log_level_names[copy.level]);
+		printf(copy.fmt, copy.args[0], copy.args[1], copy.args[2], copy.args[3]);
+		printf("\r\n");
+		count++;
+	}
+
+	uint32_t dropped = __atomic_exchange_n(&log_ring.dropped, 0, __ATOMIC_RELAXED);
+	if (dropped)
+	{
+		printf("[log] %lu records dropped\r\n", dropped);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Synchronous drain, to be used before a fatal error handler.
+ */
+void log_flush(void)
+{
+	log_drain();
+}
+
+uint32_t log_dropped(void)
+{
+	return log_ring.dropped;
+}
+
+/**
+ * @brief Changes the runtime level of a module.
+ * @param module: Module name, or "all".
+ * @param level: New level (0 = none ... 4 = debug).
+ * @retval int: 0 on success, -1 if the module or the level is unknown.
+ */
+int log_set_level(const char * module, int level)
+{
+	if (level < LOG_LEVEL_NONE || level > LOG_LEVEL_DEBUG)
+	{
+		return -1;
+	}
+
+	int all = (strcmp(module, "all") == 0);
+	int found = -1;
+
+	for (int i = 0; i < LOG_MOD_COUNT; i++)
+	{
+		if (all || strcmp(module, log_module_names[i]) == 0)
+		{
+			log_levels[i] = level;
+			found = 0;
+		}
+	}
+
+	return found;
+}
+
+void log_print_levels(void)
+{
+	for (int i = 0; i < LOG_MOD_COUNT; i++)
+	{
+		printf("%-10s %d (%s)\r\n", log_module_names[i], log_levels[i], log_level_names[log_levels[i]]);
+	}
+}
+
+/**
+ * @brief Low priority task formatting the deferred records, only woken
+ * when there are some.
+ */
+void task_log(void * unused)
+{
+	log_task = xTaskGetCurrentTaskHandle();
+
+	for (;;)
+	{
+		log_drain();
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * log.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_LOG_H_
+#define UTILS_LOG_H_
+
+#include <stdint.h>
+
+#define LOG_RING_SIZE 64	// Number of records, must be a power of two
+#define LOG_MAX_ARGS 4
+
+/**
+ * @brief Modules owning a runtime log level.
+ */
+typedef enum
+{
+	LOG_MOD_MAIN = 0U,
+	LOG_MOD_MCP23S17,
+	LOG_MOD_SGTL5000,
+	LOG_MOD_SAI,
+	LOG_MOD_SHELL,
+	LOG_MOD_AUDIO,
+	LOG_MOD_POWER,
+	LOG_MOD_WATCHDOG,
+	LOG_MOD_COUNT
+} log_module_t;
+
+/**
+ * @brief Log levels, a record is kept if its level <= the module level.
+ */
+typedef enum
+{
+	LOG_LEVEL_NONE = 0U,
+	LOG_LEVEL_ERROR,
+	LOG_LEVEL_WARN,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_DEBUG
+} log_level_t;
+
+extern volatile uint8_t log_levels[LOG_MOD_COUNT];
+
+void log_init(void);
+void log_write(log_module_t module, log_level_t level, const char * fmt, uint32_t nargs, ...);
+int log_drain(void);
+void log_flush(void);
+uint32_t log_dropped(void);
+int log_set_level(const char * module, int level);
+void log_print_levels(void);
+void task_log(void * unused);
+
+// Counts the variadic arguments (0 to LOG_MAX_ARGS)
+#define LOG_NARGS(...) LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, N, ...) N
+
+/**
+ * The format string is NOT copied: only its address (in flash) and the raw
+ * 32-bit arguments are stored, formatting is deferred to task_log.
+ * As a consequence, %s arguments must be string literals and %f is not supported.
+ * Safe to call from ISR context.
+ */
+#define LOG(module, level, fmt, ...)										\
+		do {																\
+			if ((level) <= log_levels[(module)])							\
+				log_write((module), (level), (fmt),							\
+						LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__);				\
+		} while (0)
+
+#define LOG_ERR(module, fmt, ...)	LOG(module, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(module, fmt, ...)	LOG(module, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(module, fmt, ...)	LOG(module, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DBG(module, fmt, ...)	LOG(module, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#endif /* UTILS_LOG_H_ */
@@ -0,0 +1,108 @@
+/*
+ * mailbox.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "mailbox.h"
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "atomic.h"
+
+#include "sections.h"
+
+#define MAILBOX_MASK (MAILBOX_SIZE - 1)
+
+#if (MAILBOX_SIZE & MAILBOX_MASK)
+#error "MAILBOX_SIZE must be a power of two"
+#endif
+
+
+void mailbox_init(mailbox_t * mb)
+{
+	memset(mb, 0, sizeof(*mb));
+}
+
+/**
+ * @brief Queues an update, from any task. The payload is copied.
+ * @param mb: Mailbox.
+ * @param apply: Called by the audio task with ctx and the copy of the payload.
+ * @param ctx: Target, usually the stage.
+ * @param payload: Parameters, may be NULL.
+ * @param size: Bytes of payload, MAILBOX_PAYLOAD_WORDS * 4 at most.
+ * @retval int: 0 on success, -1 if the payload is too big or the mailbox
+ * is full (the audio task is not running).
+ */
+int mailbox_post(mailbox_t * mb, mailbox_apply_t apply, void * ctx, const void * payload, uint32_t size)
+{
+	uint32_t head;
+
+	if (size > sizeof(mb->msgs[0].payload))
+	{
+		return -1;
+	}
+
+	// Reserve a slot
+	do {
+		head = __atomic_load_n(&mb->head, __ATOMIC_RELAXED);
+		if (head - __atomic_load_n(&mb->tail, __ATOMIC_ACQUIRE) >= MAILBOX_SIZE)
+		{
+			Atomic_Increment_u32(&mb->full);
+			return -1;
+		}
+	} while (Atomic_CompareAndSwap_u32(&mb->head, head + 1, head) != ATOMIC_COMPARE_AND_SWAP_SUCCESS);
+
+	mailbox_msg_t * msg = &mb->msgs[head & MAILBOX_MASK];
+
+	msg->apply = apply;
+	msg->ctx = ctx;
+	if (size > 0)
+	{
+		memcpy(msg->payload, payload, size);
+	}
+
+	// Publish
+	__atomic_store_n(&msg->seq, head + 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/**
+ * @brief Audio task side, at a block boundary: applies the published
+ * messages in order. Stops at a reserved slot not published yet, it will
+ * be applied at the next block.
+ * @retval uint32_t: Number of messages applied.
+ */
+ISR_CODE uint32_t mailbox_drain(mailbox_t * mb)
+{
+	uint32_t tail = mb->tail;
+	uint32_t count = 0;
+
+	for (;;)
+	{
+		mailbox_msg_t * msg = &mb->msgs[tail & MAILBOX_MASK];
+
+		if (__atomic_load_n(&msg->seq, __ATOMIC_ACQUIRE) != tail + 1)
+		{
+			break;
+		}
+
+		msg->apply(msg->ctx, msg->payload);
+		__atomic_store_n(&mb->tail, ++tail, __ATOMIC_RELEASE);	// Slot free for the producers
+		count++;
+	}
+
+	mb->applied += count;
+
+	return count;
+}
+
+/**
+ * @brief Tells if every message posted has been applied.
+ */
+int mailbox_empty(const mailbox_t * mb)
+{
+	return __atomic_load_n(&mb->tail, __ATOMIC_ACQUIRE) == __atomic_load_n(&mb->head, __ATOMIC_ACQUIRE);
+}
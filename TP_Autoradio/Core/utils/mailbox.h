@@ -0,0 +1,47 @@
+/*
+ * mailbox.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_MAILBOX_H_
+#define UTILS_MAILBOX_H_
+
+#include <stdint.h>
+
+/**
+ * Parameter updates for the audio task, without locks on the audio path.
+ * Control tasks post a message (callback, context, small payload copied in
+ * the slot); the audio task applies every published message at the start of
+ * its next block, so a stage never sees half of a parameter set.
+ * Posting reserves a slot with a compare-and-swap (FreeRTOS atomic.h, a few
+ * cycles with interrupts masked), so several tasks can post; there is one
+ * consumer, the audio task, which never blocks.
+ */
+#define MAILBOX_SIZE 16					// Messages, a power of two
+#define MAILBOX_PAYLOAD_WORDS 8
+
+typedef void (* mailbox_apply_t)(void * ctx, const void * payload);
+
+typedef struct {
+	volatile uint32_t seq;				// Index + 1 once published
+	mailbox_apply_t apply;
+	void * ctx;
+	uint32_t payload[MAILBOX_PAYLOAD_WORDS];
+} mailbox_msg_t;
+
+typedef struct {
+	volatile uint32_t head;				// Next index to reserve (producers)
+	volatile uint32_t tail;				// Next index to apply (audio task)
+	volatile uint32_t full;				// Posts refused
+	uint32_t applied;
+	mailbox_msg_t msgs[MAILBOX_SIZE];
+} mailbox_t;
+
+void mailbox_init(mailbox_t * mb);
+int mailbox_post(mailbox_t * mb, mailbox_apply_t apply, void * ctx, const void * payload, uint32_t size);
+uint32_t mailbox_drain(mailbox_t * mb);
+int mailbox_empty(const mailbox_t * mb);
+
+#endif /* UTILS_MAILBOX_H_ */
@@ -0,0 +1,363 @@
+/*
+ * power.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "power.h"
+
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "../audio/audio.h"
+#include "../drivers/SGTL5000.h"
+#include "log.h"
+#include "profiling.h"
+#include "sched.h"
+
+typedef struct {
+	volatile uint8_t state;				// power_state_t, read by the other tasks
+	volatile uint8_t request;			// power_state_t, POWER_STATE_COUNT if none
+	uint8_t automatic;					// SILENT entered on silence
+	uint8_t quiet;						// Output below the threshold since quiet_since
+	uint32_t silence_ms;
+	TickType_t quiet_since;
+	TickType_t since;					// Start of the current state
+	volatile uint32_t requested_at;		// Cycle counter at the last request
+	power_stats_t stats;
+} power_t;
+
+static power_t power;
+static TaskHandle_t power_task = NULL;
+static StaticTimer_t power_heartbeat_buffer;
+static TimerHandle_t power_heartbeat = NULL;
+
+static const char * const power_state_names[POWER_STATE_COUNT] = {
+		"active", "silent", "muted"
+};
+
+
+/**
+ * @brief LD2 heartbeat, timer task. Off as soon as the state is not ACTIVE,
+ * even if the timer has not been stopped yet.
+ */
+static void power_heartbeat_cb(TimerHandle_t timer)
+{
+	if (power.state == POWER_ACTIVE)
+	{
+		HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+	}
+	else
+	{
+		HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, GPIO_PIN_RESET);
+	}
+}
+
+void power_init(void)
+{
+	memset(&power, 0, sizeof(power));
+
+	power.state = POWER_ACTIVE;
+	power.request = POWER_STATE_COUNT;
+	power.automatic = 1;
+	power.silence_ms = POWER_SILENCE_MS;
+
+	power_heartbeat = xTimerCreateStatic("LD2", POWER_HEARTBEAT_MS / portTICK_PERIOD_MS, pdTRUE,
+			NULL, power_heartbeat_cb, &power_heartbeat_buffer);
+}
+
+/**
+ * @brief Asks the power task for a state, from a task. Taken into account
+ * at once, the power task having a higher priority than the control tasks.
+ */
+void power_request(power_state_t state)
+{
+	if (state >= POWER_STATE_COUNT)
+	{
+		return;
+	}
+
+	power.requested_at = profiling_now();
+	power.request = state;
+	if (power_task != NULL)
+	{
+		xTaskNotifyGive(power_task);
+	}
+}
+
+/**
+ * @brief User activity (console), from an interrupt: back to ACTIVE if the
+ * unit sleeps. The power task preempts the shell, so the clocks are back
+ * before the command is run.
+ */
+void power_activity_from_isr(void)
+{
+	BaseType_t woken = pdFALSE;
+
+	if (power.state == POWER_ACTIVE || power_task == NULL)
+	{
+		return;
+	}
+
+	power.requested_at = profiling_now();
+	power.request = POWER_ACTIVE;
+	vTaskNotifyGiveFromISR(power_task, &woken);
+	portYIELD_FROM_ISR(woken);
+}
+
+power_state_t power_get_state(void)
+{
+	return (power_state_t)power.state;
+}
+
+const char * power_state_name(power_state_t state)
+{
+	return (state < POWER_STATE_COUNT) ? power_state_names[state] : "?";
+}
+
+/**
+ * @brief Automatic SILENT state.
+ * @param enable: 1 to enter it after silence_ms of silence, 0 to stay ACTIVE.
+ * @param silence_ms: Hold time, 0 to keep the current one.
+ */
+void power_set_auto(int enable, uint32_t silence_ms)
+{
+	if (silence_ms > 0)
+	{
+		power.silence_ms = silence_ms;
+	}
+	power.automatic = (enable != 0);
+	power.quiet = 0;
+
+	if (power_task != NULL)
+	{
+		xTaskNotifyGive(power_task);
+	}
+}
+
+int power_get_auto(uint32_t * silence_ms)
+{
+	if (silence_ms != NULL)
+	{
+		*silence_ms = power.silence_ms;
+	}
+
+	return power.automatic;
+}
+
+/**
+ * @brief Copy of the statistics, the current state counted up to now.
+ */
+void power_get_stats(power_stats_t * stats)
+{
+	taskENTER_CRITICAL();
+	*stats = power.stats;
+	stats->ticks[power.state] += xTaskGetTickCount() - power.since;
+	taskEXIT_CRITICAL();
+}
+
+void power_reset_stats(void)
+{
+	taskENTER_CRITICAL();
+	memset(&power.stats, 0, sizeof(power.stats));
+	power.since = xTaskGetTickCount();
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief configPRE_SLEEP_PROCESSING(), idle task, interrupts masked: the HAL
+ * tick (TIM6) would wake the CPU every millisecond, it is stopped during
+ * the sleep. HAL_GetTick() does not count the time asleep.
+ * @param ticks: Expected idle time, 0 would skip the sleep.
+ */
+void power_pre_sleep(uint32_t * ticks)
+{
+	HAL_SuspendTick();
+
+	power.stats.sleeps++;
+	power.stats.sleep_ticks += *ticks;
+}
+
+/**
+ * @brief configPOST_SLEEP_PROCESSING(), idle task, interrupts masked.
+ */
+void power_post_sleep(uint32_t * ticks)
+{
+	(void)ticks;
+
+	HAL_ResumeTick();
+	sched_runtime_counter();	// Sees the wraps of the cycle counter during long sleeps
+}
+
+/**
+ * @brief Moves to another state. Going down, the codec is powered down
+ * while it still has its clock, then the SAI is stopped and the clocks
+ * gated; going up, the reverse, the codec last.
+ */
+static void power_enter(power_state_t next)
+{
+	const power_state_t prev = (power_state_t)power.state;
+
+	if (next == prev)
+	{
+		return;
+	}
+
+	if (prev == POWER_MUTED)
+	{
+		__HAL_RCC_SAI2_CLK_ENABLE();
+		__HAL_RCC_I2C2_CLK_ENABLE();
+		if (audio_resume() != HAL_OK)
+		{
+			LOG_ERR(LOG_MOD_POWER, "Power: SAI DMA restart failed");
+		}
+	}
+
+	drv_status_t status;
+
+	switch (next)
+	{
+	case POWER_ACTIVE:
+		status = SGTL5000_Power(1, 1);
+		break;
+	case POWER_SILENT:
+		status = SGTL5000_Power(0, 1);
+		break;
+	default:
+		status = SGTL5000_Power(0, 0);
+		audio_stop();
+		__HAL_RCC_I2C2_CLK_DISABLE();
+		__HAL_RCC_SAI2_CLK_DISABLE();
+		break;
+	}
+
+	// The state is entered anyway: the clocks follow it, the codec is retried on the next transition
+	if (status != DRV_OK)
+	{
+		LOG_ERR(LOG_MOD_POWER, "Power: codec not switched (%s)", drv_status_name(status));
+	}
+
+	taskENTER_CRITICAL();
+	const TickType_t now = xTaskGetTickCount();
+	power.stats.ticks[prev] += now - power.since;
+	power.stats.transitions++;
+	power.since = now;
+	power.state = next;
+	taskEXIT_CRITICAL();
+
+	HAL_GPIO_WritePin(LD2_GPIO_Port, LD2_Pin, GPIO_PIN_RESET);
+	if (next == POWER_ACTIVE)
+	{
+		xTimerStart(power_heartbeat, 0);
+	}
+	else
+	{
+		xTimerStop(power_heartbeat, 0);
+	}
+	sched_signal(SCHED_EVT_DISPLAY);
+
+	if (next == POWER_ACTIVE)
+	{
+		const uint32_t us = PROFILING_CYCLES_TO_US(profiling_now() - power.requested_at);
+
+		power.stats.wake_last_us = us;
+		if (us > power.stats.wake_max_us) power.stats.wake_max_us = us;
+		if (us > POWER_WAKE_BUDGET_US)
+		{
+			LOG_WARN(LOG_MOD_POWER, "Power: wake up in %lu us", us);
+		}
+	}
+
+	LOG_INFO(LOG_MOD_POWER, "Power: %s -> %s", power_state_names[prev], power_state_names[next]);
+}
+
+/**
+ * @brief Automatic transitions, from the envelope of the output measured by
+ * the audio task (the VU meter). Never SILENT while the codec is routed
+ * without the MCU: there is no envelope then.
+ */
+static void power_check(void)
+{
+	const int32_t db = (audio_dynamics.detector.db[0] > audio_dynamics.detector.db[1]) ?
+			audio_dynamics.detector.db[0] : audio_dynamics.detector.db[1];
+	const TickType_t now = xTaskGetTickCount();
+
+	if (!power.automatic || audio_get_bypass())
+	{
+		power.quiet = 0;
+		if (power.state == POWER_SILENT)
+		{
+			power.requested_at = profiling_now();
+			power_enter(POWER_ACTIVE);
+		}
+		return;
+	}
+
+	if (power.state == POWER_ACTIVE)
+	{
+		if (db >= LEVEL_DB(POWER_SILENCE_DB))
+		{
+			power.quiet = 0;
+		}
+		else if (!power.quiet)
+		{
+			power.quiet = 1;
+			power.quiet_since = now;
+		}
+		else if ((now - power.quiet_since) * portTICK_PERIOD_MS >= power.silence_ms)
+		{
+			power_enter(POWER_SILENT);
+		}
+	}
+	else if (power.state == POWER_SILENT && db >= LEVEL_DB(POWER_SILENCE_DB + POWER_HYSTERESIS_DB))
+	{
+		power.quiet = 0;
+		power.requested_at = profiling_now();
+		power_enter(POWER_ACTIVE);
+	}
+}
+
+/**
+ * @brief Above the control tasks: takes the requests, checks the silence
+ * every POWER_PERIOD_MS (POWER_SILENT_PERIOD_MS while SILENT, only the
+ * requests while MUTED).
+ */
+void task_power(void * unused)
+{
+	power_task = xTaskGetCurrentTaskHandle();
+	power.since = xTaskGetTickCount();
+	xTimerStart(power_heartbeat, 0);
+
+	for (;;)
+	{
+		TickType_t wait = portMAX_DELAY;
+
+		if (power.state == POWER_ACTIVE)
+		{
+			wait = POWER_PERIOD_MS / portTICK_PERIOD_MS;
+		}
+		else if (power.state == POWER_SILENT)
+		{
+			wait = POWER_SILENT_PERIOD_MS / portTICK_PERIOD_MS;
+		}
+
+		ulTaskNotifyTake(pdTRUE, wait);
+
+		taskENTER_CRITICAL();
+		const uint8_t request = power.request;
+		power.request = POWER_STATE_COUNT;
+		taskEXIT_CRITICAL();
+
+		if (request != POWER_STATE_COUNT)
+		{
+			power.quiet = 0;
+			power_enter((power_state_t)request);
+			continue;
+		}
+
+		power_check();
+	}
+}
@@ -0,0 +1,64 @@
+/*
+ * power.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_POWER_H_
+#define UTILS_POWER_H_
+
+#include <stdint.h>
+
+/**
+ * Power manager, a task deciding between three states:
+ * - ACTIVE: everything runs, LD2 blinks (software timer).
+ * - SILENT: the output has been below POWER_SILENCE_DB for silence_ms. The
+ *   output stages of the codec are powered down, the LEDs blanked and SPI3
+ *   gated (by the display task, which owns it); the audio path keeps running
+ *   so that the return of the sound is seen within POWER_SILENT_PERIOD_MS.
+ * - MUTED: on request only. Codec outputs and ADC down, SAI and DMA stopped,
+ *   then the SAI2, I2C2 and SPI3 clocks gated: the CPU only wakes for the
+ *   tick and the UART. Any key on the console wakes the unit up.
+ * Between interrupts the idle task sleeps (tickless idle), the HAL tick
+ * (TIM6) being suspended meanwhile.
+ */
+#define POWER_PERIOD_MS 1000			// Checks while ACTIVE
+#define POWER_HEARTBEAT_MS 200			// LD2 toggles while ACTIVE
+#define POWER_SILENT_PERIOD_MS 20		// Checks while SILENT, bounds the wake up
+#define POWER_SILENCE_DB (-60)			// Output level of the silence, dBFS
+#define POWER_HYSTERESIS_DB 6			// Sound back above POWER_SILENCE_DB + this
+#define POWER_SILENCE_MS 30000			// Default hold time before SILENT
+#define POWER_WAKE_BUDGET_US 5000		// A longer wake up is logged
+
+typedef enum
+{
+	POWER_ACTIVE = 0U,
+	POWER_SILENT,
+	POWER_MUTED,
+	POWER_STATE_COUNT
+} power_state_t;
+
+typedef struct {
+	uint64_t ticks[POWER_STATE_COUNT];	// Time spent in each state
+	uint32_t transitions;
+	uint32_t wake_last_us;				// Back to ACTIVE, from the decision to the codec powered up
+	uint32_t wake_max_us;
+	uint32_t sleeps;					// Tickless idle sleeps
+	uint64_t sleep_ticks;				// Ticks they were allowed to last
+} power_stats_t;
+
+void power_init(void);
+void power_request(power_state_t state);
+void power_activity_from_isr(void);
+power_state_t power_get_state(void);
+const char * power_state_name(power_state_t state);
+void power_set_auto(int enable, uint32_t silence_ms);
+int power_get_auto(uint32_t * silence_ms);
+void power_get_stats(power_stats_t * stats);
+void power_reset_stats(void);
+void power_pre_sleep(uint32_t * ticks);
+void power_post_sleep(uint32_t * ticks);
+void task_power(void * unused);
+
+#endif /* UTILS_POWER_H_ */
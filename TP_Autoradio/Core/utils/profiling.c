@@ -0,0 +1,39 @@
+/*
+ * profiling.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "profiling.h"
+
+/**
+ * @brief Starts the DWT cycle counter used as the profiling clock.
+ */
+void profiling_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	// Enable the trace block (DWT)
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Clears the statistics of a zone. The owner of the zone may be
+ * measuring at the same time, one run can be counted in the old statistics.
+ */
+void profiling_zone_reset(profiling_zone_t * zone)
+{
+	zone->max = 0;
+	zone->count = 0;
+	zone->total = 0;
+}
+
+/**
+ * @brief Average cycles per run, 0 if never run.
+ */
+uint32_t profiling_zone_avg(const profiling_zone_t * zone)
+{
+	uint32_t count = zone->count;
+
+	return count ? (uint32_t)(zone->total / count) : 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * profiling.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_PROFILING_H_
+#define UTILS_PROFILING_H_
+
+#include <stdint.h>
+#include "main.h"
+
+/**
+ * @brief Converts a number of CPU cycles to microseconds.
+ */
+#define PROFILING_CYCLES_TO_US(cycles) ((uint32_t)((cycles) / (SystemCoreClock / 1000000U)))
+
+/**
+ * @brief Cycles spent in a section of code, measured on every run.
+ */
+typedef struct {
+	uint32_t start;
+	uint32_t last;
+	uint32_t max;
+	uint32_t count;
+	uint64_t total;
+} profiling_zone_t;
+
+void profiling_init(void);
+void profiling_zone_reset(profiling_zone_t * zone);
+uint32_t profiling_zone_avg(const profiling_zone_t * zone);
+
+/**
+ * @brief Returns the free running CPU cycle counter (DWT->CYCCNT).
+ * Wraps every 2^32 cycles, i.e. ~53 s at 80 MHz: always compute differences.
+ */
+static inline uint32_t profiling_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+static inline void profiling_zone_begin(profiling_zone_t * zone)
+{
+	zone->start = profiling_now();
+}
+
+static inline void profiling_zone_end(profiling_zone_t * zone)
+{
+	uint32_t cycles = profiling_now() - zone->start;
+
+	zone->last = cycles;
+	zone->total += cycles;
+	zone->count++;
+	if (cycles > zone->max) zone->max = cycles;
+}
+
+#endif /* UTILS_PROFILING_H_ */
@@ -0,0 +1,152 @@
+/*
+ * sched.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "sched.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "profiling.h"
+
+typedef struct {
+	uint32_t switches[SCHED_MAX_TASKS];	// Switched in, by task number (creation order)
+	uint32_t total;
+	uint32_t runtime[SCHED_MAX_TASKS];	// Run time counters at the last reset
+	uint32_t runtime_total;
+	TickType_t since;					// Tick of the last reset
+} sched_stats_t;
+
+static StaticEventGroup_t sched_events_buffer;
+static EventGroupHandle_t sched_events = NULL;
+static sched_stats_t sched_stats;
+static TaskStatus_t sched_status[SCHED_MAX_TASKS];	// Snapshot for the report, not on the shell stack
+static uint32_t sched_cycles_high;
+static uint32_t sched_cycles_last;
+
+
+/**
+ * @brief Creates the event group, before the scheduler starts.
+ */
+void sched_init(void)
+{
+	sched_events = xEventGroupCreateStatic(&sched_events_buffer);
+	memset(&sched_stats, 0, sizeof(sched_stats));
+}
+
+/**
+ * @brief Sets event bits, from a task. Every task waiting on one of them
+ * is woken.
+ */
+void sched_signal(EventBits_t bits)
+{
+	if (sched_events != NULL)
+	{
+		xEventGroupSetBits(sched_events, bits);
+	}
+}
+
+/**
+ * @brief Blocks until one of the bits is set, they are cleared on return.
+ * Each event has a single consumer, so clearing them does not hide it from
+ * another task.
+ * @retval EventBits_t: Bits among 'bits' which were set, 0 on timeout.
+ */
+EventBits_t sched_wait(EventBits_t bits, TickType_t timeout)
+{
+	return xEventGroupWaitBits(sched_events, bits, pdTRUE, pdFALSE, timeout) & bits;
+}
+
+/**
+ * @brief traceTASK_SWITCHED_IN(), from the kernel with interrupts masked.
+ * @param number: Number of the task switched in (uxTCBNumber).
+ */
+void sched_switched_in(uint32_t number)
+{
+	sched_stats.switches[(number < SCHED_MAX_TASKS) ? number : SCHED_MAX_TASKS - 1]++;
+	sched_stats.total++;
+}
+
+/**
+ * @brief portCONFIGURE_TIMER_FOR_RUN_TIME_STATS(): the DWT cycle counter
+ * has been started by profiling_init().
+ */
+void sched_runtime_init(void)
+{
+	sched_cycles_high = 0;
+	sched_cycles_last = profiling_now();
+}
+
+/**
+ * @brief portGET_RUN_TIME_COUNTER_VALUE(), called on each context switch
+ * and after each idle sleep, often enough to see every wrap of the cycle
+ * counter (53 s). The cycles spent asleep are not counted by the DWT, the
+ * share of the idle task is the time it was awake.
+ */
+uint32_t sched_runtime_counter(void)
+{
+	const uint32_t now = profiling_now();
+
+	if (now < sched_cycles_last)
+	{
+		sched_cycles_high++;
+	}
+	sched_cycles_last = now;
+
+	return (uint32_t)((((uint64_t)sched_cycles_high << 32) | now) >> SCHED_RUNTIME_SHIFT);
+}
+
+/**
+ * @brief Starts a new measurement window.
+ */
+void sched_reset_stats(void)
+{
+	uint32_t runtime;
+	const UBaseType_t count = uxTaskGetSystemState(sched_status, SCHED_MAX_TASKS, &runtime);
+
+	taskENTER_CRITICAL();
+	memset(&sched_stats, 0, sizeof(sched_stats));
+	for (UBaseType_t i = 0; i < count; i++)
+	{
+		const UBaseType_t n = sched_status[i].xTaskNumber;
+
+		sched_stats.runtime[(n < SCHED_MAX_TASKS) ? n : SCHED_MAX_TASKS - 1] = sched_status[i].ulRunTimeCounter;
+	}
+	sched_stats.runtime_total = runtime;
+	sched_stats.since = xTaskGetTickCount();
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Prints, for each task since the last reset: switches in, switches
+ * per second and share of the CPU.
+ */
+void sched_report(void)
+{
+	uint32_t runtime;
+	const UBaseType_t count = uxTaskGetSystemState(sched_status, SCHED_MAX_TASKS, &runtime);
+	sched_stats_t stats;
+
+	taskENTER_CRITICAL();
+	stats = sched_stats;
+	taskEXIT_CRITICAL();
+
+	const uint32_t ms = (xTaskGetTickCount() - stats.since) * portTICK_PERIOD_MS;
+	const uint32_t total = runtime - stats.runtime_total;
+
+	printf("%-16s %3s %10s %8s %7s\r\n", "Tache", "N", "Commut.", "/s", "CPU %");
+	for (UBaseType_t i = 0; i < count; i++)
+	{
+		const TaskStatus_t * t = &sched_status[i];
+		const UBaseType_t n = (t->xTaskNumber < SCHED_MAX_TASKS) ? t->xTaskNumber : SCHED_MAX_TASKS - 1;
+		const uint32_t permil = total ? (uint32_t)((uint64_t)(t->ulRunTimeCounter - stats.runtime[n]) * 1000U / total) : 0;
+
+		printf("%-16s %3lu %10lu %8lu %5lu.%lu\r\n", t->pcTaskName, t->xTaskNumber, stats.switches[n],
+				ms ? (uint32_t)((uint64_t)stats.switches[n] * 1000U / ms) : 0, permil / 10U, permil % 10U);
+	}
+	printf("Total: %lu commutations en %lu ms, %lu /s\r\n", stats.total, ms,
+			ms ? (uint32_t)((uint64_t)stats.total * 1000U / ms) : 0);
+}
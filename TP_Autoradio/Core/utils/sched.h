@@ -0,0 +1,43 @@
+/*
+ * sched.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_SCHED_H_
+#define UTILS_SCHED_H_
+
+#include <stdint.h>
+
+#include "cmsis_os.h"
+
+/**
+ * Event-driven scheduling: the tasks block on the work they serve instead of
+ * waking on a period. Point-to-point wake ups use direct notifications
+ * (DMA -> audio task, UART -> shell, records -> log task, requests -> power
+ * task); events with several producers go through one event group:
+ * - SCHED_EVT_DISPLAY: meter moved (audio task), display mode (shell) or
+ *   power state (power task) changed.
+ * - SCHED_EVT_LOUDNESS: loudness enabled (shell).
+ * Periodic work left (spectrum, loudness estimator) uses vTaskDelayUntil(),
+ * the LD2 heartbeat a software timer.
+ * Context switches are counted per task from traceTASK_SWITCHED_IN(), the
+ * run time stats are based on the DWT cycle counter.
+ */
+#define SCHED_EVT_DISPLAY (1U << 0)
+#define SCHED_EVT_LOUDNESS (1U << 1)
+
+#define SCHED_MAX_TASKS 16				// Task numbers counted, above in the last slot
+#define SCHED_RUNTIME_SHIFT 6			// Run time counter: cycles / 64, 1.25 MHz at 80 MHz
+
+void sched_init(void);
+void sched_signal(EventBits_t bits);
+EventBits_t sched_wait(EventBits_t bits, TickType_t timeout);
+void sched_switched_in(uint32_t number);
+void sched_runtime_init(void);
+uint32_t sched_runtime_counter(void);
+void sched_reset_stats(void);
+void sched_report(void);
+
+#endif /* UTILS_SCHED_H_ */
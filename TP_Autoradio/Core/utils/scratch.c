@@ -0,0 +1,19 @@
+/*
+ * scratch.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "scratch.h"
+
+static uint32_t scratch_buffer[SCRATCH_SIZE / sizeof(uint32_t)];	// Word aligned for any view
+
+
+/**
+ * @brief Shared work area of SCRATCH_SIZE bytes, for the running shell command.
+ */
+void * scratch_get(void)
+{
+	return scratch_buffer;
+}
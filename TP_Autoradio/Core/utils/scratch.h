@@ -0,0 +1,24 @@
+/*
+ * scratch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_SCRATCH_H_
+#define UTILS_SCRATCH_H_
+
+#include <stdint.h>
+
+/**
+ * Work area in SRAM1 for the shell commands which need a large buffer for
+ * their duration only (benchmarks, latency capture). The shell runs one
+ * command at a time, so they all overlay the same bytes: each user lays its
+ * own view over it and checks its size against SCRATCH_SIZE at compile time.
+ * Nothing survives from one command to the next.
+ */
+#define SCRATCH_SIZE 8192				// Bytes, multiple of 4
+
+void * scratch_get(void);
+
+#endif /* UTILS_SCRATCH_H_ */
@@ -0,0 +1,47 @@
+/*
+ * sections.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_SECTIONS_H_
+#define UTILS_SECTIONS_H_
+
+/**
+ * Memory placement, see STM32L476RGTX_FLASH.ld.
+ * RAM  : SRAM1, 96K at 0x20000000, shared with the SAI DMA (S-bus)
+ * RAM2 : SRAM2, 32K at 0x10000000, reached by the CPU through the
+ *        I-Code/D-Code buses: no contention with the DMA traffic in SRAM1
+ *
+ * DMA buffers must stay in RAM, everything else touched per sample should
+ * use the macros below.
+ */
+#define SECTIONS_PLACEMENT 1	// 0 puts everything back in RAM/FLASH (benchmark)
+
+#if (SECTIONS_PLACEMENT)
+#define RAM2_DATA __attribute__((section(".ram2_data")))	// Initialized, copied by the startup
+#define RAM2_BSS  __attribute__((section(".ram2_bss")))	// Zeroed by the startup
+#define FAST_CODE __attribute__((section(".fast_code"), noinline))	// Executed from SRAM2
+#else
+#define RAM2_DATA
+#define RAM2_BSS
+#define FAST_CODE
+#endif
+
+// Not zeroed by the startup, survives a reset (not a power cycle), always in RAM
+#define NOINIT __attribute__((section(".noinit")))
+
+// Usage oriented aliases
+#define DSP_STATE RAM2_BSS		// Filter states, delay lines
+#define DSP_COEFS RAM2_DATA		// Coefficient tables updated at runtime
+#define ISR_CODE  FAST_CODE		// DMA/SAI callbacks and block processing
+
+// Placement tokens used by declarative tables: MEM_PLACE(RAM) or MEM_PLACE(RAM2)
+// The token may itself be a macro (e.g. DELAY_MEM), hence the indirection
+#define MEM_PLACE_RAM
+#define MEM_PLACE_RAM2 RAM2_BSS
+#define MEM_PLACE_(mem) MEM_PLACE_##mem
+#define MEM_PLACE(mem) MEM_PLACE_(mem)
+
+#endif /* UTILS_SECTIONS_H_ */
@@ -0,0 +1,263 @@
+/*
+ * watchdog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#include "watchdog.h"
+
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "log.h"
+#include "sections.h"
+#include "../audio/audio.h"
+
+// IWDG keys (RM0351 38.4)
+#define WATCHDOG_KEY_RELOAD 0xAAAAU
+#define WATCHDOG_KEY_ACCESS 0x5555U
+#define WATCHDOG_KEY_START 0xCCCCU
+
+// LSI at 32 kHz divided by 64: 2 ms per count
+#define WATCHDOG_LSI_HZ 32000U
+#define WATCHDOG_PRESCALER_CODE 4U		// /64
+#define WATCHDOG_RELOAD (WATCHDOG_TIMEOUT_MS * (WATCHDOG_LSI_HZ / 64U) / 1000U - 1U)
+
+#if (WATCHDOG_RELOAD > 0xFFFU)
+#error "WATCHDOG_TIMEOUT_MS too long for the IWDG prescaler"
+#endif
+#if (WATCHDOG_PERIOD_MS * 2 > WATCHDOG_TIMEOUT_MS)
+#error "WATCHDOG_PERIOD_MS must leave a missed check before the reset"
+#endif
+
+#define WATCHDOG_MAGIC 0x57444F47U		// "WDOG"
+
+// Ten blocks of the largest size, rounded up (214 ms for 1024 frames at 48 kHz)
+#define WATCHDOG_AUDIO_MS ((10U * AUDIO_MAX_BLOCK_FRAMES * 1000U + AUDIO_SAMPLE_RATE - 1U) / AUDIO_SAMPLE_RATE)
+
+/**
+ * Survives the reset: not zeroed by the startup, valid if the magic is
+ * there, restarted on power on.
+ */
+typedef struct {
+	uint32_t magic;
+	watchdog_report_t last;				// Cause of the current boot
+	uint8_t pending;					// Client which stopped the reloads, WATCHDOG_COUNT if none
+	uint32_t pending_late_ms;
+	uint32_t pending_uptime_ms;
+} watchdog_record_t;
+
+typedef struct {
+	volatile TickType_t last;			// Tick of the last check in
+	volatile uint8_t armed;
+	uint32_t worst_ms;
+} watchdog_state_t;
+
+static watchdog_record_t watchdog_record NOINIT;
+static watchdog_state_t watchdog_clients[WATCHDOG_COUNT];
+static volatile uint8_t watchdog_running = 0;
+static TickType_t watchdog_checked;
+
+// Deadlines: ten audio blocks, twice the idle wait of the display, the
+// longest shell commands (block sweep, benchmarks), a codec access with
+// its retries
+static const uint32_t watchdog_deadlines_ms[WATCHDOG_COUNT] = {
+		WATCHDOG_AUDIO_MS, 2 * WATCHDOG_IDLE_MS, 10000, 500
+};
+
+static const char * const watchdog_client_names[WATCHDOG_COUNT] = {
+		"audio", "meter", "shell", "codec"
+};
+
+static const char * const watchdog_reset_names[WATCHDOG_RESET_COUNT] = {
+		"?", "iwdg", "wwdg", "low-power", "firewall", "option-bytes", "software", "power-on", "pin"
+};
+
+
+/**
+ * @brief Cause of the reset from the RCC_CSR flags, the most specific one:
+ * the NRST pin flag is set by every internal reset.
+ */
+static watchdog_reset_t watchdog_cause(uint32_t csr)
+{
+	if (csr & RCC_CSR_IWDGRSTF) return WATCHDOG_RESET_IWDG;
+	if (csr & RCC_CSR_WWDGRSTF) return WATCHDOG_RESET_WWDG;
+	if (csr & RCC_CSR_LPWRRSTF) return WATCHDOG_RESET_LOW_POWER;
+	if (csr & RCC_CSR_FWRSTF) return WATCHDOG_RESET_FIREWALL;
+	if (csr & RCC_CSR_OBLRSTF) return WATCHDOG_RESET_OPTION_BYTES;
+	if (csr & RCC_CSR_SFTRSTF) return WATCHDOG_RESET_SOFTWARE;
+	if (csr & RCC_CSR_BORRSTF) return WATCHDOG_RESET_POWER_ON;
+	if (csr & RCC_CSR_PINRSTF) return WATCHDOG_RESET_PIN;
+
+	return WATCHDOG_RESET_UNKNOWN;
+}
+
+/**
+ * @brief Reads the reset cause, before anything clears the flags, and
+ * moves the decision of the previous run to the report.
+ */
+void watchdog_init(void)
+{
+	watchdog_record_t * r = &watchdog_record;
+	const uint32_t csr = RCC->CSR;
+	const watchdog_reset_t cause = watchdog_cause(csr);
+
+	RCC->CSR |= RCC_CSR_RMVF;
+
+	if (r->magic != WATCHDOG_MAGIC || cause == WATCHDOG_RESET_POWER_ON || r->pending > WATCHDOG_COUNT)
+	{
+		memset(r, 0, sizeof(*r));
+		r->magic = WATCHDOG_MAGIC;
+		r->pending = WATCHDOG_COUNT;
+	}
+
+	r->last.csr = csr;
+	r->last.cause = cause;
+	r->last.boots++;
+	if (cause == WATCHDOG_RESET_IWDG)
+	{
+		// WATCHDOG_COUNT if no client was late: the tick hook itself did not run
+		r->last.watchdog_resets++;
+		r->last.client = r->pending;
+		r->last.late_ms = r->pending_late_ms;
+		r->last.uptime_ms = r->pending_uptime_ms;
+	}
+	else
+	{
+		r->last.client = WATCHDOG_COUNT;
+		r->last.late_ms = 0;
+		r->last.uptime_ms = 0;
+	}
+	r->pending = WATCHDOG_COUNT;
+
+	memset(watchdog_clients, 0, sizeof(watchdog_clients));
+
+	// A breakpoint must not reset the target
+	DBGMCU->APB1FZR1 |= DBGMCU_APB1FZR1_DBG_IWDG_STOP;
+}
+
+/**
+ * @brief Starts the IWDG, just before the scheduler: it cannot be stopped
+ * any more. The periodic clients are armed, the codec is armed per access.
+ */
+void watchdog_start(void)
+{
+	const uint32_t start = HAL_GetTick();
+
+	IWDG->KR = WATCHDOG_KEY_START;		// Also starts the LSI
+	IWDG->KR = WATCHDOG_KEY_ACCESS;
+	IWDG->PR = WATCHDOG_PRESCALER_CODE;
+	IWDG->RLR = WATCHDOG_RELOAD;
+	while (IWDG->SR != 0 && HAL_GetTick() - start < 50)
+	{
+	}
+	IWDG->KR = WATCHDOG_KEY_RELOAD;
+
+	watchdog_checkin(WATCHDOG_AUDIO);
+	watchdog_checkin(WATCHDOG_METER);
+	watchdog_checkin(WATCHDOG_SHELL);
+	watchdog_checked = 0;
+	watchdog_running = 1;
+
+	LOG_INFO(LOG_MOD_WATCHDOG, "Watchdog started, %d ms", WATCHDOG_TIMEOUT_MS);
+}
+
+/**
+ * @brief The client is alive, from a task. Also arms a paused client.
+ */
+void watchdog_checkin(watchdog_client_t client)
+{
+	watchdog_state_t * c = &watchdog_clients[client];
+
+	c->last = xTaskGetTickCount();		// Before armed, the tick hook may run in between
+	c->armed = 1;
+}
+
+/**
+ * @brief The client has nothing to do for a while (audio stopped, no codec
+ * access): not supervised until its next check in.
+ */
+void watchdog_pause(watchdog_client_t client)
+{
+	watchdog_clients[client].armed = 0;
+}
+
+/**
+ * @brief vApplicationTickHook(), SysTick interrupt. Every WATCHDOG_PERIOD_MS,
+ * reloads the IWDG if no armed client is late. Otherwise the first late one
+ * is recorded and the reloads stop for good: the reset follows within
+ * WATCHDOG_TIMEOUT_MS. A task hogging the CPU does not stop the tick, a
+ * fault or interrupts masked for too long do (no client recorded then).
+ */
+void watchdog_tick_from_isr(void)
+{
+	const TickType_t now = xTaskGetTickCountFromISR();
+
+	if (!watchdog_running || now - watchdog_checked < WATCHDOG_PERIOD_MS / portTICK_PERIOD_MS)
+	{
+		return;
+	}
+	watchdog_checked = now;
+
+	if (watchdog_record.pending != WATCHDOG_COUNT)
+	{
+		return;
+	}
+
+	for (int i = 0; i < WATCHDOG_COUNT; i++)
+	{
+		watchdog_state_t * c = &watchdog_clients[i];
+
+		if (!c->armed)
+		{
+			continue;
+		}
+
+		const uint32_t age = (now - c->last) * portTICK_PERIOD_MS;
+
+		if (age > c->worst_ms) c->worst_ms = age;
+		if (age > watchdog_deadlines_ms[i])
+		{
+			watchdog_record.pending_late_ms = age;
+			watchdog_record.pending_uptime_ms = now * portTICK_PERIOD_MS;
+			watchdog_record.pending = i;
+			LOG_ERR(LOG_MOD_WATCHDOG, "Watchdog: %s silent for %lu ms, reset", watchdog_client_names[i], age);
+			return;
+		}
+	}
+
+	IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+/**
+ * @brief Cause of the current boot and counters since power on.
+ */
+void watchdog_get_report(watchdog_report_t * report)
+{
+	*report = watchdog_record.last;
+}
+
+void watchdog_get_client(watchdog_client_t client, watchdog_client_info_t * info)
+{
+	const watchdog_state_t * c = &watchdog_clients[client];
+
+	taskENTER_CRITICAL();
+	info->deadline_ms = watchdog_deadlines_ms[client];
+	info->armed = c->armed;
+	info->age_ms = (xTaskGetTickCount() - c->last) * portTICK_PERIOD_MS;
+	info->worst_ms = c->worst_ms;
+	taskEXIT_CRITICAL();
+}
+
+const char * watchdog_client_name(watchdog_client_t client)
+{
+	return (client < WATCHDOG_COUNT) ? watchdog_client_names[client] : "-";
+}
+
+const char * watchdog_reset_name(watchdog_reset_t cause)
+{
+	return (cause < WATCHDOG_RESET_COUNT) ? watchdog_reset_names[cause] : "?";
+}
@@ -0,0 +1,78 @@
+/*
+ * watchdog.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: oliver
+ */
+
+#ifndef UTILS_WATCHDOG_H_
+#define UTILS_WATCHDOG_H_
+
+#include <stdint.h>
+
+/**
+ * Supervisor of the independent watchdog (IWDG, LSI clock, not stopped by
+ * a hung CPU or a fault). The IWDG is only reloaded, from the tick hook,
+ * when every armed client has checked in within its deadline:
+ * - audio: the audio task after each block, paused while MUTED (SAI stopped);
+ * - meter: the display task, whose waits are bounded by WATCHDOG_IDLE_MS;
+ * - shell: the shell task, between two characters and two commands;
+ * - codec: armed during each SGTL5000 access only, a stuck I2C bus.
+ * The first late client is written to a .noinit record before the reset,
+ * which survives it: the next boot reports it with the reset cause (RCC_CSR).
+ */
+#define WATCHDOG_TIMEOUT_MS 2000		// IWDG, from the last reload to the reset
+#define WATCHDOG_PERIOD_MS 250			// Check of the clients and reload
+#define WATCHDOG_IDLE_MS 1000			// Longest wait of a supervised task with nothing to do
+
+typedef enum
+{
+	WATCHDOG_AUDIO = 0U,
+	WATCHDOG_METER,
+	WATCHDOG_SHELL,
+	WATCHDOG_CODEC,
+	WATCHDOG_COUNT
+} watchdog_client_t;
+
+typedef enum
+{
+	WATCHDOG_RESET_UNKNOWN = 0U,		// No flag set
+	WATCHDOG_RESET_IWDG,
+	WATCHDOG_RESET_WWDG,
+	WATCHDOG_RESET_LOW_POWER,			// Illegal Stop/Standby entry
+	WATCHDOG_RESET_FIREWALL,
+	WATCHDOG_RESET_OPTION_BYTES,
+	WATCHDOG_RESET_SOFTWARE,			// NVIC_SystemReset()
+	WATCHDOG_RESET_POWER_ON,			// Power on or brown out, the record restarts
+	WATCHDOG_RESET_PIN,					// NRST only
+	WATCHDOG_RESET_COUNT
+} watchdog_reset_t;
+
+typedef struct {
+	uint32_t csr;						// RCC_CSR at boot, reset flags
+	uint8_t cause;						// watchdog_reset_t
+	uint8_t client;						// Late client if cause is IWDG, WATCHDOG_COUNT otherwise
+	uint32_t late_ms;					// Its time without check in
+	uint32_t uptime_ms;					// When the reloads were stopped
+	uint32_t boots;						// Since the record is valid
+	uint32_t watchdog_resets;
+} watchdog_report_t;
+
+typedef struct {
+	uint32_t deadline_ms;
+	uint8_t armed;
+	uint32_t age_ms;					// Since the last check in
+	uint32_t worst_ms;					// Largest age seen by the supervisor
+} watchdog_client_info_t;
+
+void watchdog_init(void);
+void watchdog_start(void);
+void watchdog_checkin(watchdog_client_t client);
+void watchdog_pause(watchdog_client_t client);
+void watchdog_tick_from_isr(void);
+void watchdog_get_report(watchdog_report_t * report);
+void watchdog_get_client(watchdog_client_t client, watchdog_client_info_t * info);
+const char * watchdog_client_name(watchdog_client_t client);
+const char * watchdog_reset_name(watchdog_reset_t cause);
+
+#endif /* UTILS_WATCHDOG_H_ */
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+build_report.py
+
+Size/speed comparison between the Debug (-O0) and Release (-O2, LTO) builds.
+
+Usage: python3 tools/build_report.py [--configs Debug Release]
+                                     [--bench Debug=debug.log Release=release.log]
+
+Sizes come from the TP_Autoradio.map of each configuration (text, rodata,
+data, bss, RAM2 sections). Speeds come from captured shell logs of the 'b'
+benchmark command (cycles per block), when given.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SECTIONS = ('.isr_vector', '.text', '.rodata', '.data', '.bss',
+            '.fast_code', '.ram2_data', '.ram2_bss')
+
+SECTION_RE = re.compile(r'^(\.[\w.]+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+BENCH_RE = re.compile(r'^(\S+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s*$')
+
+
+def map_sizes(path):
+    sizes = dict.fromkeys(SECTIONS, 0)
+    in_map = False
+
+    with open(path, errors='replace') as f:
+        for line in f:
+            if line.startswith('Linker script and memory map'):
+                in_map = True
+                continue
+            if not in_map:
+                continue
+            m = SECTION_RE.match(line)
+            if m and m.group(1) in sizes:
+                sizes[m.group(1)] = int(m.group(3), 16)
+
+    flash = sum(sizes[s] for s in ('.isr_vector', '.text', '.rodata', '.data', '.fast_code', '.ram2_data'))
+    ram = sizes['.data'] + sizes['.bss']
+    ram2 = sizes['.fast_code'] + sizes['.ram2_data'] + sizes['.ram2_bss']
+    return sizes, flash, ram, ram2
+
+
+def bench_results(path):
+    """Placement -> average cycles, from the output of the 'b' shell command."""
+    results = {}
+    with open(path, errors='replace') as f:
+        for line in f:
+            m = BENCH_RE.match(line.strip())
+            if m:
+                results[m.group(1)] = int(m.group(3))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Debug/Release size and speed comparison')
+    parser.add_argument('--configs', nargs='+', default=['Debug', 'Release'])
+    parser.add_argument('--bench', nargs='*', default=[], metavar='CONFIG=LOG')
+    args = parser.parse_args()
+
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+    reports = {}
+    for config in args.configs:
+        path = os.path.join(root, config, 'TP_Autoradio.map')
+        if not os.path.exists(path):
+            print('%s: %s not found, build the configuration first' % (config, path), file=sys.stderr)
+            continue
+        reports[config] = map_sizes(path)
+
+    if not reports:
+        sys.exit(1)
+
+    configs = list(reports)
+    print('== Size (bytes) ==')
+    print('%-12s' % '' + ''.join('%12s' % c for c in configs))
+    for section in SECTIONS:
+        print('%-12s' % section + ''.join('%12d' % reports[c][0][section] for c in configs))
+    for i, name in ((1, 'FLASH'), (2, 'RAM'), (3, 'RAM2')):
+        print('%-12s' % name + ''.join('%12d' % reports[c][i] for c in configs))
+
+    benches = {}
+    for item in args.bench:
+        config, _, log = item.partition('=')
+        benches[config] = bench_results(log)
+
+    if benches:
+        print('\n== Speed (cycles per block, average) ==')
+        names = sorted({n for r in benches.values() for n in r})
+        print('%-12s' % '' + ''.join('%12s' % c for c in benches))
+        for name in names:
+            print('%-12s' % name + ''.join('%12s' % benches[c].get(name, '-') for c in benches))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+gen_tables.py
+
+Generates the constant DSP tables stored in flash (Core/audio/tables.c).
+
+Usage: python3 tools/gen_tables.py
+
+The tables are committed, run this script again after changing a size below.
+"""
+
+import math
+import os
+
+SINE_SIZE = 1024	# Full period, a power of two (phase accumulator index)
+LOG2_SIZE = 32		# Segments over one octave, a power of two
+SRC_PHASES = 64		# Polyphase resampler, a power of two (plus one row for the interpolation)
+
+# Resampler presets: taps, cutoff (fraction of the input rate), Kaiser beta
+SRC_PRESETS = [
+    (8, 0.36, 4.0),
+    (16, 0.42, 6.0),
+    (32, 0.45, 8.5),
+]
+
+HEADER = '''/*
+ * tables.c
+ *
+ *  Generated by tools/gen_tables.py, do not edit.
+ */
+
+#include "tables.h"
+'''
+
+
+def q15(x):
+    return max(-32768, min(32767, int(round(x * 32768.0))))
+
+
+def c_array(decl, values, per_line=12, width=6):
+    lines = [decl + ' = {']
+    for i in range(0, len(values), per_line):
+        lines.append('\t\t' + ', '.join('%*d' % (width, v) for v in values[i:i + per_line]) + ',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def bessel_i0(x):
+    total, term, k = 1.0, 1.0, 1
+    while term > 1e-12 * total:
+        term *= (x / (2 * k)) ** 2
+        total += term
+        k += 1
+    return total
+
+
+def src_coefs(taps, cutoff, beta):
+    """Windowed sinc, row p gives the output p/SRC_PHASES of a sample after
+    tap taps/2 - 1 (taps ordered from the oldest input), each row sums to 1."""
+    rows = []
+    half = taps / 2
+    for p in range(SRC_PHASES + 1):
+        frac = p / SRC_PHASES
+        row = []
+        for t in range(taps):
+            d = t - (half - 1) - frac
+            x = 2 * cutoff * d
+            sinc = 1.0 if d == 0 else math.sin(math.pi * x) / (math.pi * x)
+            r = d / half
+            w = bessel_i0(beta * math.sqrt(max(0.0, 1 - r * r))) / bessel_i0(beta)
+            row.append(2 * cutoff * sinc * w)
+        total = sum(row)
+        rows += [q15(v / total) for v in row]
+    return rows
+
+
+def main():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+    # One extra point so that the linear interpolation never wraps
+    sine = [q15(math.sin(2 * math.pi * i / SINE_SIZE)) for i in range(SINE_SIZE + 1)]
+
+    # log2(1 + i/SIZE) in Q16 and 2^(i/SIZE) in Q30, one octave plus the end point
+    log2 = [int(round(math.log2(1 + i / LOG2_SIZE) * 65536)) for i in range(LOG2_SIZE + 1)]
+    exp2 = [int(round(2 ** (i / LOG2_SIZE) * (1 << 30))) for i in range(LOG2_SIZE + 1)]
+
+    with open(os.path.join(root, 'Core', 'audio', 'tables.c'), 'w') as f:
+        f.write(HEADER)
+        f.write('\n')
+        f.write(c_array('const int16_t sine_q15[SINE_TABLE_SIZE + 1]', sine))
+        f.write('\n\n')
+        f.write(c_array('const uint32_t log2_q16[LOG2_TABLE_SIZE + 1]', log2, 8, 10))
+        f.write('\n\n')
+        f.write(c_array('const uint32_t exp2_q30[LOG2_TABLE_SIZE + 1]', exp2, 8, 10))
+        f.write('\n')
+        for taps, cutoff, beta in SRC_PRESETS:
+            f.write('\n')
+            f.write(c_array('const int16_t src_coefs_%d[(SRC_PHASES + 1) * %d]' % (taps, taps),
+                            src_coefs(taps, cutoff, beta), taps))
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
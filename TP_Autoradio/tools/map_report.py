@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+map_report.py
+
+Post-link RAM usage report, parsed from the GNU ld map file.
+
+Usage: python3 tools/map_report.py [Debug/TP_Autoradio.map] [-n TOP]
+
+Prints the usage of each RAM region (RAM, RAM2), the RAM used by each object
+file and the biggest objects (buffers, stacks, FreeRTOS heap, ...).
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+RAM_SECTIONS = ('.data', '.bss', '.ram2_data', '.ram2_bss', '.noinit', '._user_heap_stack')
+
+REGION_RE = re.compile(r'^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+OUTPUT_RE = re.compile(r'^(\.[\w.]+)(\s|$)')
+INPUT_RE = re.compile(r'^ (\.[\w.$]+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$')
+INPUT_NAME_RE = re.compile(r'^ (\.[\w.$]+|COMMON)$')
+INPUT_CONT_RE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$')
+
+
+def short_object(path):
+    """Keeps the object name (or archive(member)) of a path."""
+    path = path.strip()
+    m = re.search(r'([^/]+\.a\([^)]+\))$', path)
+    if m:
+        return m.group(1)
+    return path.split('/')[-1]
+
+
+def object_name(section):
+    """'.bss.rxSAI' -> 'rxSAI'."""
+    for prefix in RAM_SECTIONS:
+        if section.startswith(prefix + '.'):
+            return section[len(prefix) + 1:]
+    return section
+
+
+def parse(path):
+    regions = {}
+    objects = []	# (output section, name, address, size, object file)
+    out_section = None
+    pending = None
+
+    with open(path, errors='replace') as f:
+        lines = f.read().splitlines()
+
+    # Memory Configuration
+    i = 0
+    while i < len(lines) and not lines[i].startswith('Memory Configuration'):
+        i += 1
+    for line in lines[i + 1:]:
+        if line.startswith('Linker script and memory map'):
+            break
+        m = REGION_RE.match(line)
+        if m and m.group(1) not in ('Name', '*default*'):
+            regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+
+    # Linker script and memory map
+    while i < len(lines) and not lines[i].startswith('Linker script and memory map'):
+        i += 1
+    for line in lines[i:]:
+        m = OUTPUT_RE.match(line)
+        if m:
+            out_section = m.group(1)
+            pending = None
+            continue
+        if out_section not in RAM_SECTIONS:
+            continue
+
+        m = INPUT_RE.match(line)
+        if m:
+            addr, size = int(m.group(2), 16), int(m.group(3), 16)
+            if size and region_of(addr, regions).startswith('RAM'):
+                objects.append((out_section, object_name(m.group(1)), addr, size, short_object(m.group(4))))
+            pending = None
+            continue
+
+        # Long section names are wrapped on two lines
+        m = INPUT_NAME_RE.match(line)
+        if m:
+            pending = m.group(1)
+            continue
+        m = INPUT_CONT_RE.match(line)
+        if m and pending:
+            addr, size = int(m.group(1), 16), int(m.group(2), 16)
+            if size and region_of(addr, regions).startswith('RAM'):
+                objects.append((out_section, object_name(pending), addr, size, short_object(m.group(3))))
+            pending = None
+
+    return regions, objects
+
+
+def region_of(addr, regions):
+    for name, (origin, length) in regions.items():
+        if origin <= addr < origin + length:
+            return name
+    return '?'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='RAM usage report from a GNU ld map file')
+    parser.add_argument('map', nargs='?', default='Debug/TP_Autoradio.map')
+    parser.add_argument('-n', '--top', type=int, default=20, help='number of objects listed')
+    args = parser.parse_args()
+
+    try:
+        regions, objects = parse(args.map)
+    except OSError as e:
+        sys.exit('map_report: %s' % e)
+
+    ram_regions = {k: v for k, v in regions.items() if k.startswith('RAM')}
+
+    print('== Regions ==')
+    used = defaultdict(int)
+    for section, name, addr, size, obj in objects:
+        used[region_of(addr, ram_regions)] += size
+    for name, (origin, length) in sorted(ram_regions.items()):
+        print('%-6s %7d / %7d bytes (%5.1f %%)' % (name, used[name], length, 100.0 * used[name] / length))
+
+    print('\n== Per object file ==')
+    per_file = defaultdict(int)
+    for section, name, addr, size, obj in objects:
+        per_file[obj] += size
+    for obj, size in sorted(per_file.items(), key=lambda x: -x[1]):
+        print('%7d  %s' % (size, obj))
+
+    print('\n== Biggest objects ==')
+    for section, name, addr, size, obj in sorted(objects, key=lambda x: -x[3])[:args.top]:
+        print('%7d  %-5s %-18s %-32s %s' % (size, region_of(addr, ram_regions), section, name, obj))
+
+
+if __name__ == '__main__':
+    main()